@@ -0,0 +1,383 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	ai.c
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Monster turns, decided in parallel and committed in a fixed
+///			order
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ai.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <glib.h>
+
+#include "common.h"
+#include "dijkstra.h"
+#include "log.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+// Moves a monster ranks, tried in turn if the better ones are taken
+#define RLAI_CHOICES 3
+
+// Monsters decided per job
+#define RLAI_GRAIN 32
+
+// An idle monster takes a step one turn in this many
+#define RLAI_WANDER 4
+
+// Scale of the safety map, above one monsters prefer open ground to the
+// nearest corner
+#define RLAI_FLEE_NUM 12
+#define RLAI_FLEE_DEN 10
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+typedef enum {
+	RLAI_WAIT,
+	RLAI_MOVE,
+	RLAI_ATTACK
+} RLAIAction;
+
+///////////////////////////////////////////////////////////////////////////////
+/// A monster's decision, and the state it takes on once committed
+///////////////////////////////////////////////////////////////////////////////
+typedef struct {
+	RLAIAction action;
+	int num_moves;
+	struct {
+		int x;
+		int y;
+	} moves[RLAI_CHOICES];
+	RLAIState state;
+	int memory;
+	uint32_t seed;
+} RLAIIntent;
+
+struct _RLAI {
+	const RLMapGrid *map;
+	RLJobSystem *jobs;
+	int width;
+	RLFlowField *chase;
+	RLFlowField *flee;
+	// Monster id plus one of every cell, 0 where empty
+	int *occupants;
+	RLAIActor *actors;
+	RLAIIntent *intents;
+	int num_actors;
+	int max_actors;
+	// What the decisions of the current turn read
+	const RLFov *fov;
+	bool fleeing;
+	struct {
+		int x;
+		int y;
+	} player;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static variables
+///////////////////////////////////////////////////////////////////////////////
+
+static const int directions[8][2] = {
+	{1, 0}, {-1, 0}, {0, 1}, {0, -1},
+	{1, 1}, {-1, 1}, {1, -1}, {-1, -1}
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+static uint32_t RLAI_Random(uint32_t *seed)
+{
+	*seed ^= *seed << 13;
+	*seed ^= *seed >> 17;
+	*seed ^= *seed << 5;
+
+	return *seed;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static bool RLAI_CanStep(const RLMapGrid *map, int x, int y, int dx, int dy)
+{
+	// Diagonal steps do not cut corners, as in the pathfinder
+	return RLMapGrid_GetBit(map, RLMAP_WALKABLE, x + dx, y + dy) &&
+		(!dx || !dy || (RLMapGrid_GetBit(map, RLMAP_WALKABLE, x + dx, y) &&
+		RLMapGrid_GetBit(map, RLMAP_WALKABLE, x, y + dy)));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static bool RLAI_Downhill(const RLAI *this, const RLFlowField *field,
+	const RLAIActor *actor, RLAIIntent *intent)
+{
+	const int here = RLFlowField_GetDistance(field, actor->x, actor->y);
+	int distances[RLAI_CHOICES];
+
+	// The lowest neighbours below the monster's cell, ties in direction
+	// order
+	intent->num_moves = 0;
+	for (int i = 0; i < 8; ++i) {
+		const int x = actor->x + directions[i][0];
+		const int y = actor->y + directions[i][1];
+		int d, j;
+
+		if (!RLAI_CanStep(this->map, actor->x, actor->y, directions[i][0],
+			directions[i][1])) {
+			continue;
+		}
+		d = RLFlowField_GetDistance(field, x, y);
+		if (d >= here || (intent->num_moves == RLAI_CHOICES &&
+			d >= distances[RLAI_CHOICES - 1])) {
+			continue;
+		}
+
+		j = intent->num_moves < RLAI_CHOICES ? intent->num_moves++ :
+			RLAI_CHOICES - 1;
+		for (; j > 0 && distances[j - 1] > d; --j) {
+			distances[j] = distances[j - 1];
+			intent->moves[j] = intent->moves[j - 1];
+		}
+		distances[j] = d;
+		intent->moves[j].x = x;
+		intent->moves[j].y = y;
+	}
+
+	return intent->num_moves > 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLAI_Decide(void *data, int begin, int end)
+{
+	const RLAI *this = data;
+
+	// Reads only the turn's snapshot and the monster, writes only its intent
+	for (int i = begin; i < end; ++i) {
+		const RLAIActor *actor = &this->actors[i];
+		RLAIIntent *intent = &this->intents[i];
+		const int dx = this->player.x - actor->x;
+		const int dy = this->player.y - actor->y;
+		const bool sees = this->fov &&
+			RLFov_IsVisible(this->fov, actor->x, actor->y);
+
+		intent->action = RLAI_WAIT;
+		intent->num_moves = 0;
+		intent->seed = actor->seed;
+		intent->memory = sees ? RLAI_MEMORY : MAX(actor->memory - 1, 0);
+		if (!intent->memory) {
+			intent->state = RLAI_IDLE;
+		}
+		else if (actor->hp * 3 < actor->max_hp) {
+			intent->state = RLAI_FLEE;
+		}
+		else {
+			intent->state = RLAI_HUNT;
+		}
+
+		switch (intent->state) {
+		case RLAI_HUNT:
+			if (abs(dx) <= 1 && abs(dy) <= 1 &&
+				RLAI_CanStep(this->map, actor->x, actor->y, dx, dy)) {
+				intent->action = RLAI_ATTACK;
+			}
+			else if (RLAI_Downhill(this, this->chase, actor, intent)) {
+				intent->action = RLAI_MOVE;
+			}
+			break;
+		case RLAI_FLEE:
+			if (this->fleeing &&
+				RLAI_Downhill(this, this->flee, actor, intent)) {
+				intent->action = RLAI_MOVE;
+			}
+			break;
+		case RLAI_IDLE:
+			if (!(RLAI_Random(&intent->seed) % RLAI_WANDER)) {
+				const int *d = directions[RLAI_Random(&intent->seed) % 8];
+
+				if (RLAI_CanStep(this->map, actor->x, actor->y, d[0], d[1])) {
+					intent->moves[0].x = actor->x + d[0];
+					intent->moves[0].y = actor->y + d[1];
+					intent->num_moves = 1;
+					intent->action = RLAI_MOVE;
+				}
+			}
+			break;
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Public functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+RLAI * RLAI_Create(const RLMapGrid *map, RLJobSystem *jobs)
+{
+	RLAI *this = NULL;
+
+	if (!map || !jobs) {
+		log_warn("NULL argument");
+		return NULL;
+	}
+
+	this = g_new0(RLAI, 1);
+	this->map = map;
+	this->jobs = jobs;
+	this->width = map->size.width;
+	this->chase = RLFlowField_Create(map);
+	this->flee = RLFlowField_Create(map);
+	this->occupants = g_new0(
+		int,
+		(gsize)map->size.width * (gsize)map->size.height
+		);
+
+	return this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int RLAI_Spawn(RLAI *this, int x, int y, int hp)
+{
+	const int id = this ? this->num_actors : -1;
+
+	if (!this) {
+		log_warn("NULL argument");
+		return -1;
+	}
+	if (!RLMapGrid_GetBit(this->map, RLMAP_WALKABLE, x, y) ||
+		this->occupants[y * this->width + x]) {
+		return -1;
+	}
+
+	if (this->num_actors == this->max_actors) {
+		this->max_actors = MAX(64, this->max_actors * 2);
+		this->actors = g_renew(RLAIActor, this->actors,
+			(gsize)this->max_actors);
+		this->intents = g_renew(RLAIIntent, this->intents,
+			(gsize)this->max_actors);
+	}
+
+	// Seeded by id, so a replay spawning the same monsters plays the same
+	this->actors[id] = (RLAIActor){
+		x,
+		y,
+		hp,
+		hp,
+		RLAI_IDLE,
+		0,
+		((uint32_t)id + 1) * 2654435761u | 1
+	};
+	this->occupants[y * this->width + x] = id + 1;
+	++this->num_actors;
+
+	return id;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int RLAI_GetNumActors(const RLAI *this)
+{
+	if (!this) {
+		log_warn("NULL argument");
+		return 0;
+	}
+
+	return this->num_actors;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+RLAIActor * RLAI_GetActor(RLAI *this, int id)
+{
+	if (!this) {
+		log_warn("NULL argument");
+		return NULL;
+	}
+	if (id < 0 || id >= this->num_actors) {
+		return NULL;
+	}
+
+	return &this->actors[id];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int RLAI_Turn(RLAI *this, const RLFov *fov, int player_x, int player_y)
+{
+	int attacks = 0;
+
+	if (!this) {
+		log_warn("NULL argument");
+		return 0;
+	}
+
+	// The snapshot, fixed for the whole decide phase
+	this->fov = fov;
+	this->player.x = player_x;
+	this->player.y = player_y;
+	RLFlowField_AddSource(this->chase, player_x, player_y, 0);
+	RLFlowField_Compute(this->chase);
+	this->fleeing = false;
+	for (int i = 0; i < this->num_actors && !this->fleeing; ++i) {
+		this->fleeing = this->actors[i].hp * 3 < this->actors[i].max_hp;
+	}
+	if (this->fleeing) {
+		RLFlowField_ComputeFlee(this->flee, this->chase, RLAI_FLEE_NUM,
+			RLAI_FLEE_DEN);
+	}
+
+	RLJobSystem_ParallelFor(
+		this->jobs,
+		0,
+		this->num_actors,
+		RLAI_GRAIN,
+		RLAI_Decide,
+		this
+		);
+
+	// Commit in id order, earlier monsters win contested cells
+	for (int i = 0; i < this->num_actors; ++i) {
+		RLAIActor *actor = &this->actors[i];
+		const RLAIIntent *intent = &this->intents[i];
+
+		actor->state = intent->state;
+		actor->memory = intent->memory;
+		actor->seed = intent->seed;
+		if (intent->action == RLAI_ATTACK) {
+			++attacks;
+			continue;
+		}
+
+		for (int j = 0; j < intent->num_moves; ++j) {
+			const int x = intent->moves[j].x, y = intent->moves[j].y;
+
+			if (this->occupants[y * this->width + x] ||
+				(x == player_x && y == player_y)) {
+				continue;
+			}
+			this->occupants[actor->y * this->width + actor->x] = 0;
+			this->occupants[y * this->width + x] = i + 1;
+			actor->x = x;
+			actor->y = y;
+			break;
+		}
+	}
+
+	return attacks;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLAI_Destroy(RLAI *this)
+{
+	if (CONDBIND(this, log_warn, "NULL argument")) {
+		RLFlowField_Destroy(this->chase);
+		RLFlowField_Destroy(this->flee);
+		g_free(this->occupants);
+		g_free(this->actors);
+		g_free(this->intents);
+		g_free(this);
+	}
+}
@@ -0,0 +1,133 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	ai.h
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Monster turns, decided in parallel and committed in a fixed
+///			order
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef AI_H
+#define AI_H
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+
+#include "fov.h"
+#include "jobs.h"
+#include "mapgrid.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+// Turns a monster keeps hunting after it last saw the player
+#define RLAI_MEMORY 20
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	What a monster is doing
+///
+/// RLAI_IDLE:	Wandering, it has not seen the player lately
+/// RLAI_HUNT:	Closing in on the player and attacking when next to it
+/// RLAI_FLEE:	Running from the player, below a third of its health
+///////////////////////////////////////////////////////////////////////////////
+typedef enum {
+	RLAI_IDLE,
+	RLAI_HUNT,
+	RLAI_FLEE
+} RLAIState;
+
+typedef struct {
+	int x;
+	int y;
+	int hp;
+	int max_hp;
+	RLAIState state;
+	// Turns of hunting left without seeing the player
+	int memory;
+	// State of the monster's own random generator
+	uint32_t seed;
+} RLAIActor;
+
+typedef struct _RLAI RLAI;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns a pointer to a new RLAI with no monsters
+///
+/// The map and the job system must outlive the RLAI, the map's size must
+/// not change.
+///
+/// \param	map		Map the monsters walk on
+/// \param	jobs	Job system the decisions run on
+///
+/// \return	Pointer to the new RLAI
+///////////////////////////////////////////////////////////////////////////////
+RLAI * RLAI_Create(const RLMapGrid *map, RLJobSystem *jobs);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Adds a monster
+///
+/// \param	this	An RLAI
+/// \param	x		Column of the monster
+/// \param	y		Row of the monster
+/// \param	hp		Current and maximum health of the monster
+///
+/// \return	Id of the monster, -1 if the cell is not walkable or taken
+///////////////////////////////////////////////////////////////////////////////
+int RLAI_Spawn(RLAI *this, int x, int y, int hp);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns the number of monsters, ids run from 0 to one less
+///
+/// \param	this	An RLAI
+///
+/// \return	Number of monsters
+///////////////////////////////////////////////////////////////////////////////
+int RLAI_GetNumActors(const RLAI *this);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns a monster
+///
+/// \param	this	An RLAI
+/// \param	id		Id of the monster
+///
+/// \return	Pointer to the monster, valid until the next spawn, NULL if the
+///			id is out of range
+///////////////////////////////////////////////////////////////////////////////
+RLAIActor * RLAI_GetActor(RLAI *this, int id);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Plays one turn of every monster
+///
+/// Distances to and away from the player are computed once for all. Each
+/// monster then decides in parallel on a snapshot of the map, the player's
+/// view and its own state, writing only its own choice. The choices are
+/// applied one monster at a time in id order, a move into a cell already
+/// taken falling back to the monster's next choice, or to waiting. The
+/// outcome is the same for any number of threads.
+///
+/// The player's view doubles as the monsters' sight of the player, which
+/// holds for a symmetric field of view.
+///
+/// \param	this		An RLAI
+/// \param	fov			Field of view of the player, may be NULL
+/// \param	player_x	Column of the player
+/// \param	player_y	Row of the player
+///
+/// \return	Number of monsters that attacked the player
+///////////////////////////////////////////////////////////////////////////////
+int RLAI_Turn(RLAI *this, const RLFov *fov, int player_x, int player_y);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Frees the memory associated with an RLAI
+///
+/// \param	this	An RLAI
+///////////////////////////////////////////////////////////////////////////////
+void RLAI_Destroy(RLAI *this);
+
+#endif
@@ -0,0 +1,298 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	atlas.c
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Glyph atlas texture decoded on a worker thread and uploaded
+///			through a pixel buffer object
+///////////////////////////////////////////////////////////////////////////////
+
+#include "atlas.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+#include <glib.h>
+
+#include "stb_image.h"
+#include "common.h"
+#include "log.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+struct _Atlas {
+	char *filename;
+	GThread *thread;
+	unsigned char *pixels;
+	const char *error;
+	int width;
+	int height;
+	int source_channels;
+	int channels;
+	GLint swizzle[4];
+	GLuint texture;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static variables
+///////////////////////////////////////////////////////////////////////////////
+
+// Internal format and pixel format by number of stored channels
+static const GLint formats[4][2] = {
+	{GL_R8, GL_RED},
+	{GL_RG8, GL_RG},
+	{GL_RGB8, GL_RGB},
+	{GL_RGBA8, GL_RGBA}
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+static void Atlas_SetSwizzle(Atlas *this, GLint r, GLint g, GLint b, GLint a)
+{
+	this->swizzle[0] = r;
+	this->swizzle[1] = g;
+	this->swizzle[2] = b;
+	this->swizzle[3] = a;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Atlas_Reduce(Atlas *this)
+{
+	const size_t count = (size_t)this->width * (size_t)this->height;
+	const int n = this->channels;
+	unsigned char *p = this->pixels;
+	bool grey = true, opaque = true, white = true, premultiplied = true;
+
+	// Fully transparent texels are always discarded by the tile shader, so
+	// their color does not need to survive
+	for (size_t i = 0; i < count; ++i, p += n) {
+		const int r = p[0], a = p[n - 1];
+		opaque &= a == 255;
+		premultiplied &= r == a;
+		if (a) {
+			grey &= n < 4 || (p[1] == r && p[2] == r);
+			white &= r == 255;
+		}
+	}
+
+	if (n == 1 || (grey && opaque)) {
+		// Luminance, kept in the first channel
+		for (size_t i = 0; i < count; ++i) {
+			this->pixels[i] = this->pixels[i * (size_t)n];
+		}
+		this->channels = 1;
+		Atlas_SetSwizzle(this, GL_RED, GL_RED, GL_RED, GL_ONE);
+	}
+	else if (grey && (white || premultiplied)) {
+		// Coverage, kept in the last channel
+		for (size_t i = 0; i < count; ++i) {
+			this->pixels[i] = this->pixels[i * (size_t)n + (size_t)n - 1];
+		}
+		this->channels = 1;
+		if (white) {
+			Atlas_SetSwizzle(this, GL_ONE, GL_ONE, GL_ONE, GL_RED);
+		}
+		else {
+			Atlas_SetSwizzle(this, GL_RED, GL_RED, GL_RED, GL_RED);
+		}
+	}
+	else if (grey) {
+		// Luminance and coverage
+		for (size_t i = 0; i < count; ++i) {
+			this->pixels[i * 2] = this->pixels[i * (size_t)n];
+			this->pixels[i * 2 + 1] = this->pixels[i * (size_t)n +
+				(size_t)n - 1];
+		}
+		this->channels = 2;
+		Atlas_SetSwizzle(this, GL_RED, GL_RED, GL_RED, GL_GREEN);
+	}
+	else {
+		Atlas_SetSwizzle(this, GL_RED, GL_GREEN, GL_BLUE, GL_ALPHA);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static gpointer Atlas_Decode(gpointer data)
+{
+	Atlas *this = data;
+
+	// Grey sources are decoded without expanding them to RGBA
+	if (!stbi_info(this->filename, &this->width, &this->height,
+		&this->source_channels)) {
+		this->error = stbi_failure_reason();
+		return NULL;
+	}
+	this->channels = this->source_channels == 3 ? 4 : this->source_channels;
+
+	// Rows stay top-down to match BMFont coordinates
+	if (!(this->pixels = stbi_load(
+		this->filename,
+		&this->width,
+		&this->height,
+		NULL,
+		this->channels))) {
+		this->error = stbi_failure_reason();
+		return NULL;
+	}
+
+	Atlas_Reduce(this);
+	return NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Atlas_Join(Atlas *this)
+{
+	if (this->thread) {
+		g_thread_join(this->thread);
+		this->thread = NULL;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static bool Atlas_UsesMipmaps(GLint min_filter)
+{
+	return min_filter == GL_NEAREST_MIPMAP_NEAREST ||
+		min_filter == GL_NEAREST_MIPMAP_LINEAR ||
+		min_filter == GL_LINEAR_MIPMAP_NEAREST ||
+		min_filter == GL_LINEAR_MIPMAP_LINEAR;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Public functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+Atlas * Atlas_Load(const char *filename)
+{
+	Atlas *this = NULL;
+
+	if (!filename) {
+		log_warn("NULL argument");
+		return NULL;
+	}
+
+	this = g_new0(Atlas, 1);
+	this->filename = g_strdup(filename);
+	this->thread = g_thread_new("atlas decode", Atlas_Decode, this);
+
+	return this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool Atlas_Upload(Atlas *this, GLint min_filter, GLint mag_filter)
+{
+	GLuint pbo;
+	GLsizeiptr size;
+	void *staging = NULL;
+
+	if (!this) {
+		log_warn("NULL argument");
+		return false;
+	}
+
+	Atlas_Join(this);
+	if (!this->pixels) {
+		logfmt_warn(
+			"Atlas %s could not be decoded: %s",
+			this->filename,
+			this->error
+			);
+		return false;
+	}
+
+	size = (GLsizeiptr)this->width * this->height * this->channels;
+	logfmt_info(
+		"Atlas %s: %dx%d, %d to %d bytes per texel, %ld bytes uploaded",
+		this->filename,
+		this->width,
+		this->height,
+		this->source_channels == 3 ? 4 : this->source_channels,
+		this->channels,
+		(long)size
+		);
+
+	// Staging through a PBO lets the driver copy to the texture with DMA
+	// after glTexImage2D returns, instead of from client memory inside it
+	glGenBuffers(1, &pbo);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+	glBufferData(GL_PIXEL_UNPACK_BUFFER, size, NULL, GL_STREAM_DRAW);
+	if ((staging = glMapBufferRange(
+		GL_PIXEL_UNPACK_BUFFER,
+		0,
+		size,
+		GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT))) {
+		memcpy(staging, this->pixels, (size_t)size);
+		glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+	}
+	else {
+		log_warn("Atlas staging buffer mapping failed, uploading directly");
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	}
+
+	glGenTextures(1, &this->texture);
+	glBindTexture(GL_TEXTURE_2D, this->texture);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, min_filter);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, mag_filter);
+	glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, this->swizzle);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexImage2D(
+		GL_TEXTURE_2D,
+		0,
+		formats[this->channels - 1][0],
+		this->width,
+		this->height,
+		0,
+		(GLenum)formats[this->channels - 1][1],
+		GL_UNSIGNED_BYTE,
+		staging ? NULL : this->pixels
+		);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+	// Nearest filtered atlases never sample below level 0
+	if (Atlas_UsesMipmaps(min_filter)) {
+		glGenerateMipmap(GL_TEXTURE_2D);
+	}
+	else {
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+	}
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	glDeleteBuffers(1, &pbo);
+	stbi_image_free(this->pixels);
+	this->pixels = NULL;
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+GLuint Atlas_GetTexture(Atlas *this)
+{
+	if (!this) {
+		log_warn("NULL argument");
+		return 0;
+	}
+	else {
+		return this->texture;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Atlas_Destroy(Atlas *this)
+{
+	if (CONDBIND(this, log_warn, "NULL argument")) {
+		Atlas_Join(this);
+		if (this->texture) {
+			glDeleteTextures(1, &this->texture);
+		}
+		stbi_image_free(this->pixels);
+		g_free(this->filename);
+		g_free(this);
+	}
+}
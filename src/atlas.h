@@ -0,0 +1,68 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	atlas.h
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Glyph atlas texture decoded on a worker thread and uploaded
+///			through a pixel buffer object
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef ATLAS_H
+#define ATLAS_H
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdbool.h>
+
+#include "glad.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+typedef struct _Atlas Atlas;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns a pointer to a new Atlas and starts decoding its image
+///
+/// Needs no OpenGL context, so it can be called first thing at startup to
+/// overlap the decode with window and context creation. Greyscale and
+/// single color images are reduced to one or two channels, with a texture
+/// swizzle restoring the RGBA values the tile shader samples.
+///
+/// \param	filename	Path to the atlas image
+///
+/// \return	Pointer to the new Atlas
+///////////////////////////////////////////////////////////////////////////////
+Atlas * Atlas_Load(const char *filename);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Waits for the decode and creates the texture
+///
+/// Mipmaps are only generated when min_filter samples them.
+///
+/// \param	this		An Atlas
+/// \param	min_filter	Minification filter, i.e. GL_NEAREST
+/// \param	mag_filter	Magnification filter, i.e. GL_NEAREST
+///
+/// \return	true if the image decoded and the texture was created
+///////////////////////////////////////////////////////////////////////////////
+bool Atlas_Upload(Atlas *this, GLint min_filter, GLint mag_filter);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns the texture created by Atlas_Upload
+///
+/// \param	this	An Atlas
+///
+/// \return	Texture name, or 0 before a successful upload
+///////////////////////////////////////////////////////////////////////////////
+GLuint Atlas_GetTexture(Atlas *this);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Frees the memory and texture associated with an Atlas
+///
+/// \param	this	An Atlas
+///////////////////////////////////////////////////////////////////////////////
+void Atlas_Destroy(Atlas *this);
+
+#endif
@@ -25,6 +25,8 @@
 
 struct _BMFont {
 	GHashTable *bmfont_hash;
+	BMFontLookup lookup;
+	void *data;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -184,6 +186,23 @@ error_hash:
 	return NULL;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+BMFont * BMFont_CreateWith(BMFontLookup lookup, void *data)
+{
+	BMFont *this = NULL;
+
+	if (!lookup) {
+		log_warn("NULL argument");
+		return NULL;
+	}
+
+	this = g_new0(BMFont, 1);
+	this->lookup = lookup;
+	this->data = data;
+
+	return this;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 BMFontInfo const * BMFont_GetInfoPtr(BMFont *this, int glyph)
 {
@@ -191,6 +210,9 @@ BMFontInfo const * BMFont_GetInfoPtr(BMFont *this, int glyph)
 		log_warn("Null argument");
 		return NULL;
 	}
+	else if (this->lookup) {
+		return this->lookup(this->data, glyph);
+	}
 	else {
 		return g_hash_table_lookup(this->bmfont_hash, &glyph);
 	}
@@ -199,7 +221,7 @@ BMFontInfo const * BMFont_GetInfoPtr(BMFont *this, int glyph)
 ///////////////////////////////////////////////////////////////////////////////
 void BMFont_Destroy(BMFont *this)
 {
-	if (CONDBIND(this && this->bmfont_hash, log_warn, "NULL argument")) {
+	if (this && this->bmfont_hash) {
 		g_hash_table_destroy(this->bmfont_hash);
 	}
 	if (CONDBIND(this, log_warn, "NULL argument")) {
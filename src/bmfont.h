@@ -31,6 +31,16 @@ typedef struct {
 	} offset;
 } BMFontInfo;
 
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Supplies the metrics of a BMFont created with BMFont_CreateWith
+///
+/// \param	data	Pointer passed to BMFont_CreateWith
+/// \param	glyph	UTF-32 value of a glyph
+///
+/// \return	Pointer to the glyph's BMFontInfo, NULL if it has none
+///////////////////////////////////////////////////////////////////////////////
+typedef BMFontInfo const * (*BMFontLookup)(void *data, int glyph);
+
 ///////////////////////////////////////////////////////////////////////////////
 /// \brief	Returns a pointer to a new BMFont
 ///
@@ -40,6 +50,19 @@ typedef struct {
 ///////////////////////////////////////////////////////////////////////////////
 BMFont * BMFont_Create(const char *filename);
 
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns a pointer to a new BMFont whose metrics come from a
+///			callback instead of a file
+///
+/// Lets glyphs generated at run time be drawn by anything taking a BMFont.
+///
+/// \param	lookup	Called by BMFont_GetInfoPtr for every glyph
+/// \param	data	Passed to lookup
+///
+/// \return	pointer to the new BMFont
+///////////////////////////////////////////////////////////////////////////////
+BMFont * BMFont_CreateWith(BMFontLookup lookup, void *data);
+
 ///////////////////////////////////////////////////////////////////////////////
 /// \brief	Returns a pointer to the BMFontInfo struct for a given glyph
 ///
@@ -0,0 +1,148 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	camera.c
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	2D camera scrolling over tile maps in whole tiles plus a smooth
+///			sub-tile pixel offset
+///////////////////////////////////////////////////////////////////////////////
+
+#include "camera.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <math.h>
+#include <glib.h>
+
+#include "common.h"
+#include "log.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLCamera_Carry(int *position, float *offset, int tile)
+{
+	const float tiles = floorf(*offset / (float)tile);
+
+	*position += (int)tiles;
+	*offset -= tiles * (float)tile;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Public functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+void RLCamera_Init(RLCamera *this, int width, int height, int tile_width,
+	int tile_height)
+{
+	if (!this) {
+		log_warn("NULL argument");
+		return;
+	}
+	else if (tile_width <= 0 || tile_height <= 0) {
+		log_warn("Invalid tile size");
+		return;
+	}
+
+	*this = (RLCamera){
+		{0, 0},
+		{0.0f, 0.0f},
+		{width, height},
+		{tile_width, tile_height}
+	};
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLCamera_Resize(RLCamera *this, int width, int height)
+{
+	if (CONDBIND(this, log_warn, "NULL argument")) {
+		this->viewport.width = width;
+		this->viewport.height = height;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLCamera_Scroll(RLCamera *this, float dx, float dy)
+{
+	if (CONDBIND(this, log_warn, "NULL argument")) {
+		this->offset.x += dx;
+		this->offset.y += dy;
+		RLCamera_Carry(
+			&this->position.x,
+			&this->offset.x,
+			this->tile_size.width
+			);
+		RLCamera_Carry(
+			&this->position.y,
+			&this->offset.y,
+			this->tile_size.height
+			);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLCamera_Follow(RLCamera *this, int x, int y, float t)
+{
+	const int tw = this ? this->tile_size.width : 0;
+	const int th = this ? this->tile_size.height : 0;
+	float dx, dy;
+
+	if (!this) {
+		log_warn("NULL argument");
+		return;
+	}
+
+	// Distance in pixels between the viewport center and the tile center
+	dx = (float)((x - this->position.x) * tw + tw / 2 -
+		this->viewport.width / 2) - this->offset.x;
+	dy = (float)((y - this->position.y) * th + th / 2 -
+		this->viewport.height / 2) - this->offset.y;
+
+	RLCamera_Scroll(this, dx * t, dy * t);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLCamera_Lerp(RLCamera *this, const RLCamera *from, const RLCamera *to,
+	float t)
+{
+	float dx, dy;
+
+	if (!this || !from || !to) {
+		log_warn("NULL argument");
+		return;
+	}
+
+	// Work on the difference so far away cameras keep sub-pixel precision
+	dx = (float)((from->position.x - to->position.x) * to->tile_size.width) +
+		from->offset.x - to->offset.x;
+	dy = (float)((from->position.y - to->position.y) * to->tile_size.height) +
+		from->offset.y - to->offset.y;
+
+	*this = *to;
+	RLCamera_Scroll(this, dx * (1.0f - t), dy * (1.0f - t));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLCamera_GetTransform(const RLCamera *this, mat4x4 transform)
+{
+	if (!this) {
+		log_warn("NULL argument");
+		mat4x4_identity(transform);
+		return;
+	}
+
+	mat4x4_ortho(
+		transform,
+		0.0f,
+		(float)this->viewport.width,
+		(float)this->viewport.height,
+		0.0f,
+		-1.0f,
+		1.0f
+		);
+	mat4x4_translate_in_place(transform, -this->offset.x, -this->offset.y,
+		0.0f);
+}
@@ -0,0 +1,111 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	camera.h
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	2D camera scrolling over tile maps in whole tiles plus a smooth
+///			sub-tile pixel offset
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef CAMERA_H
+#define CAMERA_H
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include "linmath.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Camera over a tile grid
+///
+/// position is the tile at the top-left corner of the viewport and offset
+/// the pixels scrolled past it, always in [0, tile_size). Meshes are built
+/// relative to position so vertex coordinates stay bounded by the viewport
+/// no matter how large the map is.
+///////////////////////////////////////////////////////////////////////////////
+typedef struct {
+	struct {
+		int x;
+		int y;
+	} position;
+	struct {
+		float x;
+		float y;
+	} offset;
+	struct {
+		int width;
+		int height;
+	} viewport;
+	struct {
+		int width;
+		int height;
+	} tile_size;
+} RLCamera;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Initializes a camera looking at the top-left corner of the grid
+///
+/// \param	this		An RLCamera
+/// \param	width		Width of the viewport in pixels
+/// \param	height		Height of the viewport in pixels
+/// \param	tile_width	Width of a tile in pixels
+/// \param	tile_height	Height of a tile in pixels
+///////////////////////////////////////////////////////////////////////////////
+void RLCamera_Init(RLCamera *this, int width, int height, int tile_width,
+	int tile_height);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Changes the size of the viewport
+///
+/// \param	this	An RLCamera
+/// \param	width	Width of the viewport in pixels
+/// \param	height	Height of the viewport in pixels
+///////////////////////////////////////////////////////////////////////////////
+void RLCamera_Resize(RLCamera *this, int width, int height);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Scrolls the camera by a number of pixels
+///
+/// Whole tiles are carried into position, the rest stays in offset.
+///
+/// \param	this	An RLCamera
+/// \param	dx		Horizontal scroll in pixels
+/// \param	dy		Vertical scroll in pixels
+///////////////////////////////////////////////////////////////////////////////
+void RLCamera_Scroll(RLCamera *this, float dx, float dy);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Scrolls part of the way towards centering a tile
+///
+/// \param	this	An RLCamera
+/// \param	x		Column of the tile to follow
+/// \param	y		Row of the tile to follow
+/// \param	t		Fraction of the remaining distance to scroll, 1 snaps
+///////////////////////////////////////////////////////////////////////////////
+void RLCamera_Follow(RLCamera *this, int x, int y, float t);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Interpolates between two positions of the same camera
+///
+/// The viewport and tile size are taken from to.
+///
+/// \param	this	Destination RLCamera, may alias either input
+/// \param	from	Camera at t = 0
+/// \param	to		Camera at t = 1
+/// \param	t		Interpolation factor
+///////////////////////////////////////////////////////////////////////////////
+void RLCamera_Lerp(RLCamera *this, const RLCamera *from, const RLCamera *to,
+	float t);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Computes the projection for meshes built relative to position
+///
+/// \param	this		An RLCamera
+/// \param	transform	Pixel to clip space transform, y pointing down
+///////////////////////////////////////////////////////////////////////////////
+void RLCamera_GetTransform(const RLCamera *this, mat4x4 transform);
+
+#endif
@@ -0,0 +1,352 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	dijkstra.c
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Multi-source distance maps over a map's walkable plane that any
+///			number of monsters can walk downhill on
+///////////////////////////////////////////////////////////////////////////////
+
+#include "dijkstra.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <glib.h>
+
+#include "common.h"
+#include "log.h"
+#include "path.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+// Ring of buckets, a power of two longer than the dearest step
+#define RLFLOW_BUCKETS 16
+
+#define RLFLOW_NONE -1
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+	int cell;
+	int value;
+} RLFlowSource;
+
+struct _RLFlowField {
+	const RLMapGrid *map;
+	int width;
+	int num_cells;
+	int *distances;
+	// Doubly linked bucket lists, so a cell moves when its distance drops
+	int *next;
+	int *prev;
+	int heads[RLFLOW_BUCKETS];
+	int queued;
+	// Cells in the order they were settled, by increasing distance
+	int *order;
+	int num_order;
+	RLFlowSource *sources;
+	int num_sources;
+	int max_sources;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static variables
+///////////////////////////////////////////////////////////////////////////////
+
+static const int directions[8][2] = {
+	{1, 0}, {-1, 0}, {0, 1}, {0, -1},
+	{1, 1}, {-1, 1}, {1, -1}, {-1, -1}
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLFlow_Reserve(RLFlowField *this, int num_sources)
+{
+	if (num_sources > this->max_sources) {
+		this->max_sources = MAX(num_sources, this->max_sources * 2);
+		this->sources = g_renew(
+			RLFlowSource,
+			this->sources,
+			(gsize)this->max_sources
+			);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static int RLFlow_CompareSource(const void *a, const void *b)
+{
+	const int x = ((const RLFlowSource *)a)->value;
+	const int y = ((const RLFlowSource *)b)->value;
+
+	return (x > y) - (x < y);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLFlow_Lower(RLFlowField *this, int cell, int distance)
+{
+	int *head = &this->heads[distance & (RLFLOW_BUCKETS - 1)];
+
+	// Cells still holding a distance are queued, settled ones never lower
+	if (this->distances[cell] != RLFLOW_UNREACHED) {
+		if (this->prev[cell] != RLFLOW_NONE) {
+			this->next[this->prev[cell]] = this->next[cell];
+		}
+		else {
+			this->heads[this->distances[cell] & (RLFLOW_BUCKETS - 1)] =
+				this->next[cell];
+		}
+		if (this->next[cell] != RLFLOW_NONE) {
+			this->prev[this->next[cell]] = this->prev[cell];
+		}
+	}
+	else {
+		++this->queued;
+	}
+
+	this->distances[cell] = distance;
+	this->prev[cell] = RLFLOW_NONE;
+	this->next[cell] = *head;
+	if (*head != RLFLOW_NONE) {
+		this->prev[*head] = cell;
+	}
+	*head = cell;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLFlow_Expand(RLFlowField *this, int cell, int distance)
+{
+	const int x = cell % this->width, y = cell / this->width;
+	uint64_t around[3];
+
+	// The 3x3 neighbourhood as bits 0 to 2 of three rows
+	for (int i = 0; i < 3; ++i) {
+		around[i] = RLMapGrid_GetBits(this->map, RLMAP_WALKABLE, x - 1,
+			y - 1 + i);
+	}
+
+	for (int i = 0; i < 8; ++i) {
+		const int dx = directions[i][0], dy = directions[i][1];
+		const int n = cell + dy * this->width + dx;
+		const int d = distance + (dx && dy ? RLPATH_COST_DIAGONAL :
+			RLPATH_COST_STRAIGHT);
+
+		if (!(around[1 + dy] >> (1 + dx) & 1) || (dx && dy &&
+			(!(around[1] >> (1 + dx) & 1) || !(around[1 + dy] >> 1 & 1)))) {
+			continue;
+		}
+		if (d < this->distances[n]) {
+			RLFlow_Lower(this, n, d);
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLFlow_Run(RLFlowField *this)
+{
+	int current, s = 0;
+
+	for (int i = 0; i < this->num_cells; ++i) {
+		this->distances[i] = RLFLOW_UNREACHED;
+	}
+	for (int i = 0; i < RLFLOW_BUCKETS; ++i) {
+		this->heads[i] = RLFLOW_NONE;
+	}
+	this->queued = 0;
+	this->num_order = 0;
+	if (!this->num_sources) {
+		return;
+	}
+
+	// Queued distances stay within a step of current, so each bucket of
+	// the ring holds a single distance. Sources, sorted by value, join as
+	// current reaches them.
+	current = this->sources[0].value;
+	for (;;) {
+		int *head = &this->heads[current & (RLFLOW_BUCKETS - 1)];
+
+		for (; s < this->num_sources && this->sources[s].value == current;
+			++s) {
+			if (current < this->distances[this->sources[s].cell]) {
+				RLFlow_Lower(this, this->sources[s].cell, current);
+			}
+		}
+		while (*head != RLFLOW_NONE) {
+			const int cell = *head;
+
+			*head = this->next[cell];
+			if (*head != RLFLOW_NONE) {
+				this->prev[*head] = RLFLOW_NONE;
+			}
+			--this->queued;
+			this->order[this->num_order++] = cell;
+			RLFlow_Expand(this, cell, current);
+		}
+
+		if (this->queued) {
+			++current;
+		}
+		else if (s < this->num_sources) {
+			current = this->sources[s].value;
+		}
+		else {
+			break;
+		}
+	}
+
+	this->num_sources = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Public functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+RLFlowField * RLFlowField_Create(const RLMapGrid *map)
+{
+	RLFlowField *this = NULL;
+
+	if (!map) {
+		log_warn("NULL argument");
+		return NULL;
+	}
+
+	this = g_new0(RLFlowField, 1);
+	this->map = map;
+	this->width = map->size.width;
+	this->num_cells = map->size.width * map->size.height;
+	this->distances = g_new(int, (gsize)this->num_cells);
+	this->next = g_new(int, (gsize)this->num_cells);
+	this->prev = g_new(int, (gsize)this->num_cells);
+	this->order = g_new(int, (gsize)this->num_cells);
+	RLFlow_Run(this);
+
+	return this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLFlowField_AddSource(RLFlowField *this, int x, int y, int value)
+{
+	if (!this) {
+		log_warn("NULL argument");
+		return;
+	}
+	if (!RLMapGrid_InBounds(this->map, x, y)) {
+		logfmt_warn("Source %d,%d is off the map", x, y);
+		return;
+	}
+
+	RLFlow_Reserve(this, this->num_sources + 1);
+	this->sources[this->num_sources++] = (RLFlowSource){
+		y * this->width + x,
+		value
+	};
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLFlowField_Compute(RLFlowField *this)
+{
+	if (CONDBIND(this, log_warn, "NULL argument")) {
+		qsort(
+			this->sources,
+			(size_t)this->num_sources,
+			sizeof(RLFlowSource),
+			RLFlow_CompareSource
+			);
+		RLFlow_Run(this);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLFlowField_ComputeFlee(RLFlowField *this, const RLFlowField *src,
+	int num, int den)
+{
+	if (!this || !src) {
+		log_warn("NULL argument");
+		return;
+	}
+	if (this == src || src->map != this->map || den <= 0) {
+		log_warn("Invalid argument");
+		return;
+	}
+
+	// The scaled distances are monotonic in src's settling order, so the
+	// sources come out sorted without a sort
+	RLFlow_Reserve(this, src->num_order);
+	this->num_sources = src->num_order;
+	for (int i = 0; i < src->num_order; ++i) {
+		const int cell = src->order[num >= 0 ? src->num_order - 1 - i : i];
+		this->sources[i] = (RLFlowSource){
+			cell,
+			(int)(-(long long)src->distances[cell] * num / den)
+		};
+	}
+
+	RLFlow_Run(this);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int RLFlowField_GetDistance(const RLFlowField *this, int x, int y)
+{
+	if (!this) {
+		log_warn("NULL argument");
+		return RLFLOW_UNREACHED;
+	}
+	if (!RLMapGrid_InBounds(this->map, x, y)) {
+		return RLFLOW_UNREACHED;
+	}
+
+	return this->distances[y * this->width + x];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool RLFlowField_Step(const RLFlowField *this, int x, int y, int *dx,
+	int *dy)
+{
+	int best;
+
+	if (!this || !dx || !dy) {
+		log_warn("NULL argument");
+		return false;
+	}
+
+	best = RLFlowField_GetDistance(this, x, y);
+	*dx = 0;
+	*dy = 0;
+	for (int i = 0; i < 8; ++i) {
+		const int sx = directions[i][0], sy = directions[i][1];
+		const int d = RLFlowField_GetDistance(this, x + sx, y + sy);
+
+		if (d >= best || !RLMapGrid_GetBit(this->map, RLMAP_WALKABLE, x + sx,
+			y + sy) || (sx && sy && (!RLMapGrid_GetBit(this->map,
+			RLMAP_WALKABLE, x + sx, y) || !RLMapGrid_GetBit(this->map,
+			RLMAP_WALKABLE, x, y + sy)))) {
+			continue;
+		}
+		best = d;
+		*dx = sx;
+		*dy = sy;
+	}
+
+	return *dx || *dy;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLFlowField_Destroy(RLFlowField *this)
+{
+	if (CONDBIND(this, log_warn, "NULL argument")) {
+		g_free(this->distances);
+		g_free(this->next);
+		g_free(this->prev);
+		g_free(this->order);
+		g_free(this->sources);
+		g_free(this);
+	}
+}
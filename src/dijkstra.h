@@ -0,0 +1,120 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	dijkstra.h
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Multi-source distance maps over a map's walkable plane that any
+///			number of monsters can walk downhill on
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef DIJKSTRA_H
+#define DIJKSTRA_H
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdbool.h>
+#include <limits.h>
+
+#include "mapgrid.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+// Distance of cells no source reaches
+#define RLFLOW_UNREACHED INT_MAX
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+typedef struct _RLFlowField RLFlowField;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns a pointer to a new RLFlowField with every cell unreached
+///
+/// Allocates its per-cell arrays once. The map must outlive the
+/// RLFlowField, its size must not change.
+///
+/// \param	map	Map whose RLMAP_WALKABLE plane gives the passable cells
+///
+/// \return	Pointer to the new RLFlowField
+///////////////////////////////////////////////////////////////////////////////
+RLFlowField * RLFlowField_Create(const RLMapGrid *map);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Adds a source for the next RLFlowField_Compute
+///
+/// Monsters walking downhill head for the source that is cheapest to reach
+/// counting its value, so lower values make a source more attractive.
+///
+/// \param	this	An RLFlowField
+/// \param	x		Column of the source
+/// \param	y		Row of the source
+/// \param	value	Distance the source starts at
+///////////////////////////////////////////////////////////////////////////////
+void RLFlowField_AddSource(RLFlowField *this, int x, int y, int value);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Computes the distance of every walkable cell from the sources
+///			added since the last computation
+///
+/// Steps cost RLPATH_COST_STRAIGHT or RLPATH_COST_DIAGONAL and follow the
+/// pathfinder's rules, so a diagonal step never cuts a corner. Distances
+/// are settled in order from a ring of buckets, one per distance, which
+/// is enough as no step costs more than the ring is long.
+///
+/// \param	this	An RLFlowField
+///////////////////////////////////////////////////////////////////////////////
+void RLFlowField_Compute(RLFlowField *this);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Computes a safety map from another, for monsters fleeing its
+///			sources
+///
+/// Every cell src reached becomes a source valued -distance * num / den,
+/// and the distances are computed again from those. Walking downhill then
+/// leads away from src's sources, preferring open ground to dead ends
+/// close by as num / den grows past 1.
+///
+/// \param	this	An RLFlowField other than src
+/// \param	src		A computed RLFlowField of the same map
+/// \param	num		Numerator of the scale
+/// \param	den		Denominator of the scale, positive
+///////////////////////////////////////////////////////////////////////////////
+void RLFlowField_ComputeFlee(RLFlowField *this, const RLFlowField *src,
+	int num, int den);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns the distance of a cell
+///
+/// \param	this	An RLFlowField
+/// \param	x		Column of the cell
+/// \param	y		Row of the cell
+///
+/// \return	Distance, RLFLOW_UNREACHED if off the map or not reached
+///////////////////////////////////////////////////////////////////////////////
+int RLFlowField_GetDistance(const RLFlowField *this, int x, int y);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Finds the neighbour of a cell with the lowest distance
+///
+/// \param	this	An RLFlowField
+/// \param	x		Column of the cell
+/// \param	y		Row of the cell
+/// \param	dx		Set to the step's column offset
+/// \param	dy		Set to the step's row offset
+///
+/// \return	true if a neighbour is lower than the cell
+///////////////////////////////////////////////////////////////////////////////
+bool RLFlowField_Step(const RLFlowField *this, int x, int y, int *dx,
+	int *dy);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Frees the memory associated with an RLFlowField
+///
+/// \param	this	An RLFlowField
+///////////////////////////////////////////////////////////////////////////////
+void RLFlowField_Destroy(RLFlowField *this);
+
+#endif
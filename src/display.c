@@ -0,0 +1,235 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	display.c
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Ordered set of tile map layers composited in a single
+///			depth-tested pass
+///////////////////////////////////////////////////////////////////////////////
+
+#include "display.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <glib.h>
+
+#include "common.h"
+#include "log.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+// Alpha below which texels of an opaque layer are discarded
+#define RLDISPLAY_OPAQUE_CUTOFF 0.5f
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+struct _RLDisplay {
+	GLuint program;
+	GLint utransform;
+	GLint udepth;
+	GLint ucutoff;
+	bool dirty;
+	int num_layers;
+	RLLayer *layers[RLDISPLAY_MAX_LAYERS];
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLDisplay_Sort(RLDisplay *this)
+{
+	// Insertion sort, layers are few and almost always already in order
+	for (int i = 1; i < this->num_layers; ++i) {
+		RLLayer *layer = this->layers[i];
+		int j = i;
+		while (j > 0 && this->layers[j - 1]->z > layer->z) {
+			this->layers[j] = this->layers[j - 1];
+			--j;
+		}
+		this->layers[j] = layer;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLDisplay_DrawLayer(RLDisplay *this, int index, BMFont *font,
+	const RLCamera *camera, mat4x4 transforms[2])
+{
+	// Ortho projection maps z in [-1, 1] to depth in [1, 0]
+	const GLfloat depth = (GLfloat)(2 * index + 1) /
+		(GLfloat)RLDISPLAY_MAX_LAYERS - 1.0f;
+	RLLayer *layer = this->layers[index];
+
+	glUniformMatrix4fv(
+		this->utransform,
+		1,
+		GL_FALSE,
+		(GLfloat *)transforms[layer->screen_space]
+		);
+	glUniform1f(this->udepth, depth);
+	glUniform1f(
+		this->ucutoff,
+		layer->blend == RLLAYER_OPAQUE ? RLDISPLAY_OPAQUE_CUTOFF : 0.0f
+		);
+	RLTileMap_Draw(layer->tile_map, font, layer->screen_space ? NULL : camera);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Public functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+RLDisplay * RLDisplay_Create(GLuint program)
+{
+	RLDisplay *this = g_new0(RLDisplay, 1);
+
+	this->program = program;
+	this->utransform = glGetUniformLocation(program, "transform");
+	this->udepth = glGetUniformLocation(program, "depth");
+	this->ucutoff = glGetUniformLocation(program, "cutoff");
+	this->dirty = true;
+
+	if (this->utransform < 0 || this->udepth < 0 || this->ucutoff < 0) {
+		log_warn("Shader program lacks layer uniforms");
+	}
+
+	return this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+RLLayer * RLDisplay_AddLayer(RLDisplay *this, RLTileMap *tile_map, int z,
+	RLLayerBlend blend)
+{
+	RLLayer *layer = NULL;
+
+	if (!this || !tile_map) {
+		log_warn("NULL argument");
+		return NULL;
+	}
+	else if (this->num_layers == RLDISPLAY_MAX_LAYERS) {
+		log_warn("Display layer limit reached");
+		return NULL;
+	}
+
+	layer = g_new0(RLLayer, 1);
+	layer->tile_map = tile_map;
+	layer->z = z;
+	layer->visible = true;
+	layer->blend = blend;
+
+	this->layers[this->num_layers++] = layer;
+	this->dirty = true;
+	RLDisplay_Sort(this);
+
+	return layer;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLDisplay_SetLayerZ(RLDisplay *this, RLLayer *layer, int z)
+{
+	if (CONDBIND(this && layer, log_warn, "NULL argument")) {
+		layer->z = z;
+		this->dirty = true;
+		RLDisplay_Sort(this);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+RLLayer * RLDisplay_FindLayer(RLDisplay *this, int z)
+{
+	if (!this) {
+		log_warn("NULL argument");
+		return NULL;
+	}
+
+	for (int i = 0; i < this->num_layers; ++i) {
+		if (this->layers[i]->z == z) {
+			return this->layers[i];
+		}
+	}
+
+	return NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLDisplay_SetDirty(RLDisplay *this)
+{
+	if (CONDBIND(this, log_warn, "NULL argument")) {
+		this->dirty = true;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool RLDisplay_IsDirty(RLDisplay *this)
+{
+	return this && this->dirty;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLDisplay_Draw(RLDisplay *this, BMFont *font, const RLCamera *camera)
+{
+	// Scrolling layers use the camera, screen space layers the bare viewport
+	mat4x4 transforms[2];
+
+	if (!this || !font || !camera) {
+		log_warn("NULL argument");
+		return;
+	}
+
+	RLCamera_GetTransform(camera, transforms[0]);
+	mat4x4_ortho(
+		transforms[1],
+		0.0f,
+		(float)camera->viewport.width,
+		(float)camera->viewport.height,
+		0.0f,
+		-1.0f,
+		1.0f
+		);
+
+	glUseProgram(this->program);
+	glEnable(GL_DEPTH_TEST);
+	// Equal depth lets a tile's glyph land on its own background
+	glDepthFunc(GL_LEQUAL);
+
+	// Opaque layers front-to-back, writing depth without blending
+	glDisable(GL_BLEND);
+	glDepthMask(GL_TRUE);
+	for (int i = this->num_layers - 1; i >= 0; --i) {
+		if (this->layers[i]->visible &&
+			this->layers[i]->blend == RLLAYER_OPAQUE) {
+			RLDisplay_DrawLayer(this, i, font, camera, transforms);
+		}
+	}
+
+	// Transparent layers back-to-front, tested against opaque depth
+	glEnable(GL_BLEND);
+	glDepthMask(GL_FALSE);
+	for (int i = 0; i < this->num_layers; ++i) {
+		if (this->layers[i]->visible &&
+			this->layers[i]->blend == RLLAYER_TRANSPARENT) {
+			RLDisplay_DrawLayer(this, i, font, camera, transforms);
+		}
+	}
+
+	glDepthMask(GL_TRUE);
+	glDisable(GL_DEPTH_TEST);
+	this->dirty = false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLDisplay_Destroy(RLDisplay *this)
+{
+	if (CONDBIND(this, log_warn, "NULL argument")) {
+		for (int i = 0; i < this->num_layers; ++i) {
+			RLTileMap_Destroy(this->layers[i]->tile_map);
+			g_free(this->layers[i]);
+		}
+		g_free(this);
+	}
+}
@@ -0,0 +1,141 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	display.h
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Ordered set of tile map layers composited in a single
+///			depth-tested pass
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef DISPLAY_H
+#define DISPLAY_H
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdbool.h>
+
+#include "glad.h"
+#include "bmfont.h"
+#include "tilemap.h"
+#include "camera.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+#define RLDISPLAY_MAX_LAYERS 16
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Describes how a layer is blended with the layers below it
+///
+/// RLLAYER_OPAQUE:			Texels are either kept or discarded, writes depth
+///							and is drawn front-to-back without blending
+/// RLLAYER_TRANSPARENT:	Texels are alpha blended, does not write depth
+///							and is drawn back-to-front after opaque layers
+///////////////////////////////////////////////////////////////////////////////
+typedef enum {
+	RLLAYER_OPAQUE,
+	RLLAYER_TRANSPARENT
+} RLLayerBlend;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	A tile map drawn by an RLDisplay
+///
+/// Screen space layers (i.e. UI overlays) ignore the camera and are drawn
+/// whole, other layers scroll with the camera and are culled to its view.
+///////////////////////////////////////////////////////////////////////////////
+typedef struct {
+	RLTileMap *tile_map;
+	int z;
+	bool visible;
+	bool screen_space;
+	RLLayerBlend blend;
+} RLLayer;
+
+typedef struct _RLDisplay RLDisplay;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns a pointer to a new RLDisplay
+///
+/// \param	program	Tile shader program used to draw every layer
+///
+/// \return	Pointer to the new RLDisplay
+///////////////////////////////////////////////////////////////////////////////
+RLDisplay * RLDisplay_Create(GLuint program);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Adds a visible layer, taking ownership of its tile map
+///
+/// \param	this		An RLDisplay
+/// \param	tile_map	Tile map drawn by the layer
+/// \param	z			Stacking order, higher layers are drawn on top
+/// \param	blend		Blending mode of the layer
+///
+/// \return	Pointer to the new layer, stable until the display is destroyed
+///////////////////////////////////////////////////////////////////////////////
+RLLayer * RLDisplay_AddLayer(RLDisplay *this, RLTileMap *tile_map, int z,
+	RLLayerBlend blend);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Moves a layer to a new position in the stacking order
+///
+/// \param	this	An RLDisplay
+/// \param	layer	A layer of this display
+/// \param	z		New stacking order
+///////////////////////////////////////////////////////////////////////////////
+void RLDisplay_SetLayerZ(RLDisplay *this, RLLayer *layer, int z);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns the first layer with a given z
+///
+/// \param	this	An RLDisplay
+/// \param	z		Stacking order of the layer
+///
+/// \return	Pointer to the layer, or NULL if no layer has that z
+///////////////////////////////////////////////////////////////////////////////
+RLLayer * RLDisplay_FindLayer(RLDisplay *this, int z);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Marks the display as needing a redraw
+///
+/// Adding or reordering layers marks the display by itself, changes made
+/// directly to a layer or its tiles must be marked by the caller.
+///
+/// \param	this	An RLDisplay
+///////////////////////////////////////////////////////////////////////////////
+void RLDisplay_SetDirty(RLDisplay *this);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns whether the display changed since it was last drawn
+///
+/// \param	this	An RLDisplay
+///
+/// \return	true if a redraw is needed
+///////////////////////////////////////////////////////////////////////////////
+bool RLDisplay_IsDirty(RLDisplay *this);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Draws every visible layer
+///
+/// Opaque layers are drawn front-to-back so hidden texels fail the depth
+/// test early, then transparent layers are blended back-to-front. The
+/// caller clears the color and depth buffers and binds the glyph atlas.
+///
+/// \param	this	An RLDisplay
+/// \param	font	BMFont describing the glyph atlas
+/// \param	camera	Camera the scrolling layers are viewed through
+///////////////////////////////////////////////////////////////////////////////
+void RLDisplay_Draw(RLDisplay *this, BMFont *font, const RLCamera *camera);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Frees the memory associated with an RLDisplay and its layers
+///
+/// \param	this	An RLDisplay
+///////////////////////////////////////////////////////////////////////////////
+void RLDisplay_Destroy(RLDisplay *this);
+
+#endif
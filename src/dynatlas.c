@@ -0,0 +1,631 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	dynatlas.c
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Fixed size glyph atlas rasterized on demand from a TrueType font
+///			with FreeType, evicting the least recently used glyphs when full
+///////////////////////////////////////////////////////////////////////////////
+
+#include "dynatlas.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <glib.h>
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+#include "common.h"
+#include "log.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+// Empty texels right of and below each glyph, cleared on upload so nothing
+// left by an evicted glyph bleeds into its neighbours
+#define DYNATLAS_PADDING 1
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+typedef struct _DynGlyph DynGlyph;
+
+///////////////////////////////////////////////////////////////////////////////
+/// Glyph in a band's list, or with a band of -1 in the loose list, most
+/// recently used first
+///////////////////////////////////////////////////////////////////////////////
+struct _DynGlyph {
+	BMFontInfo info;
+	int band;
+	bool missing;
+	DynGlyph *prev;
+	DynGlyph *next;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// Top edge of the packed area over a run of columns
+///////////////////////////////////////////////////////////////////////////////
+typedef struct {
+	int x;
+	int y;
+	int width;
+} DynNode;
+
+///////////////////////////////////////////////////////////////////////////////
+/// Skyline packed strip of the texture, the unit of eviction
+///////////////////////////////////////////////////////////////////////////////
+typedef struct {
+	int num_nodes;
+	DynNode *nodes;
+	uint64_t used;
+	DynGlyph *glyphs;
+} DynBand;
+
+struct _DynAtlas {
+	FT_Library library;
+	FT_Face face;
+	BMFont *font;
+	GHashTable *glyphs;
+	GLuint texture;
+	int size;
+	int band_height;
+	int ascender;
+	struct {
+		int width;
+		int height;
+	} cell;
+	uint64_t frame;
+	uint64_t full_frame;
+	DynBand bands[DYNATLAS_BANDS];
+	DynGlyph *loose;
+	DynGlyph *loose_tail;
+	int num_loose;
+	unsigned char *scratch;
+	size_t scratch_size;
+	int num_rasterized;
+	int num_evicted;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+static void DynBand_Reset(DynBand *this, int width)
+{
+	this->num_nodes = 1;
+	this->nodes[0] = (DynNode){0, 0, width};
+	this->used = 0;
+	this->glyphs = NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static int DynBand_Fit(DynBand *this, int index, int width, int height,
+	int w, int h)
+{
+	int y = this->nodes[index].y, remaining = w;
+
+	if (this->nodes[index].x + w > width) {
+		return -1;
+	}
+
+	// Rests on the highest node the rectangle spans
+	for (int i = index; remaining > 0; ++i) {
+		y = MAX(y, this->nodes[i].y);
+		if (y + h > height) {
+			return -1;
+		}
+		remaining -= this->nodes[i].width;
+	}
+
+	return y;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static bool DynBand_Pack(DynBand *this, int width, int height, int w, int h,
+	int *x, int *y)
+{
+	int best = -1, best_top = height + 1, best_width = width + 1;
+	DynNode *nodes = this->nodes;
+
+	// Lowest resulting top edge, ties go to the narrowest node
+	for (int i = 0; i < this->num_nodes; ++i) {
+		const int fit = DynBand_Fit(this, i, width, height, w, h);
+		if (fit >= 0 && (fit + h < best_top ||
+			(fit + h == best_top && nodes[i].width < best_width))) {
+			best = i;
+			best_top = fit + h;
+			best_width = nodes[i].width;
+		}
+	}
+	if (best < 0) {
+		return false;
+	}
+
+	*x = nodes[best].x;
+	*y = best_top - h;
+
+	memmove(
+		&nodes[best + 1],
+		&nodes[best],
+		sizeof(DynNode) * (size_t)(this->num_nodes - best)
+		);
+	nodes[best] = (DynNode){*x, best_top, w};
+	++this->num_nodes;
+
+	// Trim or drop the nodes now covered by the new one
+	for (int i = best + 1; i < this->num_nodes; ) {
+		const int shrink = nodes[i - 1].x + nodes[i - 1].width - nodes[i].x;
+		if (shrink <= 0) {
+			break;
+		}
+		nodes[i].x += shrink;
+		nodes[i].width -= shrink;
+		if (nodes[i].width > 0) {
+			break;
+		}
+		memmove(
+			&nodes[i],
+			&nodes[i + 1],
+			sizeof(DynNode) * (size_t)(this->num_nodes - i - 1)
+			);
+		--this->num_nodes;
+	}
+
+	// Merge neighbours of equal height
+	for (int i = 0; i < this->num_nodes - 1; ) {
+		if (nodes[i].y != nodes[i + 1].y) {
+			++i;
+			continue;
+		}
+		nodes[i].width += nodes[i + 1].width;
+		memmove(
+			&nodes[i + 1],
+			&nodes[i + 2],
+			sizeof(DynNode) * (size_t)(this->num_nodes - i - 2)
+			);
+		--this->num_nodes;
+	}
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void DynAtlas_Evict(DynAtlas *this, int band)
+{
+	DynGlyph *glyph = this->bands[band].glyphs, *next = NULL;
+
+	for (; glyph; glyph = next) {
+		next = glyph->next;
+		g_hash_table_remove(this->glyphs, &glyph->info.glyph);
+	}
+	DynBand_Reset(&this->bands[band], this->size);
+	++this->num_evicted;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void DynAtlas_Unlink(DynAtlas *this, DynGlyph *entry)
+{
+	if (entry->prev) {
+		entry->prev->next = entry->next;
+	}
+	else {
+		this->loose = entry->next;
+	}
+	if (entry->next) {
+		entry->next->prev = entry->prev;
+	}
+	else {
+		this->loose_tail = entry->prev;
+	}
+	entry->prev = entry->next = NULL;
+	--this->num_loose;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void DynAtlas_Touch(DynAtlas *this, DynGlyph *entry)
+{
+	if (this->loose == entry) {
+		return;
+	}
+	else if (entry->prev) {
+		DynAtlas_Unlink(this, entry);
+	}
+
+	entry->next = this->loose;
+	if (this->loose) {
+		this->loose->prev = entry;
+	}
+	else {
+		this->loose_tail = entry;
+	}
+	this->loose = entry;
+	++this->num_loose;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Adds a glyph taking no room in the texture to the loose list
+///
+/// Past DYNATLAS_LOOSE_GLYPHS the least recently used one is forgotten, and
+/// is looked up with FreeType again if it comes back.
+///////////////////////////////////////////////////////////////////////////////
+static void DynAtlas_Remember(DynAtlas *this, DynGlyph *entry)
+{
+	g_hash_table_insert(this->glyphs, &entry->info.glyph, entry);
+	DynAtlas_Touch(this, entry);
+
+	if (this->num_loose > DYNATLAS_LOOSE_GLYPHS) {
+		DynGlyph *oldest = this->loose_tail;
+		DynAtlas_Unlink(this, oldest);
+		g_hash_table_remove(this->glyphs, &oldest->info.glyph);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static int DynAtlas_Place(DynAtlas *this, int w, int h, int *x, int *y)
+{
+	int victim = -1;
+
+	for (int i = 0; i < DYNATLAS_BANDS; ++i) {
+		if (DynBand_Pack(
+			&this->bands[i],
+			this->size,
+			this->band_height,
+			w,
+			h,
+			x,
+			y)) {
+			*y += i * this->band_height;
+			return i;
+		}
+	}
+
+	// Evict the band used longest ago, never one the current frame uses
+	for (int i = 0; i < DYNATLAS_BANDS; ++i) {
+		if (this->bands[i].used != this->frame && (victim < 0 ||
+			this->bands[i].used < this->bands[victim].used)) {
+			victim = i;
+		}
+	}
+	if (victim < 0) {
+		if (this->full_frame != this->frame) {
+			log_warn("Glyph atlas full, dropping glyphs this frame");
+			this->full_frame = this->frame;
+		}
+		return -1;
+	}
+
+	DynAtlas_Evict(this, victim);
+	DynBand_Pack(
+		&this->bands[victim],
+		this->size,
+		this->band_height,
+		w,
+		h,
+		x,
+		y
+		);
+	*y += victim * this->band_height;
+	return victim;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void DynAtlas_Upload(DynAtlas *this, const FT_Bitmap *bitmap, int x,
+	int y)
+{
+	const int w = (int)bitmap->width, h = (int)bitmap->rows;
+	const int stride = w + DYNATLAS_PADDING;
+	const size_t size = (size_t)stride * (size_t)(h + DYNATLAS_PADDING);
+
+	if (size > this->scratch_size) {
+		this->scratch = g_realloc(this->scratch, size);
+		this->scratch_size = size;
+	}
+	memset(this->scratch, 0, size);
+
+	// Expand to one byte of coverage per texel, top row first
+	for (int row = 0; row < h; ++row) {
+		const unsigned char *src = bitmap->buffer + (bitmap->pitch < 0 ?
+			(ptrdiff_t)(h - 1 - row) * -bitmap->pitch :
+			(ptrdiff_t)row * bitmap->pitch);
+		unsigned char *dst = this->scratch + (size_t)row * (size_t)stride;
+		for (int col = 0; col < w; ++col) {
+			if (bitmap->pixel_mode == FT_PIXEL_MODE_MONO) {
+				dst[col] = src[col >> 3] & (0x80 >> (col & 7)) ? 255 : 0;
+			}
+			else if (bitmap->num_grays == 256) {
+				dst[col] = src[col];
+			}
+			else {
+				dst[col] = (unsigned char)(src[col] * 255 /
+					MAX(bitmap->num_grays - 1, 1));
+			}
+		}
+	}
+
+	glBindTexture(GL_TEXTURE_2D, this->texture);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexSubImage2D(
+		GL_TEXTURE_2D,
+		0,
+		x,
+		y,
+		stride,
+		h + DYNATLAS_PADDING,
+		GL_RED,
+		GL_UNSIGNED_BYTE,
+		this->scratch
+		);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static DynGlyph * DynAtlas_Rasterize(DynAtlas *this, int glyph)
+{
+	const FT_UInt index = glyph > 0 ?
+		FT_Get_Char_Index(this->face, (FT_ULong)glyph) : 0;
+	const FT_Bitmap *bitmap = NULL;
+	DynGlyph *entry = NULL;
+	int x = 0, y = 0, band = -1, w, h;
+
+	entry = g_new0(DynGlyph, 1);
+	entry->info.glyph = glyph;
+	entry->band = -1;
+
+	// Misses are remembered so FreeType is not asked again every frame
+	if (!index || FT_Load_Glyph(this->face, index, FT_LOAD_RENDER)) {
+		entry->missing = true;
+		DynAtlas_Remember(this, entry);
+		return entry;
+	}
+
+	bitmap = &this->face->glyph->bitmap;
+	w = (int)bitmap->width;
+	h = (int)bitmap->rows;
+	if ((bitmap->pixel_mode != FT_PIXEL_MODE_GRAY &&
+		bitmap->pixel_mode != FT_PIXEL_MODE_MONO) ||
+		w + DYNATLAS_PADDING > this->size ||
+		h + DYNATLAS_PADDING > this->band_height) {
+		logfmt_warn("Glyph U+%04X cannot be stored in the atlas",
+			(unsigned)glyph);
+		entry->missing = true;
+		DynAtlas_Remember(this, entry);
+		return entry;
+	}
+
+	// Blank glyphs take no room, others are left out until a band frees up
+	if (w && h) {
+		if ((band = DynAtlas_Place(
+			this,
+			w + DYNATLAS_PADDING,
+			h + DYNATLAS_PADDING,
+			&x,
+			&y)) < 0) {
+			g_free(entry);
+			return NULL;
+		}
+		DynAtlas_Upload(this, bitmap, x, y);
+		entry->band = band;
+		entry->next = this->bands[band].glyphs;
+		this->bands[band].glyphs = entry;
+	}
+
+	entry->info.position.x = x;
+	entry->info.position.y = y;
+	entry->info.size.width = w;
+	entry->info.size.height = h;
+	entry->info.offset.x = this->face->glyph->bitmap_left;
+	entry->info.offset.y = this->ascender - this->face->glyph->bitmap_top;
+	if (band < 0) {
+		DynAtlas_Remember(this, entry);
+	}
+	else {
+		g_hash_table_insert(this->glyphs, &entry->info.glyph, entry);
+	}
+	++this->num_rasterized;
+
+	return entry;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static BMFontInfo const * DynAtlas_Lookup(void *data, int glyph)
+{
+	DynAtlas *this = data;
+	DynGlyph *entry = g_hash_table_lookup(this->glyphs, &glyph);
+
+	if (!entry && !(entry = DynAtlas_Rasterize(this, glyph))) {
+		return NULL;
+	}
+
+	if (entry->band >= 0) {
+		this->bands[entry->band].used = this->frame;
+	}
+	else {
+		DynAtlas_Touch(this, entry);
+	}
+	return entry->missing ? NULL : &entry->info;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Public functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+DynAtlas * DynAtlas_Create(const char *filename, int pixel_height, int size)
+{
+	DynAtlas *this = NULL;
+	const GLint swizzle[4] = {GL_ONE, GL_ONE, GL_ONE, GL_RED};
+	GLint max_size = 0;
+
+	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_size);
+	if (!filename) {
+		log_warn("NULL argument");
+		return NULL;
+	}
+	else if (pixel_height <= 0 || size < DYNATLAS_BANDS || size > max_size) {
+		log_warn("Invalid dynamic atlas size");
+		return NULL;
+	}
+
+	this = g_new0(DynAtlas, 1);
+	this->size = size;
+	this->band_height = size / DYNATLAS_BANDS;
+	this->frame = 1;
+
+	if (FT_Init_FreeType(&this->library)) {
+		log_warn("FreeType initialization failed");
+		goto error_library;
+	}
+	if (FT_New_Face(this->library, filename, 0, &this->face)) {
+		logfmt_warn("Font loading failed: %s", filename);
+		goto error_face;
+	}
+	if (FT_Set_Pixel_Sizes(this->face, 0, (FT_UInt)pixel_height)) {
+		logfmt_warn("Font has no %d pixel size: %s", pixel_height, filename);
+		goto error_size;
+	}
+
+	// Metrics are 26.6 fixed point
+	this->ascender = (int)(this->face->size->metrics.ascender >> 6);
+	this->cell.height = (int)(this->face->size->metrics.height >> 6);
+	for (FT_ULong c = 0x20; c < 0x7F; ++c) {
+		const FT_UInt index = FT_Get_Char_Index(this->face, c);
+		if (index && !FT_Load_Glyph(this->face, index, FT_LOAD_DEFAULT)) {
+			this->cell.width = MAX(
+				this->cell.width,
+				(int)((this->face->glyph->advance.x + 63) >> 6)
+				);
+		}
+	}
+	if (!this->cell.width) {
+		this->cell.width = (int)(this->face->size->metrics.max_advance >> 6);
+	}
+
+	for (int i = 0; i < DYNATLAS_BANDS; ++i) {
+		this->bands[i].nodes = g_new(DynNode, (size_t)size);
+		DynBand_Reset(&this->bands[i], size);
+	}
+	this->glyphs = g_hash_table_new_full(g_int_hash, g_int_equal, NULL,
+		g_free);
+
+	glGenTextures(1, &this->texture);
+	glBindTexture(GL_TEXTURE_2D, this->texture);
+	glTexImage2D(
+		GL_TEXTURE_2D,
+		0,
+		GL_R8,
+		size,
+		size,
+		0,
+		GL_RED,
+		GL_UNSIGNED_BYTE,
+		NULL
+		);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+	glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+
+	this->font = BMFont_CreateWith(DynAtlas_Lookup, this);
+
+	logfmt_info(
+		"Dynamic atlas %s: %dx%d texture, %dx%d cells",
+		filename,
+		size,
+		size,
+		this->cell.width,
+		this->cell.height
+		);
+
+	return this;
+
+error_size:
+
+	FT_Done_Face(this->face);
+
+error_face:
+
+	FT_Done_FreeType(this->library);
+
+error_library:
+
+	g_free(this);
+	return NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+BMFont * DynAtlas_GetFont(DynAtlas *this)
+{
+	if (!this) {
+		log_warn("NULL argument");
+		return NULL;
+	}
+	else {
+		return this->font;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+GLuint DynAtlas_GetTexture(DynAtlas *this)
+{
+	if (!this) {
+		log_warn("NULL argument");
+		return 0;
+	}
+	else {
+		return this->texture;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void DynAtlas_GetCellSize(DynAtlas *this, int *width, int *height)
+{
+	if (!this || !width || !height) {
+		log_warn("NULL argument");
+		return;
+	}
+
+	*width = this->cell.width;
+	*height = this->cell.height;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void DynAtlas_BeginFrame(DynAtlas *this)
+{
+	if (CONDBIND(this, log_warn, "NULL argument")) {
+		++this->frame;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void DynAtlas_Destroy(DynAtlas *this)
+{
+	if (!this) {
+		log_warn("NULL argument");
+		return;
+	}
+
+	logfmt_info(
+		"Dynamic atlas: %d glyphs rasterized, %d bands evicted",
+		this->num_rasterized,
+		this->num_evicted
+		);
+
+	glDeleteTextures(1, &this->texture);
+	BMFont_Destroy(this->font);
+	g_hash_table_destroy(this->glyphs);
+	for (int i = 0; i < DYNATLAS_BANDS; ++i) {
+		g_free(this->bands[i].nodes);
+	}
+	g_free(this->scratch);
+	FT_Done_Face(this->face);
+	FT_Done_FreeType(this->library);
+	g_free(this);
+}
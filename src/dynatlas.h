@@ -0,0 +1,104 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	dynatlas.h
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Fixed size glyph atlas rasterized on demand from a TrueType font
+///			with FreeType, evicting the least recently used glyphs when full
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef DYNATLAS_H
+#define DYNATLAS_H
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include "glad.h"
+#include "bmfont.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+// Horizontal bands of the texture, each packed and evicted as a whole
+#define DYNATLAS_BANDS 8
+
+// Missing, unstorable and blank glyphs remembered without taking room in
+// the texture, the least recently used one is forgotten past this
+#define DYNATLAS_LOOSE_GLYPHS 1024
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+typedef struct _DynAtlas DynAtlas;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns a pointer to a new DynAtlas
+///
+/// Requires a current OpenGL context. The texture is single channel, with
+/// a swizzle making glyphs white and their coverage alpha.
+///
+/// \param	filename		Path to a font file FreeType can open
+/// \param	pixel_height	Height of the font's em square in pixels
+/// \param	size			Width and height of the texture
+///
+/// \return	Pointer to the new DynAtlas, NULL on failure
+///////////////////////////////////////////////////////////////////////////////
+DynAtlas * DynAtlas_Create(const char *filename, int pixel_height, int size);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns a BMFont whose glyphs come from the atlas
+///
+/// Looking up a glyph not in the atlas rasterizes it and uploads only its
+/// rectangle, so the font must be used with the atlas' context current.
+/// Offsets place glyphs on the baseline of a cell as given by
+/// DynAtlas_GetCellSize. The BMFont is owned by the atlas.
+///
+/// Glyphs the font lacks, glyphs too big for a band and blank glyphs use
+/// no texture space. They are kept in a least recently used list of
+/// DYNATLAS_LOOSE_GLYPHS entries instead of a band, so looking up many
+/// distinct codepoints cannot grow the glyph table without bound.
+///
+/// \param	this	A DynAtlas
+///
+/// \return	Pointer to the BMFont
+///////////////////////////////////////////////////////////////////////////////
+BMFont * DynAtlas_GetFont(DynAtlas *this);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns the atlas texture
+///
+/// \param	this	A DynAtlas
+///
+/// \return	Texture name
+///////////////////////////////////////////////////////////////////////////////
+GLuint DynAtlas_GetTexture(DynAtlas *this);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Gets the advance and line height of the font
+///
+/// \param	this	A DynAtlas
+/// \param	width	Set to the advance of the widest ASCII glyph
+/// \param	height	Set to the line height
+///////////////////////////////////////////////////////////////////////////////
+void DynAtlas_GetCellSize(DynAtlas *this, int *width, int *height);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Starts a new frame of glyph lookups
+///
+/// Glyphs looked up since the last call stay where they are until the
+/// next one, since vertices already meshed this frame point at them. Once
+/// every band holds a glyph of the current frame, new glyphs are dropped.
+///
+/// \param	this	A DynAtlas
+///////////////////////////////////////////////////////////////////////////////
+void DynAtlas_BeginFrame(DynAtlas *this);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Frees the memory associated with a DynAtlas and its BMFont
+///
+/// \param	this	A DynAtlas
+///////////////////////////////////////////////////////////////////////////////
+void DynAtlas_Destroy(DynAtlas *this);
+
+#endif
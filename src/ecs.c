@@ -0,0 +1,529 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	ecs.c
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Entities and their components, stored in one table per set of
+///			components
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ecs.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+#include <glib.h>
+
+#include "common.h"
+#include "log.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+// Rows a table holds when first grown
+#define RLECS_MIN_ROWS 16
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Table of the entities with one set of components
+///
+/// A column per component in ascending component order, component c in
+/// column popcount(mask & (RLECS_BIT(c) - 1)). Rows are packed, removing
+/// one moves the last row into it.
+///////////////////////////////////////////////////////////////////////////////
+typedef struct {
+	uint64_t mask;
+	int num_columns;
+	size_t *sizes;
+	uint8_t **columns;
+	RLEntity *entities;
+	int count;
+	int capacity;
+	// Table of the mask with one component toggled, -1 until looked up
+	int edges[RLECS_MAX_COMPONENTS];
+} RLArchetype;
+
+typedef struct {
+	uint32_t generation;
+	int archetype;
+	int row;
+} RLEntityRecord;
+
+struct _RLQuery {
+	const RLWorld *world;
+	uint64_t with;
+	uint64_t without;
+	int *archetypes;
+	int num_archetypes;
+	int max_archetypes;
+	// Columns handed to the query's function, one per component of with
+	void **columns;
+};
+
+struct _RLWorld {
+	size_t sizes[RLECS_MAX_COMPONENTS];
+	int num_components;
+	RLArchetype *archetypes;
+	int num_archetypes;
+	int max_archetypes;
+	RLEntityRecord *records;
+	int num_records;
+	int max_records;
+	// Slots of despawned entities, reused last first
+	uint32_t *free_slots;
+	int num_free;
+	int max_free;
+	RLQuery **queries;
+	int num_queries;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+static int RLWorld_Column(const RLArchetype *archetype, int component)
+{
+	return __builtin_popcountll(archetype->mask &
+		(RLECS_BIT(component) - 1));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static bool RLWorld_Matches(const RLQuery *query, uint64_t mask)
+{
+	return (mask & query->with) == query->with && !(mask & query->without);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLWorld_AddMatch(RLQuery *query, int archetype)
+{
+	if (query->num_archetypes == query->max_archetypes) {
+		query->max_archetypes = MAX(8, query->max_archetypes * 2);
+		query->archetypes = g_renew(int, query->archetypes,
+			(gsize)query->max_archetypes);
+	}
+	query->archetypes[query->num_archetypes++] = archetype;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static int RLWorld_FindArchetype(RLWorld *this, uint64_t mask)
+{
+	RLArchetype *archetype = NULL;
+	int column = 0;
+
+	// Linear, but only reached the first time an edge is crossed
+	for (int i = 0; i < this->num_archetypes; ++i) {
+		if (this->archetypes[i].mask == mask) {
+			return i;
+		}
+	}
+
+	if (this->num_archetypes == this->max_archetypes) {
+		this->max_archetypes = MAX(16, this->max_archetypes * 2);
+		this->archetypes = g_renew(RLArchetype, this->archetypes,
+			(gsize)this->max_archetypes);
+	}
+	archetype = &this->archetypes[this->num_archetypes];
+	memset(archetype, 0, sizeof(*archetype));
+	memset(archetype->edges, -1, sizeof(archetype->edges));
+	archetype->mask = mask;
+	archetype->num_columns = __builtin_popcountll(mask);
+	archetype->sizes = g_new(size_t, (gsize)archetype->num_columns);
+	archetype->columns = g_new0(uint8_t *, (gsize)archetype->num_columns);
+	for (uint64_t bits = mask; bits; bits &= bits - 1) {
+		archetype->sizes[column++] = this->sizes[__builtin_ctzll(bits)];
+	}
+
+	for (int i = 0; i < this->num_queries; ++i) {
+		if (RLWorld_Matches(this->queries[i], mask)) {
+			RLWorld_AddMatch(this->queries[i], this->num_archetypes);
+		}
+	}
+
+	return this->num_archetypes++;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static int RLWorld_Neighbour(RLWorld *this, int archetype, int component)
+{
+	int next = this->archetypes[archetype].edges[component];
+
+	if (next < 0) {
+		next = RLWorld_FindArchetype(
+			this,
+			this->archetypes[archetype].mask ^ RLECS_BIT(component)
+			);
+		this->archetypes[archetype].edges[component] = next;
+		this->archetypes[next].edges[component] = archetype;
+	}
+
+	return next;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static int RLWorld_Push(RLArchetype *archetype, RLEntity entity)
+{
+	if (archetype->count == archetype->capacity) {
+		archetype->capacity = MAX(RLECS_MIN_ROWS, archetype->capacity * 2);
+		for (int i = 0; i < archetype->num_columns; ++i) {
+			archetype->columns[i] = g_realloc(
+				archetype->columns[i],
+				archetype->sizes[i] * (gsize)archetype->capacity
+				);
+		}
+		archetype->entities = g_renew(RLEntity, archetype->entities,
+			(gsize)archetype->capacity);
+	}
+	archetype->entities[archetype->count] = entity;
+
+	return archetype->count++;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLWorld_Pop(RLWorld *this, RLArchetype *archetype, int row)
+{
+	const int last = --archetype->count;
+
+	if (row == last) {
+		return;
+	}
+
+	for (int i = 0; i < archetype->num_columns; ++i) {
+		memcpy(
+			archetype->columns[i] + archetype->sizes[i] * (size_t)row,
+			archetype->columns[i] + archetype->sizes[i] * (size_t)last,
+			archetype->sizes[i]
+			);
+	}
+	archetype->entities[row] = archetype->entities[last];
+	this->records[(uint32_t)archetype->entities[row]].row = row;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLWorld_Move(RLWorld *this, RLEntityRecord *record, int next)
+{
+	RLArchetype *src = &this->archetypes[record->archetype];
+	RLArchetype *dst = &this->archetypes[next];
+	const int row = RLWorld_Push(dst, src->entities[record->row]);
+	int column = 0;
+
+	// Components in both tables are copied, the new one zeroed
+	for (uint64_t bits = dst->mask; bits; bits &= bits - 1) {
+		const int component = __builtin_ctzll(bits);
+		uint8_t *to = dst->columns[column] + dst->sizes[column] * (size_t)row;
+
+		if (src->mask & RLECS_BIT(component)) {
+			const int from = RLWorld_Column(src, component);
+
+			memcpy(
+				to,
+				src->columns[from] + src->sizes[from] * (size_t)record->row,
+				dst->sizes[column]
+				);
+		}
+		else {
+			memset(to, 0, dst->sizes[column]);
+		}
+		++column;
+	}
+
+	RLWorld_Pop(this, src, record->row);
+	record->archetype = next;
+	record->row = row;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static RLEntityRecord * RLWorld_Lookup(const RLWorld *this, RLEntity entity)
+{
+	const uint32_t slot = (uint32_t)entity;
+
+	if (slot >= (uint32_t)this->num_records ||
+		this->records[slot].generation != (uint32_t)(entity >> 32)) {
+		return NULL;
+	}
+
+	return &this->records[slot];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Public functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+RLWorld * RLWorld_Create(void)
+{
+	RLWorld *this = g_new0(RLWorld, 1);
+
+	// Table 0 holds entities without components
+	RLWorld_FindArchetype(this, 0);
+
+	return this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int RLWorld_RegisterComponent(RLWorld *this, size_t size)
+{
+	if (!this) {
+		log_warn("NULL argument");
+		return -1;
+	}
+	if (!size) {
+		log_warn("Invalid component size");
+		return -1;
+	}
+	if (this->num_components == RLECS_MAX_COMPONENTS) {
+		log_warn("Too many component types");
+		return -1;
+	}
+
+	this->sizes[this->num_components] = size;
+
+	return this->num_components++;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+RLEntity RLWorld_Spawn(RLWorld *this)
+{
+	RLEntityRecord *record = NULL;
+	uint32_t slot = 0;
+
+	if (!this) {
+		log_warn("NULL argument");
+		return RLECS_NULL;
+	}
+
+	if (this->num_free) {
+		slot = this->free_slots[--this->num_free];
+	}
+	else {
+		if (this->num_records == this->max_records) {
+			this->max_records = MAX(64, this->max_records * 2);
+			this->records = g_renew(RLEntityRecord, this->records,
+				(gsize)this->max_records);
+		}
+		slot = (uint32_t)this->num_records++;
+		// Generations start at 1, so no handle is RLECS_NULL
+		this->records[slot].generation = 1;
+	}
+
+	record = &this->records[slot];
+	record->archetype = 0;
+	record->row = RLWorld_Push(
+		&this->archetypes[0],
+		(RLEntity)record->generation << 32 | slot
+		);
+
+	return this->archetypes[0].entities[record->row];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLWorld_Despawn(RLWorld *this, RLEntity entity)
+{
+	RLEntityRecord *record = NULL;
+
+	if (!this) {
+		log_warn("NULL argument");
+		return;
+	}
+	if (!(record = RLWorld_Lookup(this, entity))) {
+		return;
+	}
+
+	RLWorld_Pop(this, &this->archetypes[record->archetype], record->row);
+	if (!++record->generation) {
+		record->generation = 1;
+	}
+
+	if (this->num_free == this->max_free) {
+		this->max_free = MAX(64, this->max_free * 2);
+		this->free_slots = g_renew(uint32_t, this->free_slots,
+			(gsize)this->max_free);
+	}
+	this->free_slots[this->num_free++] = (uint32_t)entity;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool RLWorld_IsAlive(const RLWorld *this, RLEntity entity)
+{
+	if (!this) {
+		log_warn("NULL argument");
+		return false;
+	}
+
+	return RLWorld_Lookup(this, entity) != NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void * RLWorld_Add(RLWorld *this, RLEntity entity, int component)
+{
+	RLEntityRecord *record = NULL;
+	RLArchetype *archetype = NULL;
+	int column = 0;
+
+	if (!this) {
+		log_warn("NULL argument");
+		return NULL;
+	}
+	if (component < 0 || component >= this->num_components) {
+		log_warn("Invalid component");
+		return NULL;
+	}
+	if (!(record = RLWorld_Lookup(this, entity))) {
+		return NULL;
+	}
+
+	if (!(this->archetypes[record->archetype].mask & RLECS_BIT(component))) {
+		RLWorld_Move(
+			this,
+			record,
+			RLWorld_Neighbour(this, record->archetype, component)
+			);
+	}
+
+	archetype = &this->archetypes[record->archetype];
+	column = RLWorld_Column(archetype, component);
+
+	return archetype->columns[column] +
+		archetype->sizes[column] * (size_t)record->row;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLWorld_Remove(RLWorld *this, RLEntity entity, int component)
+{
+	RLEntityRecord *record = NULL;
+
+	if (!this) {
+		log_warn("NULL argument");
+		return;
+	}
+	if (component < 0 || component >= this->num_components) {
+		log_warn("Invalid component");
+		return;
+	}
+	if (!(record = RLWorld_Lookup(this, entity))) {
+		return;
+	}
+
+	if (this->archetypes[record->archetype].mask & RLECS_BIT(component)) {
+		RLWorld_Move(
+			this,
+			record,
+			RLWorld_Neighbour(this, record->archetype, component)
+			);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void * RLWorld_Get(RLWorld *this, RLEntity entity, int component)
+{
+	RLEntityRecord *record = NULL;
+	RLArchetype *archetype = NULL;
+	int column = 0;
+
+	if (!this) {
+		log_warn("NULL argument");
+		return NULL;
+	}
+	if (component < 0 || component >= RLECS_MAX_COMPONENTS ||
+		!(record = RLWorld_Lookup(this, entity))) {
+		return NULL;
+	}
+
+	archetype = &this->archetypes[record->archetype];
+	if (!(archetype->mask & RLECS_BIT(component))) {
+		return NULL;
+	}
+	column = RLWorld_Column(archetype, component);
+
+	return archetype->columns[column] +
+		archetype->sizes[column] * (size_t)record->row;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+RLQuery * RLWorld_CreateQuery(RLWorld *this, uint64_t with, uint64_t without)
+{
+	RLQuery *query = NULL;
+
+	if (!this) {
+		log_warn("NULL argument");
+		return NULL;
+	}
+
+	// Systems asking for the same components share a query
+	for (int i = 0; i < this->num_queries; ++i) {
+		if (this->queries[i]->with == with &&
+			this->queries[i]->without == without) {
+			return this->queries[i];
+		}
+	}
+
+	query = g_new0(RLQuery, 1);
+	query->world = this;
+	query->with = with;
+	query->without = without;
+	query->columns = g_new0(void *, (gsize)__builtin_popcountll(with));
+	for (int i = 0; i < this->num_archetypes; ++i) {
+		if (RLWorld_Matches(query, this->archetypes[i].mask)) {
+			RLWorld_AddMatch(query, i);
+		}
+	}
+
+	this->queries = g_renew(RLQuery *, this->queries,
+		(gsize)this->num_queries + 1);
+	this->queries[this->num_queries++] = query;
+
+	return query;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLQuery_Each(RLQuery *this, RLQueryFunc func, void *data)
+{
+	if (!this || !func) {
+		log_warn("NULL argument");
+		return;
+	}
+
+	for (int i = 0; i < this->num_archetypes; ++i) {
+		const RLArchetype *archetype =
+			&this->world->archetypes[this->archetypes[i]];
+		int column = 0;
+
+		if (!archetype->count) {
+			continue;
+		}
+		for (uint64_t bits = this->with; bits; bits &= bits - 1) {
+			this->columns[column++] = archetype->columns[
+				RLWorld_Column(archetype, __builtin_ctzll(bits))];
+		}
+		func(data, archetype->count, archetype->entities, this->columns);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLWorld_Destroy(RLWorld *this)
+{
+	if (CONDBIND(this, log_warn, "NULL argument")) {
+		for (int i = 0; i < this->num_archetypes; ++i) {
+			for (int j = 0; j < this->archetypes[i].num_columns; ++j) {
+				g_free(this->archetypes[i].columns[j]);
+			}
+			g_free(this->archetypes[i].sizes);
+			g_free(this->archetypes[i].columns);
+			g_free(this->archetypes[i].entities);
+		}
+		for (int i = 0; i < this->num_queries; ++i) {
+			g_free(this->queries[i]->archetypes);
+			g_free(this->queries[i]->columns);
+			g_free(this->queries[i]);
+		}
+		g_free(this->archetypes);
+		g_free(this->records);
+		g_free(this->free_slots);
+		g_free(this->queries);
+		g_free(this);
+	}
+}
@@ -0,0 +1,176 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	ecs.h
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Entities and their components, stored in one table per set of
+///			components
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef ECS_H
+#define ECS_H
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+// Component types a world can register, one bit of a mask each
+#define RLECS_MAX_COMPONENTS 64
+
+// Mask of a single component type
+#define RLECS_BIT(component) ((uint64_t)1 << (component))
+
+// Handle no entity ever has
+#define RLECS_NULL ((RLEntity)0)
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Handle of an entity, its slot in the low 32 bits and the slot's
+///			generation in the high 32
+///
+/// A slot's generation goes up when its entity is despawned, so handles to
+/// the old entity stop matching once the slot is reused.
+///////////////////////////////////////////////////////////////////////////////
+typedef uint64_t RLEntity;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Called with one table of a query's matches
+///
+/// columns holds a packed array per component of the query's mask, in
+/// ascending component order, the row of an entity the same in each.
+///////////////////////////////////////////////////////////////////////////////
+typedef void (*RLQueryFunc)(void *data, int count, const RLEntity *entities,
+	void **columns);
+
+typedef struct _RLQuery RLQuery;
+
+typedef struct _RLWorld RLWorld;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns a pointer to a new RLWorld with no entities or component
+///			types
+///
+/// \return	Pointer to the new RLWorld
+///////////////////////////////////////////////////////////////////////////////
+RLWorld * RLWorld_Create(void);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Registers a component type
+///
+/// \param	this	An RLWorld
+/// \param	size	Size of the component in bytes, at least 1
+///
+/// \return	Id of the component type, -1 if the world has
+///			RLECS_MAX_COMPONENTS already
+///////////////////////////////////////////////////////////////////////////////
+int RLWorld_RegisterComponent(RLWorld *this, size_t size);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Creates an entity with no components
+///
+/// \param	this	An RLWorld
+///
+/// \return	Handle of the entity
+///////////////////////////////////////////////////////////////////////////////
+RLEntity RLWorld_Spawn(RLWorld *this);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Destroys an entity and its components
+///
+/// \param	this	An RLWorld
+/// \param	entity	Handle of the entity, ignored if not alive
+///////////////////////////////////////////////////////////////////////////////
+void RLWorld_Despawn(RLWorld *this, RLEntity entity);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns whether a handle refers to a live entity
+///
+/// \param	this	An RLWorld
+/// \param	entity	Handle of the entity
+///
+/// \return	true if the entity is alive
+///////////////////////////////////////////////////////////////////////////////
+bool RLWorld_IsAlive(const RLWorld *this, RLEntity entity);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Gives an entity a component
+///
+/// The entity moves to the table of its new set of components, its other
+/// components copied along. The last entity of the old table takes its
+/// row there.
+///
+/// \param	this		An RLWorld
+/// \param	entity		Handle of the entity
+/// \param	component	Id of the component type
+///
+/// \return	Pointer to the component, zeroed if new, valid until the next
+///			spawn, despawn, add or remove. NULL if the entity is not alive.
+///////////////////////////////////////////////////////////////////////////////
+void * RLWorld_Add(RLWorld *this, RLEntity entity, int component);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Takes a component away from an entity
+///
+/// \param	this		An RLWorld
+/// \param	entity		Handle of the entity
+/// \param	component	Id of the component type
+///////////////////////////////////////////////////////////////////////////////
+void RLWorld_Remove(RLWorld *this, RLEntity entity, int component);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns a component of an entity
+///
+/// \param	this		An RLWorld
+/// \param	entity		Handle of the entity
+/// \param	component	Id of the component type
+///
+/// \return	Pointer to the component, valid until the next spawn, despawn,
+///			add or remove. NULL if the entity is not alive or lacks it.
+///////////////////////////////////////////////////////////////////////////////
+void * RLWorld_Get(RLWorld *this, RLEntity entity, int component);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns a query over the entities that have every component of
+///			one mask and none of another
+///
+/// The query keeps its list of matching tables, updated as tables are
+/// created, so running it never tests tables that cannot match. It is
+/// freed with the world.
+///
+/// \param	this	An RLWorld
+/// \param	with	Components the entities have, built with RLECS_BIT
+/// \param	without	Components the entities lack
+///
+/// \return	Pointer to the query
+///////////////////////////////////////////////////////////////////////////////
+RLQuery * RLWorld_CreateQuery(RLWorld *this, uint64_t with, uint64_t without);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Calls a function with each non-empty table matching a query
+///
+/// func must not spawn, despawn, add or remove, as that moves rows under
+/// it. Record the changes and make them after.
+///
+/// \param	this	An RLQuery
+/// \param	func	Function called with each table
+/// \param	data	First argument to func
+///////////////////////////////////////////////////////////////////////////////
+void RLQuery_Each(RLQuery *this, RLQueryFunc func, void *data);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Frees the memory associated with an RLWorld and its queries
+///
+/// \param	this	An RLWorld
+///////////////////////////////////////////////////////////////////////////////
+void RLWorld_Destroy(RLWorld *this);
+
+#endif
@@ -0,0 +1,421 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	fov.c
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Symmetric shadowcasting field of view over a map's transparency
+///			plane, recomputed only when something it depends on changes
+///////////////////////////////////////////////////////////////////////////////
+
+#include "fov.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <limits.h>
+#include <math.h>
+#include <string.h>
+#include <glib.h>
+
+#include "common.h"
+#include "log.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// Slope num / den of a line from the viewer's centre, den is positive
+///////////////////////////////////////////////////////////////////////////////
+typedef struct {
+	int num;
+	int den;
+} RLFovSlope;
+
+///////////////////////////////////////////////////////////////////////////////
+/// Row of a quadrant at a distance from the viewer, between two slopes
+///////////////////////////////////////////////////////////////////////////////
+typedef struct {
+	int depth;
+	RLFovSlope start;
+	RLFovSlope end;
+} RLFovRow;
+
+struct _RLFov {
+	const RLMapGrid *map;
+	int radius;
+	bool dirty;
+	struct {
+		int x;
+		int y;
+	} viewer;
+	// Cells within the radius of the viewer, clipped to the map
+	struct {
+		int x;
+		int y;
+		int width;
+		int height;
+	} window;
+	int words_per_row;
+	size_t num_words;
+	uint64_t *visible;
+	// Cells whose transparency the last computation read
+	uint64_t *scanned;
+	RLFovRow *rows;
+	int num_rows;
+	int max_rows;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static variables
+///////////////////////////////////////////////////////////////////////////////
+
+// Map step along a row (col) and away from the viewer (depth) per quadrant
+static const int quadrants[4][4] = {
+	{1, 0, 0, -1},
+	{1, 0, 0, 1},
+	{0, 1, 1, 0},
+	{0, -1, 1, 0}
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+static int RLFov_FloorDiv(int a, int b)
+{
+	return a / b - (a % b != 0 && (a < 0) != (b < 0));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLFov_Reserve(RLFov *this)
+{
+	const int span = this->radius ? 2 * this->radius + 1 : INT_MAX;
+	const int width = MIN(span, this->map->size.width);
+	const int height = MIN(span, this->map->size.height);
+
+	this->words_per_row = (width + RLMAP_WORD_BITS - 1) / RLMAP_WORD_BITS;
+	this->num_words = (size_t)this->words_per_row * (size_t)height;
+	this->visible = g_renew(uint64_t, this->visible, this->num_words);
+	this->scanned = g_renew(uint64_t, this->scanned, this->num_words);
+	memset(this->visible, 0, this->num_words * sizeof(uint64_t));
+	memset(this->scanned, 0, this->num_words * sizeof(uint64_t));
+	this->window.width = 0;
+	this->window.height = 0;
+	this->dirty = true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLFov_Push(RLFov *this, int depth, RLFovSlope start,
+	RLFovSlope end)
+{
+	if (this->radius && depth > this->radius) {
+		return;
+	}
+	if (this->num_rows == this->max_rows) {
+		this->max_rows = MAX(this->max_rows * 2, 64);
+		this->rows = g_renew(RLFovRow, this->rows, (gsize)this->max_rows);
+	}
+
+	this->rows[this->num_rows++] = (RLFovRow){depth, start, end};
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLFov_SetSpan(RLFov *this, uint64_t *plane, int left, int right,
+	int y)
+{
+	uint64_t *row = plane + (size_t)(y - this->window.y) *
+		(size_t)this->words_per_row;
+
+	left -= this->window.x;
+	right -= this->window.x;
+	for (int i = left / RLMAP_WORD_BITS; i <= right / RLMAP_WORD_BITS; ++i) {
+		const int lo = MAX(left - i * RLMAP_WORD_BITS, 0);
+		const int hi = MIN(right + 1 - i * RLMAP_WORD_BITS, RLMAP_WORD_BITS);
+
+		row[i] |= (~(uint64_t)0 >> (RLMAP_WORD_BITS - (hi - lo))) << lo;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static bool RLFov_ScanOpen(RLFov *this, const RLFovRow *row, int first,
+	int last, int y)
+{
+	const RLMapGrid *map = this->map;
+	const int d = row->depth;
+	const int left = this->viewer.x + first, right = this->viewer.x + last;
+	int lo, hi;
+
+	// Only rows lying wholly on the map and transparent, tested a word of
+	// cells at a time
+	if (left > right || left < 0 || right >= map->size.width || y < 0 ||
+		y >= map->size.height) {
+		return false;
+	}
+	for (int x = left; x <= right; x += RLMAP_WORD_BITS) {
+		const int n = MIN(right + 1 - x, RLMAP_WORD_BITS);
+		const uint64_t mask = ~(uint64_t)0 >> (RLMAP_WORD_BITS - n);
+
+		if ((RLMapGrid_GetBits(map, RLMAP_TRANSPARENT, x, y) & mask) !=
+			mask) {
+			return false;
+		}
+	}
+
+	// With no walls the visible cells are one run, the symmetric columns
+	// clipped to the radius
+	lo = -RLFov_FloorDiv(-d * row->start.num, row->start.den);
+	hi = RLFov_FloorDiv(d * row->end.num, row->end.den);
+	if (this->radius) {
+		const int reach = (int)sqrt((double)(this->radius * this->radius +
+			this->radius - d * d));
+		lo = MAX(lo, -reach);
+		hi = MIN(hi, reach);
+	}
+
+	RLFov_SetSpan(this, this->scanned, left, right, y);
+	if (lo <= hi) {
+		RLFov_SetSpan(
+			this,
+			this->visible,
+			this->viewer.x + lo,
+			this->viewer.x + hi,
+			y
+			);
+	}
+	RLFov_Push(this, d + 1, row->start, row->end);
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLFov_Scan(RLFov *this, const int quadrant[4])
+{
+	const RLMapGrid *map = this->map;
+	const int r2 = this->radius * this->radius + this->radius;
+
+	RLFov_Push(this, 1, (RLFovSlope){-1, 1}, (RLFovSlope){1, 1});
+	while (this->num_rows) {
+		RLFovRow row = this->rows[--this->num_rows];
+		const int d = row.depth;
+		// Columns whose centres the slopes cover, rounding half cells out
+		const int first = RLFov_FloorDiv(2 * d * row.start.num +
+			row.start.den, 2 * row.start.den);
+		const int last = -RLFov_FloorDiv(row.end.den - 2 * d * row.end.num,
+			2 * row.end.den);
+		int prev = -1;
+
+		if (!quadrant[1] && RLFov_ScanOpen(this, &row, first, last,
+			this->viewer.y + d * quadrant[3])) {
+			continue;
+		}
+		for (int col = first; col <= last; ++col) {
+			const int x = this->viewer.x + col * quadrant[0] + d * quadrant[1];
+			const int y = this->viewer.y + col * quadrant[2] + d * quadrant[3];
+			const bool wall = !RLMapGrid_GetBit(map, RLMAP_TRANSPARENT, x, y);
+			const RLFovSlope slope = {2 * col - 1, 2 * d};
+
+			if (RLMapGrid_InBounds(map, x, y)) {
+				const int wx = x - this->window.x, wy = y - this->window.y;
+				const size_t word = (size_t)wy * (size_t)this->words_per_row +
+					(size_t)(wx / RLMAP_WORD_BITS);
+				const uint64_t bit = (uint64_t)1 << (wx % RLMAP_WORD_BITS);
+
+				this->scanned[word] |= bit;
+				// Floors only when the viewer's centre is inside the slopes
+				// from theirs, which is what makes sight symmetric
+				if ((wall || (col * row.start.den >= d * row.start.num &&
+					col * row.end.den <= d * row.end.num)) &&
+					(!this->radius || col * col + d * d <= r2)) {
+					this->visible[word] |= bit;
+				}
+			}
+
+			if (prev == 1 && !wall) {
+				row.start = slope;
+			}
+			else if (prev == 0 && wall) {
+				RLFov_Push(this, d + 1, row.start, slope);
+			}
+			prev = wall;
+		}
+		if (prev == 0) {
+			RLFov_Push(this, d + 1, row.start, row.end);
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Public functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+RLFov * RLFov_Create(const RLMapGrid *map, int radius)
+{
+	RLFov *this = NULL;
+
+	if (!map) {
+		log_warn("NULL argument");
+		return NULL;
+	}
+
+	this = g_new0(RLFov, 1);
+	this->map = map;
+	this->radius = MAX(radius, 0);
+	RLFov_Reserve(this);
+
+	return this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLFov_SetRadius(RLFov *this, int radius)
+{
+	if (CONDBIND(this, log_warn, "NULL argument")) {
+		this->radius = MAX(radius, 0);
+		RLFov_Reserve(this);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLFov_Invalidate(RLFov *this, int x, int y)
+{
+	int wx, wy;
+
+	if (!this) {
+		log_warn("NULL argument");
+		return;
+	}
+
+	wx = x - this->window.x;
+	wy = y - this->window.y;
+	if (this->dirty || wx < 0 || wy < 0 || wx >= this->window.width ||
+		wy >= this->window.height) {
+		return;
+	}
+
+	this->dirty = this->scanned[(size_t)wy * (size_t)this->words_per_row +
+		(size_t)(wx / RLMAP_WORD_BITS)] >> (wx % RLMAP_WORD_BITS) & 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool RLFov_Update(RLFov *this, int x, int y)
+{
+	const RLMapGrid *map = NULL;
+	size_t used;
+
+	if (!this) {
+		log_warn("NULL argument");
+		return false;
+	}
+	if (!this->dirty && x == this->viewer.x && y == this->viewer.y) {
+		return false;
+	}
+
+	map = this->map;
+	used = (size_t)this->words_per_row * (size_t)this->window.height;
+	memset(this->visible, 0, used * sizeof(uint64_t));
+	memset(this->scanned, 0, used * sizeof(uint64_t));
+
+	this->viewer.x = x;
+	this->viewer.y = y;
+	this->dirty = false;
+	if (this->radius) {
+		this->window.x = MAX(x - this->radius, 0);
+		this->window.y = MAX(y - this->radius, 0);
+		this->window.width = MIN(x + this->radius + 1, map->size.width) -
+			this->window.x;
+		this->window.height = MIN(y + this->radius + 1, map->size.height) -
+			this->window.y;
+	}
+	else {
+		this->window.x = 0;
+		this->window.y = 0;
+		this->window.width = map->size.width;
+		this->window.height = map->size.height;
+	}
+
+	// A viewer off the map sees nothing
+	if (!RLMapGrid_InBounds(map, x, y)) {
+		this->window.width = 0;
+		this->window.height = 0;
+		return true;
+	}
+
+	this->visible[(size_t)(y - this->window.y) *
+		(size_t)this->words_per_row + (size_t)((x - this->window.x) /
+		RLMAP_WORD_BITS)] |= (uint64_t)1 << ((x - this->window.x) %
+		RLMAP_WORD_BITS);
+	for (int i = 0; i < 4; ++i) {
+		RLFov_Scan(this, quadrants[i]);
+	}
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool RLFov_IsVisible(const RLFov *this, int x, int y)
+{
+	int wx, wy;
+
+	if (!this) {
+		log_warn("NULL argument");
+		return false;
+	}
+
+	wx = x - this->window.x;
+	wy = y - this->window.y;
+	if (wx < 0 || wy < 0 || wx >= this->window.width ||
+		wy >= this->window.height) {
+		return false;
+	}
+
+	return this->visible[(size_t)wy * (size_t)this->words_per_row +
+		(size_t)(wx / RLMAP_WORD_BITS)] >> (wx % RLMAP_WORD_BITS) & 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLFov_Explore(const RLFov *this, RLMapGrid *map)
+{
+	const int shift = this ? this->window.x % RLMAP_WORD_BITS : 0;
+
+	if (!this || !map) {
+		log_warn("NULL argument");
+		return;
+	}
+	if (map != this->map) {
+		log_warn("Map differs from the one the field of view was made for");
+		return;
+	}
+
+	RLMapGrid_Changed(map, RLMAP_EXPLORED, this->window.x, this->window.y,
+		this->window.width, this->window.height);
+
+	// Window rows start mid-word on the map, so each word spans two
+	for (int wy = 0; wy < this->window.height; ++wy) {
+		const uint64_t *src = this->visible + (size_t)wy *
+			(size_t)this->words_per_row;
+		uint64_t *dst = map->bits[RLMAP_EXPLORED] +
+			(size_t)(this->window.y + wy) * (size_t)map->words_per_row +
+			(size_t)(this->window.x / RLMAP_WORD_BITS);
+		const int words = (this->window.width + RLMAP_WORD_BITS - 1) /
+			RLMAP_WORD_BITS;
+
+		for (int i = 0; i < words; ++i) {
+			dst[i] |= src[i] << shift;
+			if (shift && src[i] >> (RLMAP_WORD_BITS - shift)) {
+				dst[i + 1] |= src[i] >> (RLMAP_WORD_BITS - shift);
+			}
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLFov_Destroy(RLFov *this)
+{
+	if (CONDBIND(this, log_warn, "NULL argument")) {
+		g_free(this->visible);
+		g_free(this->scanned);
+		g_free(this->rows);
+		g_free(this);
+	}
+}
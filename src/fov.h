@@ -0,0 +1,103 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	fov.h
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Symmetric shadowcasting field of view over a map's transparency
+///			plane, recomputed only when something it depends on changes
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef FOV_H
+#define FOV_H
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "mapgrid.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+typedef struct _RLFov RLFov;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns a pointer to a new RLFov
+///
+/// Nothing is visible until the first RLFov_Update. The map must outlive
+/// the RLFov.
+///
+/// \param	map		Map whose RLMAP_TRANSPARENT plane blocks sight
+/// \param	radius	Sight radius in cells, 0 for no limit
+///
+/// \return	Pointer to the new RLFov
+///////////////////////////////////////////////////////////////////////////////
+RLFov * RLFov_Create(const RLMapGrid *map, int radius);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Changes the sight radius, the next update recomputes
+///
+/// \param	this	An RLFov
+/// \param	radius	Sight radius in cells, 0 for no limit
+///////////////////////////////////////////////////////////////////////////////
+void RLFov_SetRadius(RLFov *this, int radius);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Tells the RLFov the transparency of a cell has changed
+///
+/// Only cells the last computation looked at can change its result, any
+/// other cell is ignored.
+///
+/// \param	this	An RLFov
+/// \param	x		Column of the cell
+/// \param	y		Row of the cell
+///////////////////////////////////////////////////////////////////////////////
+void RLFov_Invalidate(RLFov *this, int x, int y);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Recomputes the field of view if the viewer moved or it was
+///			invalidated
+///
+/// A cell is visible when a line from the viewer's centre reaches it, and
+/// then the viewer is visible from it too. Opaque cells are visible when
+/// their face is. Cells off the map are opaque.
+///
+/// \param	this	An RLFov
+/// \param	x		Column of the viewer
+/// \param	y		Row of the viewer
+///
+/// \return	true if the field of view was recomputed
+///////////////////////////////////////////////////////////////////////////////
+bool RLFov_Update(RLFov *this, int x, int y);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns whether a cell was visible at the last update
+///
+/// \param	this	An RLFov
+/// \param	x		Column of the cell
+/// \param	y		Row of the cell
+///
+/// \return	true if the cell is visible
+///////////////////////////////////////////////////////////////////////////////
+bool RLFov_IsVisible(const RLFov *this, int x, int y);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Sets the RLMAP_EXPLORED flag of every visible cell
+///
+/// Works a word of the visibility bitset at a time.
+///
+/// \param	this	An RLFov
+/// \param	map		The map the RLFov was created with
+///////////////////////////////////////////////////////////////////////////////
+void RLFov_Explore(const RLFov *this, RLMapGrid *map);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Frees the memory associated with an RLFov
+///
+/// \param	this	An RLFov
+///////////////////////////////////////////////////////////////////////////////
+void RLFov_Destroy(RLFov *this);
+
+#endif
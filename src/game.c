@@ -0,0 +1,393 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	game.c
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Game simulation running on its own thread and publishing display
+///			snapshots for the render thread
+///////////////////////////////////////////////////////////////////////////////
+
+#include "game.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <math.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <glib.h>
+
+#include "common.h"
+#include "log.h"
+#include "timing.h"
+#include "mapgrid.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+#define RLGAME_STEP_HZ 60
+#define RLGAME_FOLLOW 0.2f
+
+// Distance in pixels under which the camera snaps onto its target
+#define RLGAME_SETTLE 0.5f
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Terrain ids stored in the map's RLMAP_TERRAIN plane
+///////////////////////////////////////////////////////////////////////////////
+enum {
+	RLGAME_TERRAIN_WALL,
+	RLGAME_TERRAIN_FLOOR
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Entries of the terrain layer's palette
+///////////////////////////////////////////////////////////////////////////////
+enum {
+	RLGAME_COLOR_WALL,
+	RLGAME_COLOR_WALL_BG,
+	RLGAME_COLOR_FLOOR,
+	RLGAME_COLOR_FLOOR_BG
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+	int width;
+	int height;
+	uint64_t version;
+	RLTile *tiles;
+	// RLTILEMAP_PALETTE_SIZE colours, or NULL
+	RLColor *palette;
+} RLGameLayer;
+
+struct _RLGame {
+	RLSnapshotQueue *queue;
+	GAsyncQueue *inputs;
+	GThread *thread;
+	atomic_bool running;
+	bool animating;
+	uint64_t frame;
+	FrameClock *clock;
+	RLCamera camera;
+	RLCamera previous;
+	struct {
+		int x;
+		int y;
+	} player;
+	RLGameLayer layers[RLGAME_NUM_LAYERS];
+	RLMapGrid *map;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+static RLTile * RLGame_GetTile(RLGame *this, int layer, int x, int y)
+{
+	RLGameLayer *l = &this->layers[layer];
+
+	if (x < 0 || y < 0 || x >= l->width || y >= l->height) {
+		return NULL;
+	}
+	else {
+		return &l->tiles[y * l->width + x];
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLGame_Populate(RLGame *this)
+{
+	const char *status = "HP 10/10";
+	RLGameLayer *terrain = &this->layers[RLGAME_LAYER_TERRAIN];
+	RLGameLayer *ui = &this->layers[RLGAME_LAYER_UI];
+	RLTile wall = RLTile_Make('#', RLTILE_CENTER, RLGAME_COLOR_WALL,
+		RLGAME_COLOR_WALL_BG);
+	RLTile ground = RLTile_Make('.', RLTILE_CENTER, RLGAME_COLOR_FLOOR,
+		RLGAME_COLOR_FLOOR_BG);
+
+	// A walled dungeon, the player and a screen space status line
+	RLMapGrid_FillBytes(this->map, RLMAP_TERRAIN, 1, 1, terrain->width - 2,
+		terrain->height - 2, RLGAME_TERRAIN_FLOOR);
+	RLMapGrid_FillBits(this->map, RLMAP_WALKABLE, 1, 1, terrain->width - 2,
+		terrain->height - 2, true);
+	RLMapGrid_FillBits(this->map, RLMAP_TRANSPARENT, 1, 1,
+		terrain->width - 2, terrain->height - 2, true);
+
+	// Terrain tiles index the layer's palette, recolouring the dungeon is a
+	// palette edit
+	terrain->palette = g_new0(RLColor, RLTILEMAP_PALETTE_SIZE);
+	terrain->palette[RLGAME_COLOR_WALL] = RLCOLOR(200, 200, 200, 255);
+	terrain->palette[RLGAME_COLOR_WALL_BG] = RLCOLOR(60, 40, 30, 255);
+	terrain->palette[RLGAME_COLOR_FLOOR] = RLCOLOR(90, 90, 90, 255);
+	terrain->palette[RLGAME_COLOR_FLOOR_BG] = RLCOLOR(20, 20, 25, 255);
+	wall.flags = RLTILE_PALETTE;
+	ground.flags = RLTILE_PALETTE;
+	RLTile_Fill(
+		terrain->tiles,
+		(size_t)terrain->width * (size_t)terrain->height,
+		wall
+		);
+	for (int y = 1; y < terrain->height - 1; ++y) {
+		for (int x = 1; x < terrain->width - 1; ++x) {
+			*RLGame_GetTile(this, RLGAME_LAYER_TERRAIN, x, y) = ground;
+		}
+	}
+
+	this->player.x = terrain->width / 2;
+	this->player.y = terrain->height / 2;
+	*RLGame_GetTile(this, RLGAME_LAYER_ENTITY, this->player.x,
+		this->player.y) = RLTile_Make('@', RLTILE_CENTER,
+		RLCOLOR(255, 255, 0, 255), 0);
+	RLCamera_Follow(&this->camera, this->player.x, this->player.y, 1.0f);
+	this->previous = this->camera;
+	this->animating = true;
+
+	RLTile_BlendRect(
+		ui->tiles,
+		ui->width,
+		ui->height,
+		0,
+		0,
+		ui->width,
+		1,
+		RLTILE_BG,
+		RLCOLOR(0, 0, 0, 160)
+		);
+	for (int i = 0; status[i]; ++i) {
+		RLTile *tile = RLGame_GetTile(this, RLGAME_LAYER_UI, i + 1, 0);
+		*tile = RLTile_Make(
+			status[i],
+			RLTILE_TEXT,
+			RLCOLOR(255, 255, 255, 255),
+			tile->bg
+			);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLGame_Handle(RLGame *this, const RLInput *input)
+{
+	RLTile *src = NULL, *dst = NULL;
+	const int x = this->player.x + input->x, y = this->player.y + input->y;
+
+	switch (input->type) {
+	case RLINPUT_MOVE:
+		src = RLGame_GetTile(this, RLGAME_LAYER_ENTITY, this->player.x,
+			this->player.y);
+		dst = RLGame_GetTile(this, RLGAME_LAYER_ENTITY, x, y);
+		if (dst && RLMapGrid_GetBit(this->map, RLMAP_WALKABLE, x, y)) {
+			*dst = *src;
+			*src = RLTile_Make(0, RLTILE_CENTER, 0, 0);
+			this->player.x += input->x;
+			this->player.y += input->y;
+			++this->layers[RLGAME_LAYER_ENTITY].version;
+			this->animating = true;
+		}
+		break;
+	case RLINPUT_RESIZE:
+		RLCamera_Resize(&this->camera, input->x, input->y);
+		this->animating = true;
+		break;
+	case RLINPUT_WAKE:
+		break;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static bool RLGame_Animate(RLGame *this)
+{
+	RLCamera target = this->camera;
+	float dx, dy;
+
+	RLCamera_Follow(&target, this->player.x, this->player.y, 1.0f);
+	dx = (float)((target.position.x - this->camera.position.x) *
+		target.tile_size.width) + target.offset.x - this->camera.offset.x;
+	dy = (float)((target.position.y - this->camera.position.y) *
+		target.tile_size.height) + target.offset.y - this->camera.offset.y;
+
+	// The follow only ever approaches its target, finish it off
+	if (fabsf(dx) < RLGAME_SETTLE && fabsf(dy) < RLGAME_SETTLE) {
+		this->camera = target;
+		return false;
+	}
+
+	RLCamera_Follow(
+		&this->camera,
+		this->player.x,
+		this->player.y,
+		RLGAME_FOLLOW
+		);
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLGame_Publish(RLGame *this)
+{
+	RLSnapshot *snapshot = RLSnapshotQueue_Begin(this->queue);
+
+	snapshot->frame = ++this->frame;
+	snapshot->time = SDL_GetPerformanceCounter();
+	snapshot->step = FrameClock_GetStepTicks(this->clock);
+	snapshot->camera = this->camera;
+	snapshot->previous = this->previous;
+
+	// The buffer is two publishes old, only refresh layers changed since
+	for (int i = 0; i < RLGAME_NUM_LAYERS; ++i) {
+		RLSnapshotLayer *dst = &snapshot->layers[i];
+		if (dst->version != this->layers[i].version) {
+			memcpy(
+				dst->tiles,
+				this->layers[i].tiles,
+				sizeof(RLTile) * (size_t)dst->width * (size_t)dst->height
+				);
+			RLSnapshotLayer_SetPalette(dst, this->layers[i].palette);
+			dst->version = this->layers[i].version;
+		}
+	}
+
+	RLSnapshotQueue_Publish(this->queue);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static gpointer RLGame_Run(gpointer data)
+{
+	RLGame *this = data;
+	RLInput *input = NULL;
+	bool changed;
+
+	while (atomic_load(&this->running)) {
+		// Turn-based, nothing changes until the next input once settled
+		if (!this->animating) {
+			input = g_async_queue_pop(this->inputs);
+			RLGame_Handle(this, input);
+			g_free(input);
+			FrameClock_Reset(this->clock);
+		}
+
+		FrameClock_Tick(this->clock);
+		while ((input = g_async_queue_try_pop(this->inputs))) {
+			RLGame_Handle(this, input);
+			g_free(input);
+		}
+		// Anything that changes the picture also starts an animation
+		changed = this->animating;
+		while (this->animating && FrameClock_Step(this->clock)) {
+			this->previous = this->camera;
+			this->animating = RLGame_Animate(this);
+		}
+		if (changed) {
+			RLGame_Publish(this);
+		}
+		FrameClock_Limit(this->clock);
+	}
+
+	return NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Public functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+RLGame * RLGame_Create(RLSnapshotQueue *queue, int width, int height,
+	const RLCamera *camera)
+{
+	RLGame *this = NULL;
+	int sizes[RLGAME_NUM_LAYERS][2] = {
+		{width, height},
+		{width, height},
+		{0, 0}
+	};
+
+	if (!queue || !camera) {
+		log_warn("NULL argument");
+		return NULL;
+	}
+
+	sizes[RLGAME_LAYER_UI][0] = camera->viewport.width /
+		camera->tile_size.width;
+	sizes[RLGAME_LAYER_UI][1] = camera->viewport.height /
+		camera->tile_size.height;
+
+	this = g_new0(RLGame, 1);
+	this->queue = queue;
+	this->inputs = g_async_queue_new_full(g_free);
+	this->clock = FrameClock_Create(RLGAME_STEP_HZ, RLGAME_STEP_HZ);
+	this->camera = *camera;
+	atomic_init(&this->running, false);
+
+	if (!(this->map = RLMapGrid_Create(width, height))) {
+		log_warn("Map creation failed");
+		RLGame_Destroy(this);
+		return NULL;
+	}
+
+	for (int i = 0; i < RLGAME_NUM_LAYERS; ++i) {
+		RLGameLayer *layer = &this->layers[i];
+		if (RLSnapshotQueue_AddLayer(queue, sizes[i][0], sizes[i][1]) != i) {
+			log_warn("Snapshot layer creation failed");
+			RLGame_Destroy(this);
+			return NULL;
+		}
+		layer->width = sizes[i][0];
+		layer->height = sizes[i][1];
+		layer->version = 1;
+		layer->tiles = g_new0(
+			RLTile,
+			(gsize)layer->width * (gsize)layer->height
+			);
+	}
+
+	RLGame_Populate(this);
+	return this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLGame_Start(RLGame *this)
+{
+	if (!this) {
+		log_warn("NULL argument");
+	}
+	else if (this->thread) {
+		log_warn("Simulation thread already running");
+	}
+	else {
+		atomic_store(&this->running, true);
+		this->thread = g_thread_new("simulation", RLGame_Run, this);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLGame_PushInput(RLGame *this, RLInput input)
+{
+	if (CONDBIND(this, log_warn, "NULL argument")) {
+		RLInput *copy = g_new(RLInput, 1);
+		*copy = input;
+		g_async_queue_push(this->inputs, copy);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLGame_Destroy(RLGame *this)
+{
+	if (CONDBIND(this, log_warn, "NULL argument")) {
+		if (this->thread) {
+			atomic_store(&this->running, false);
+			RLGame_PushInput(this, (RLInput){RLINPUT_WAKE, 0, 0});
+			g_thread_join(this->thread);
+		}
+		for (int i = 0; i < RLGAME_NUM_LAYERS; ++i) {
+			g_free(this->layers[i].tiles);
+			g_free(this->layers[i].palette);
+		}
+		if (this->map) {
+			RLMapGrid_Destroy(this->map);
+		}
+		g_async_queue_unref(this->inputs);
+		FrameClock_Destroy(this->clock);
+		g_free(this);
+	}
+}
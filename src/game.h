@@ -0,0 +1,96 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	game.h
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Game simulation running on its own thread and publishing display
+///			snapshots for the render thread
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef GAME_H
+#define GAME_H
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include "camera.h"
+#include "snapshot.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Snapshot layers published by the game, by z
+///////////////////////////////////////////////////////////////////////////////
+enum {
+	RLGAME_LAYER_TERRAIN,
+	RLGAME_LAYER_ENTITY,
+	RLGAME_LAYER_UI,
+	RLGAME_NUM_LAYERS
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Input forwarded from the event thread to the simulation
+///
+/// RLINPUT_MOVE:	Move the player by (x, y) tiles
+/// RLINPUT_RESIZE:	The viewport is now x by y pixels
+/// RLINPUT_WAKE:	Wake an idle simulation without changing anything
+///////////////////////////////////////////////////////////////////////////////
+typedef enum {
+	RLINPUT_MOVE,
+	RLINPUT_RESIZE,
+	RLINPUT_WAKE
+} RLInputType;
+
+typedef struct {
+	RLInputType type;
+	int x;
+	int y;
+} RLInput;
+
+typedef struct _RLGame RLGame;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns a pointer to a new RLGame
+///
+/// Adds the game's layers to queue, which must not be in use yet.
+///
+/// \param	queue	Queue the snapshots are published to
+/// \param	width	Width of the dungeon in tiles
+/// \param	height	Height of the dungeon in tiles
+/// \param	camera	Initial camera, its viewport sizes the UI layer
+///
+/// \return	Pointer to the new RLGame
+///////////////////////////////////////////////////////////////////////////////
+RLGame * RLGame_Create(RLSnapshotQueue *queue, int width, int height,
+	const RLCamera *camera);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Starts the simulation thread
+///
+/// \param	this	An RLGame
+///////////////////////////////////////////////////////////////////////////////
+void RLGame_Start(RLGame *this);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Queues an input for the simulation thread, callable from any
+///			thread
+///
+/// \param	this	An RLGame
+/// \param	input	Input to handle on the next simulation tick
+///////////////////////////////////////////////////////////////////////////////
+void RLGame_PushInput(RLGame *this, RLInput input);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Stops the simulation thread and frees the memory associated with
+///			an RLGame
+///
+/// \param	this	An RLGame
+///////////////////////////////////////////////////////////////////////////////
+void RLGame_Destroy(RLGame *this);
+
+#endif
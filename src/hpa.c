@@ -0,0 +1,952 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	hpa.c
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Hierarchical pathfinding over a map's walkable plane, for long
+///			trips across large maps
+///////////////////////////////////////////////////////////////////////////////
+
+#include "hpa.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+
+#include "common.h"
+#include "log.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+// Ring of buckets of the search within a cluster, longer than the dearest
+// step
+#define RLHPA_BUCKETS 16
+
+// Runs of walkable border cells this long get an entrance at each end
+#define RLHPA_LONG_RUN 6
+
+#define RLHPA_NONE -1
+
+// Heap position of a node that has been expanded
+#define RLHPA_CLOSED -1
+
+#define RLHPA_UNREACHED INT_MAX
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// Sides of a cluster, in the order its nodes are numbered. A side and its
+/// opposite differ in the lowest bit.
+///////////////////////////////////////////////////////////////////////////////
+typedef enum {
+	RLHPA_EAST,
+	RLHPA_WEST,
+	RLHPA_SOUTH,
+	RLHPA_NORTH,
+	RLHPA_NUM_SIDES
+} RLHpaSide;
+
+///////////////////////////////////////////////////////////////////////////////
+/// Borders of a cluster with the clusters east and south of it
+///////////////////////////////////////////////////////////////////////////////
+typedef enum {
+	RLHPA_VERTICAL,
+	RLHPA_HORIZONTAL,
+	RLHPA_NUM_BORDERS
+} RLHpaBorder;
+
+///////////////////////////////////////////////////////////////////////////////
+/// What a cluster needs rebuilt, a higher state includes the lower ones
+///////////////////////////////////////////////////////////////////////////////
+typedef enum {
+	RLHPA_CLEAN,
+	RLHPA_ENTRANCES,
+	RLHPA_CELLS
+} RLHpaState;
+
+typedef struct {
+	int x;
+	int y;
+	int width;
+	int height;
+} RLHpaRect;
+
+///////////////////////////////////////////////////////////////////////////////
+/// Nodes of a cluster, one per entrance on each side, and the costs of the
+/// edges between them
+///////////////////////////////////////////////////////////////////////////////
+typedef struct {
+	// First node of each side, the last is the number of nodes
+	int offsets[RLHPA_NUM_SIDES + 1];
+	// Cost from every node to every other, -1 if there is no way inside
+	int *costs;
+} RLHpaCluster;
+
+///////////////////////////////////////////////////////////////////////////////
+/// Search state of a node, only valid while generation matches the query's
+///////////////////////////////////////////////////////////////////////////////
+typedef struct {
+	uint32_t generation;
+	int g;
+	int parent;
+	int heap;
+} RLHpaNode;
+
+typedef struct {
+	uint64_t key;
+	int node;
+} RLHpaEntry;
+
+typedef struct {
+	int cell;
+	int next;
+} RLHpaLink;
+
+struct _RLPathHierarchy {
+	const RLMapGrid *map;
+	// Walkable plane version the clusters were last brought up to
+	uint32_t version;
+	int width;
+	int cluster_size;
+	int clusters_per_row;
+	int num_clusters;
+	// Nodes a cluster has room for, every cell of its four sides
+	int slots;
+	RLHpaCluster *clusters;
+	// Cells of the nodes, slots per cluster
+	int *node_cells;
+	// Entrances of each cluster's east and south borders, as offsets along
+	// the border, cluster_size per cluster
+	int *num_entrances[RLHPA_NUM_BORDERS];
+	uint8_t *entrances[RLHPA_NUM_BORDERS];
+	uint8_t *states;
+	int *pending;
+	int num_pending;
+	// Search within a cluster, by cell of the cluster
+	int *distances;
+	int *parents;
+	RLHpaLink *links;
+	// Search of the nodes, followed by the start and the goal
+	RLHpaNode *nodes;
+	RLHpaEntry *heap;
+	int heap_size;
+	uint32_t generation;
+	int start;
+	int goal;
+	int *start_costs;
+	int *goal_costs;
+	int direct;
+	int expanded;
+	int rebuilt;
+	// Planned route as cells, and the steps of the leg being walked
+	int *route;
+	int route_length;
+	int leg;
+	int *steps;
+	int num_steps;
+	int step;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static variables
+///////////////////////////////////////////////////////////////////////////////
+
+static const int directions[8][2] = {
+	{1, 0}, {-1, 0}, {0, 1}, {0, -1},
+	{1, 1}, {-1, 1}, {1, -1}, {-1, -1}
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+static inline bool RLHpa_Open(const RLPathHierarchy *this, int x, int y)
+{
+	return RLMapGrid_GetBit(this->map, RLMAP_WALKABLE, x, y);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static int RLHpa_Distance(int dx, int dy)
+{
+	const int ax = abs(dx), ay = abs(dy);
+
+	return RLPATH_COST_STRAIGHT * MAX(ax, ay) +
+		(RLPATH_COST_DIAGONAL - RLPATH_COST_STRAIGHT) * MIN(ax, ay);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static int RLHpa_ClusterOf(const RLPathHierarchy *this, int cell)
+{
+	const int x = cell % this->width, y = cell / this->width;
+
+	return y / this->cluster_size * this->clusters_per_row +
+		x / this->cluster_size;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static RLHpaRect RLHpa_GetRect(const RLPathHierarchy *this, int cluster)
+{
+	const int size = this->cluster_size;
+	const int x = cluster % this->clusters_per_row * size;
+	const int y = cluster / this->clusters_per_row * size;
+
+	return (RLHpaRect){
+		x,
+		y,
+		MIN(size, this->map->size.width - x),
+		MIN(size, this->map->size.height - y)
+	};
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static inline int RLHpa_Local(const RLPathHierarchy *this,
+	const RLHpaRect *rect, int cell)
+{
+	return (cell / this->width - rect->y) * rect->width +
+		cell % this->width - rect->x;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLHpa_Search(RLPathHierarchy *this, const RLHpaRect *rect,
+	int from, int to)
+{
+	const int num_cells = rect->width * rect->height;
+	int heads[RLHPA_BUCKETS], queued = 1, used = 1, current = 0;
+
+	for (int i = 0; i < num_cells; ++i) {
+		this->distances[i] = RLHPA_UNREACHED;
+	}
+	for (int i = 1; i < RLHPA_BUCKETS; ++i) {
+		heads[i] = RLHPA_NONE;
+	}
+	heads[0] = 0;
+	this->links[0] = (RLHpaLink){RLHpa_Local(this, rect, from), RLHPA_NONE};
+	this->distances[this->links[0].cell] = 0;
+	this->parents[this->links[0].cell] = RLHPA_NONE;
+
+	// Dial's algorithm, a bucket per distance. Cells are pushed again when
+	// their distance drops, the stale links are skipped.
+	while (queued) {
+		int *head = &heads[current & (RLHPA_BUCKETS - 1)];
+
+		while (*head != RLHPA_NONE) {
+			const RLHpaLink link = this->links[*head];
+			const int x = rect->x + link.cell % rect->width;
+			const int y = rect->y + link.cell / rect->width;
+			uint64_t around[3];
+
+			*head = link.next;
+			--queued;
+			if (this->distances[link.cell] != current) {
+				continue;
+			}
+			if (y * this->width + x == to) {
+				return;
+			}
+
+			for (int i = 0; i < 3; ++i) {
+				around[i] = RLMapGrid_GetBits(this->map, RLMAP_WALKABLE,
+					x - 1, y - 1 + i);
+			}
+			for (int i = 0; i < 8; ++i) {
+				const int dx = directions[i][0], dy = directions[i][1];
+				const int n = link.cell + dy * rect->width + dx;
+				const int d = current + (dx && dy ? RLPATH_COST_DIAGONAL :
+					RLPATH_COST_STRAIGHT);
+				int *bucket = &heads[d & (RLHPA_BUCKETS - 1)];
+
+				if (x + dx < rect->x || x + dx >= rect->x + rect->width ||
+					y + dy < rect->y || y + dy >= rect->y + rect->height) {
+					continue;
+				}
+				if (!(around[1 + dy] >> (1 + dx) & 1) || (dx && dy &&
+					(!(around[1] >> (1 + dx) & 1) ||
+					!(around[1 + dy] >> 1 & 1)))) {
+					continue;
+				}
+				if (d < this->distances[n]) {
+					this->distances[n] = d;
+					this->parents[n] = link.cell;
+					this->links[used] = (RLHpaLink){n, *bucket};
+					*bucket = used++;
+					++queued;
+				}
+			}
+		}
+		++current;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static bool RLHpa_UpdateBorder(RLPathHierarchy *this, RLHpaBorder border,
+	int cluster)
+{
+	const RLHpaRect rect = RLHpa_GetRect(this, cluster);
+	uint8_t found[RLHPA_MAX_CLUSTER];
+	uint8_t *entrances = this->entrances[border] +
+		(size_t)cluster * (size_t)this->cluster_size;
+	int *num_entrances = &this->num_entrances[border][cluster];
+	uint64_t open = 0;
+	int length, count = 0, run = 0;
+	bool changed;
+
+	// Bit i is set where the cells either side of offset i are walkable
+	if (border == RLHPA_VERTICAL) {
+		const int x = rect.x + rect.width - 1;
+
+		length = rect.height;
+		for (int i = 0; i < length; ++i) {
+			if (RLHpa_Open(this, x, rect.y + i) &&
+				RLHpa_Open(this, x + 1, rect.y + i)) {
+				open |= (uint64_t)1 << i;
+			}
+		}
+	}
+	else {
+		const int y = rect.y + rect.height - 1;
+
+		length = rect.width;
+		open = RLMapGrid_GetBits(this->map, RLMAP_WALKABLE, rect.x, y) &
+			RLMapGrid_GetBits(this->map, RLMAP_WALKABLE, rect.x, y + 1);
+		if (length < RLMAP_WORD_BITS) {
+			open &= ((uint64_t)1 << length) - 1;
+		}
+	}
+
+	for (int i = 0; i <= length; ++i) {
+		if (i < length && open >> i & 1) {
+			++run;
+			continue;
+		}
+		if (run >= RLHPA_LONG_RUN) {
+			found[count++] = (uint8_t)(i - run);
+			found[count++] = (uint8_t)(i - 1);
+		}
+		else if (run) {
+			found[count++] = (uint8_t)(i - 1 - run / 2);
+		}
+		run = 0;
+	}
+
+	changed = count != *num_entrances ||
+		memcmp(found, entrances, (size_t)count);
+	*num_entrances = count;
+	memcpy(entrances, found, (size_t)count);
+
+	return changed;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLHpa_Mark(RLPathHierarchy *this, int cluster, RLHpaState state)
+{
+	if (this->states[cluster] == RLHPA_CLEAN) {
+		this->pending[this->num_pending++] = cluster;
+	}
+	this->states[cluster] = (uint8_t)MAX(this->states[cluster], state);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLHpa_MarkRect(RLPathHierarchy *this, int x, int y, int w, int h)
+{
+	const int left = MAX(x, 0), top = MAX(y, 0);
+	const int right = MIN(x + w, this->map->size.width);
+	const int bottom = MIN(y + h, this->map->size.height);
+
+	for (int cy = top; cy < bottom;
+		cy = (cy / this->cluster_size + 1) * this->cluster_size) {
+		for (int cx = left; cx < right;
+			cx = (cx / this->cluster_size + 1) * this->cluster_size) {
+			RLHpa_Mark(this, RLHpa_ClusterOf(this, cy * this->width + cx),
+				RLHPA_CELLS);
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Marks the clusters written by the map changes since the last
+///			sync
+///
+/// \return	false if the map no longer logs one of the changes
+///////////////////////////////////////////////////////////////////////////////
+static bool RLHpa_Replay(RLPathHierarchy *this)
+{
+	const uint32_t latest = this->map->versions[RLMAP_WALKABLE];
+
+	if (latest - this->version > RLMAP_CHANGES) {
+		return false;
+	}
+
+	for (uint32_t version = this->version + 1; version != latest + 1;
+		++version) {
+		const RLMapChange *change = RLMapGrid_GetChange(this->map,
+			RLMAP_WALKABLE, version);
+
+		if (!change) {
+			return false;
+		}
+		RLHpa_MarkRect(this, change->x, change->y, change->w, change->h);
+	}
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLHpa_UpdateBorders(RLPathHierarchy *this, int cluster)
+{
+	const int cx = cluster % this->clusters_per_row;
+	const int cy = cluster / this->clusters_per_row;
+	const int rows = this->num_clusters / this->clusters_per_row;
+	const int below = cluster + this->clusters_per_row;
+	const int above = cluster - this->clusters_per_row;
+
+	// A moved entrance changes the nodes of the cluster across the border
+	if (cx + 1 < this->clusters_per_row &&
+		RLHpa_UpdateBorder(this, RLHPA_VERTICAL, cluster)) {
+		RLHpa_Mark(this, cluster + 1, RLHPA_ENTRANCES);
+	}
+	if (cx > 0 && RLHpa_UpdateBorder(this, RLHPA_VERTICAL, cluster - 1)) {
+		RLHpa_Mark(this, cluster - 1, RLHPA_ENTRANCES);
+	}
+	if (cy + 1 < rows && RLHpa_UpdateBorder(this, RLHPA_HORIZONTAL, cluster)) {
+		RLHpa_Mark(this, below, RLHPA_ENTRANCES);
+	}
+	if (cy > 0 && RLHpa_UpdateBorder(this, RLHPA_HORIZONTAL, above)) {
+		RLHpa_Mark(this, above, RLHPA_ENTRANCES);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLHpa_Rebuild(RLPathHierarchy *this, int cluster)
+{
+	RLHpaCluster *c = &this->clusters[cluster];
+	const RLHpaRect rect = RLHpa_GetRect(this, cluster);
+	const int cx = cluster % this->clusters_per_row;
+	const int cy = cluster / this->clusters_per_row;
+	const int rows = this->num_clusters / this->clusters_per_row;
+	const int size = this->cluster_size, width = this->width;
+	const int west = cluster - 1, north = cluster - this->clusters_per_row;
+	const uint8_t *vertical = this->entrances[RLHPA_VERTICAL];
+	const uint8_t *horizontal = this->entrances[RLHPA_HORIZONTAL];
+	int *cells = this->node_cells + (size_t)cluster * (size_t)this->slots;
+	const int counts[RLHPA_NUM_SIDES] = {
+		cx + 1 < this->clusters_per_row ?
+			this->num_entrances[RLHPA_VERTICAL][cluster] : 0,
+		cx > 0 ? this->num_entrances[RLHPA_VERTICAL][west] : 0,
+		cy + 1 < rows ? this->num_entrances[RLHPA_HORIZONTAL][cluster] : 0,
+		cy > 0 ? this->num_entrances[RLHPA_HORIZONTAL][north] : 0
+	};
+	int n;
+
+	c->offsets[0] = 0;
+	for (int i = 0; i < RLHPA_NUM_SIDES; ++i) {
+		c->offsets[i + 1] = c->offsets[i] + counts[i];
+	}
+	n = c->offsets[RLHPA_NUM_SIDES];
+
+	for (int k = 0; k < counts[RLHPA_EAST]; ++k) {
+		cells[c->offsets[RLHPA_EAST] + k] =
+			(rect.y + vertical[cluster * size + k]) * width +
+			rect.x + rect.width - 1;
+	}
+	for (int k = 0; k < counts[RLHPA_WEST]; ++k) {
+		cells[c->offsets[RLHPA_WEST] + k] =
+			(rect.y + vertical[west * size + k]) * width + rect.x;
+	}
+	for (int k = 0; k < counts[RLHPA_SOUTH]; ++k) {
+		cells[c->offsets[RLHPA_SOUTH] + k] =
+			(rect.y + rect.height - 1) * width +
+			rect.x + horizontal[cluster * size + k];
+	}
+	for (int k = 0; k < counts[RLHPA_NORTH]; ++k) {
+		cells[c->offsets[RLHPA_NORTH] + k] =
+			rect.y * width + rect.x + horizontal[north * size + k];
+	}
+
+	c->costs = g_renew(int, c->costs, (gsize)MAX(n * n, 1));
+	for (int i = 0; i < n; ++i) {
+		RLHpa_Search(this, &rect, cells[i], RLHPA_NONE);
+		for (int j = 0; j < n; ++j) {
+			const int d = this->distances[RLHpa_Local(this, &rect, cells[j])];
+			c->costs[i * n + j] = d == RLHPA_UNREACHED ? -1 : d;
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLHpa_Update(RLPathHierarchy *this)
+{
+	int num_changed;
+
+	if (this->version != this->map->versions[RLMAP_WALKABLE] &&
+		!RLHpa_Replay(this)) {
+		for (int i = 0; i < this->num_clusters; ++i) {
+			RLHpa_Mark(this, i, RLHPA_CELLS);
+		}
+	}
+	this->version = this->map->versions[RLMAP_WALKABLE];
+
+	// Borders first, as they add the neighbours to rebuild
+	num_changed = this->num_pending;
+	for (int i = 0; i < num_changed; ++i) {
+		if (this->states[this->pending[i]] == RLHPA_CELLS) {
+			RLHpa_UpdateBorders(this, this->pending[i]);
+		}
+	}
+	for (int i = 0; i < this->num_pending; ++i) {
+		RLHpa_Rebuild(this, this->pending[i]);
+		this->states[this->pending[i]] = RLHPA_CLEAN;
+	}
+	this->rebuilt = this->num_pending;
+	this->num_pending = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static int RLHpa_NodeCell(const RLPathHierarchy *this, int node)
+{
+	const int first = this->num_clusters * this->slots;
+
+	if (node == first) {
+		return this->start;
+	}
+	else if (node == first + 1) {
+		return this->goal;
+	}
+
+	return this->node_cells[node];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static int RLHpa_Twin(const RLPathHierarchy *this, int node)
+{
+	const int steps[RLHPA_NUM_SIDES] = {
+		1, -1, this->clusters_per_row, -this->clusters_per_row
+	};
+	const int cluster = node / this->slots, i = node % this->slots;
+	const RLHpaCluster *c = &this->clusters[cluster];
+	int side = RLHPA_EAST, neighbour;
+
+	while (i >= c->offsets[side + 1]) {
+		++side;
+	}
+	neighbour = cluster + steps[side];
+
+	return neighbour * this->slots +
+		this->clusters[neighbour].offsets[side ^ 1] + i - c->offsets[side];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLHpa_Place(RLPathHierarchy *this, int i, RLHpaEntry entry)
+{
+	this->heap[i] = entry;
+	this->nodes[entry.node].heap = i;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLHpa_SiftUp(RLPathHierarchy *this, int i)
+{
+	const RLHpaEntry entry = this->heap[i];
+
+	while (i > 0 && entry.key < this->heap[(i - 1) / 2].key) {
+		RLHpa_Place(this, i, this->heap[(i - 1) / 2]);
+		i = (i - 1) / 2;
+	}
+	RLHpa_Place(this, i, entry);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static int RLHpa_Pop(RLPathHierarchy *this)
+{
+	const int node = this->heap[0].node;
+	const RLHpaEntry last = this->heap[--this->heap_size];
+	int i = 0;
+
+	// Sift the last entry down from the root
+	while (2 * i + 1 < this->heap_size) {
+		int child = 2 * i + 1;
+		if (child + 1 < this->heap_size &&
+			this->heap[child + 1].key < this->heap[child].key) {
+			++child;
+		}
+		if (last.key <= this->heap[child].key) {
+			break;
+		}
+		RLHpa_Place(this, i, this->heap[child]);
+		i = child;
+	}
+	if (this->heap_size) {
+		RLHpa_Place(this, i, last);
+	}
+
+	this->nodes[node].heap = RLHPA_CLOSED;
+	return node;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLHpa_Relax(RLPathHierarchy *this, int parent, int i, int g)
+{
+	RLHpaNode *node = &this->nodes[i];
+	const int cell = RLHpa_NodeCell(this, i);
+	const int f = g + RLHpa_Distance(
+		this->goal % this->width - cell % this->width,
+		this->goal / this->width - cell / this->width
+		);
+	const RLHpaEntry entry = {
+		(uint64_t)f << 32 | (uint32_t)(INT32_MAX - g),
+		i
+	};
+
+	if (node->generation != this->generation) {
+		node->generation = this->generation;
+		node->heap = this->heap_size++;
+	}
+	else if (node->heap == RLHPA_CLOSED || g >= node->g) {
+		// The heuristic is consistent, so expanded nodes are final
+		return;
+	}
+
+	node->g = g;
+	node->parent = parent;
+	this->heap[node->heap] = entry;
+	RLHpa_SiftUp(this, node->heap);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLHpa_Expand(RLPathHierarchy *this, int node)
+{
+	const int first = this->num_clusters * this->slots;
+	const int g = this->nodes[node].g;
+	int cluster, i, n;
+	const int *costs = NULL;
+
+	if (node == first) {
+		cluster = RLHpa_ClusterOf(this, this->start);
+		n = this->clusters[cluster].offsets[RLHPA_NUM_SIDES];
+		for (int j = 0; j < n; ++j) {
+			if (this->start_costs[j] >= 0) {
+				RLHpa_Relax(this, node, cluster * this->slots + j,
+					g + this->start_costs[j]);
+			}
+		}
+		if (this->direct >= 0) {
+			RLHpa_Relax(this, node, first + 1, g + this->direct);
+		}
+		return;
+	}
+
+	cluster = node / this->slots;
+	i = node % this->slots;
+	n = this->clusters[cluster].offsets[RLHPA_NUM_SIDES];
+	costs = this->clusters[cluster].costs + i * n;
+	for (int j = 0; j < n; ++j) {
+		if (j != i && costs[j] >= 0) {
+			RLHpa_Relax(this, node, cluster * this->slots + j, g + costs[j]);
+		}
+	}
+	RLHpa_Relax(this, node, RLHpa_Twin(this, node), g + RLPATH_COST_STRAIGHT);
+	if (cluster == RLHpa_ClusterOf(this, this->goal) &&
+		this->goal_costs[i] >= 0) {
+		RLHpa_Relax(this, node, first + 1, g + this->goal_costs[i]);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLHpa_Connect(RLPathHierarchy *this, int cell, int *costs)
+{
+	const int cluster = RLHpa_ClusterOf(this, cell);
+	const RLHpaRect rect = RLHpa_GetRect(this, cluster);
+	const int *cells = this->node_cells +
+		(size_t)cluster * (size_t)this->slots;
+
+	RLHpa_Search(this, &rect, cell, RLHPA_NONE);
+	for (int j = 0; j < this->clusters[cluster].offsets[RLHPA_NUM_SIDES];
+		++j) {
+		const int d = this->distances[RLHpa_Local(this, &rect, cells[j])];
+		costs[j] = d == RLHPA_UNREACHED ? -1 : d;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static bool RLHpa_Leg(RLPathHierarchy *this)
+{
+	const int from = this->route[this->leg], to = this->route[this->leg + 1];
+	const int cluster = RLHpa_ClusterOf(this, from);
+	const RLHpaRect rect = RLHpa_GetRect(this, cluster);
+	int local, length = 0;
+
+	this->step = 0;
+	this->num_steps = 0;
+
+	// Legs between clusters are a single step across the border
+	if (cluster != RLHpa_ClusterOf(this, to)) {
+		if (!RLHpa_Open(this, to % this->width, to / this->width)) {
+			return false;
+		}
+		this->steps[this->num_steps++] = to;
+		return true;
+	}
+
+	RLHpa_Search(this, &rect, from, to);
+	local = RLHpa_Local(this, &rect, to);
+	if (this->distances[local] == RLHPA_UNREACHED) {
+		return false;
+	}
+
+	for (int i = local; this->parents[i] != RLHPA_NONE; i = this->parents[i]) {
+		++length;
+	}
+	this->num_steps = length;
+	for (int i = local; this->parents[i] != RLHPA_NONE; i = this->parents[i]) {
+		this->steps[--length] = (rect.y + i / rect.width) * this->width +
+			rect.x + i % rect.width;
+	}
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Public functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+RLPathHierarchy * RLPathHierarchy_Create(const RLMapGrid *map,
+	int cluster_size)
+{
+	RLPathHierarchy *this = NULL;
+	int rows, total, cells;
+
+	if (!map) {
+		log_warn("NULL argument");
+		return NULL;
+	}
+	if (cluster_size < RLHPA_MIN_CLUSTER || cluster_size > RLHPA_MAX_CLUSTER) {
+		logfmt_warn("Invalid cluster size %d", cluster_size);
+		return NULL;
+	}
+
+	this = g_new0(RLPathHierarchy, 1);
+	this->map = map;
+	this->width = map->size.width;
+	this->cluster_size = cluster_size;
+	this->clusters_per_row = (map->size.width + cluster_size - 1) /
+		cluster_size;
+	rows = (map->size.height + cluster_size - 1) / cluster_size;
+	this->num_clusters = this->clusters_per_row * rows;
+	this->slots = RLHPA_NUM_SIDES * cluster_size;
+	total = this->num_clusters * this->slots;
+	cells = cluster_size * cluster_size;
+
+	this->clusters = g_new0(RLHpaCluster, (gsize)this->num_clusters);
+	this->node_cells = g_new(int, (gsize)total);
+	for (int i = 0; i < RLHPA_NUM_BORDERS; ++i) {
+		this->num_entrances[i] = g_new0(int, (gsize)this->num_clusters);
+		this->entrances[i] = g_new0(uint8_t, (gsize)total / RLHPA_NUM_SIDES);
+	}
+	this->states = g_new0(uint8_t, (gsize)this->num_clusters);
+	this->pending = g_new(int, (gsize)this->num_clusters);
+	this->distances = g_new(int, (gsize)cells);
+	this->parents = g_new(int, (gsize)cells);
+	// Every cell is pushed once, and again at most once per neighbour
+	this->links = g_new(RLHpaLink, (gsize)(8 * cells + 1));
+	this->nodes = g_new0(RLHpaNode, (gsize)total + 2);
+	this->heap = g_new(RLHpaEntry, (gsize)total + 2);
+	this->start_costs = g_new(int, (gsize)this->slots);
+	this->goal_costs = g_new(int, (gsize)this->slots);
+	this->route = g_new(int, (gsize)total + 2);
+	this->steps = g_new(int, (gsize)cells);
+
+	this->version = map->versions[RLMAP_WALKABLE] + 1;
+	RLHpa_Update(this);
+
+	return this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLPathHierarchy_Invalidate(RLPathHierarchy *this, int x, int y, int w,
+	int h)
+{
+	const uint32_t latest = this ?
+		this->map->versions[RLMAP_WALKABLE] : 0;
+
+	if (!this) {
+		log_warn("NULL argument");
+		return;
+	}
+
+	RLHpa_MarkRect(this, x, y, w, h);
+
+	// A single change the map did not log is the one reported here, more
+	// than one leaves the version behind so the next query rebuilds every
+	// cluster
+	if (latest - this->version == 1 &&
+		!RLMapGrid_GetChange(this->map, RLMAP_WALKABLE, latest)) {
+		this->version = latest;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int RLPathHierarchy_Find(RLPathHierarchy *this, int start_x, int start_y,
+	int goal_x, int goal_y)
+{
+	int first, length = 0;
+
+	if (!this) {
+		log_warn("NULL argument");
+		return -1;
+	}
+
+	this->route_length = 0;
+	this->expanded = 0;
+	this->rebuilt = 0;
+	if (!RLHpa_Open(this, start_x, start_y) ||
+		!RLHpa_Open(this, goal_x, goal_y)) {
+		return -1;
+	}
+
+	RLHpa_Update(this);
+	first = this->num_clusters * this->slots;
+
+	// Bumping the generation forgets every node, clear them once it wraps
+	if (!++this->generation) {
+		memset(this->nodes, 0, sizeof(RLHpaNode) * (size_t)(first + 2));
+		this->generation = 1;
+	}
+
+	// The start and goal join the graph through their own clusters
+	this->start = start_y * this->width + start_x;
+	this->goal = goal_y * this->width + goal_x;
+	RLHpa_Connect(this, this->start, this->start_costs);
+	this->direct = -1;
+	if (RLHpa_ClusterOf(this, this->start) ==
+		RLHpa_ClusterOf(this, this->goal)) {
+		const RLHpaRect rect = RLHpa_GetRect(this,
+			RLHpa_ClusterOf(this, this->goal));
+		const int d = this->distances[RLHpa_Local(this, &rect, this->goal)];
+
+		this->direct = d == RLHPA_UNREACHED ? -1 : d;
+	}
+	RLHpa_Connect(this, this->goal, this->goal_costs);
+
+	this->heap_size = 0;
+	RLHpa_Relax(this, RLHPA_NONE, first, 0);
+	while (this->heap_size) {
+		const int node = RLHpa_Pop(this);
+
+		++this->expanded;
+		if (node != first + 1) {
+			RLHpa_Expand(this, node);
+			continue;
+		}
+
+		for (int i = node; i != RLHPA_NONE; i = this->nodes[i].parent) {
+			++length;
+		}
+		this->route_length = length;
+		for (int i = node; i != RLHPA_NONE; i = this->nodes[i].parent) {
+			this->route[--length] = RLHpa_NodeCell(this, i);
+		}
+		this->leg = 0;
+		this->step = 0;
+		this->num_steps = 0;
+
+		return this->nodes[node].g;
+	}
+
+	return -1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int RLPathHierarchy_Refine(RLPathHierarchy *this, RLPathPoint *path,
+	int max_points)
+{
+	int written = 0;
+
+	if (!this || !path) {
+		log_warn("NULL argument");
+		return -1;
+	}
+	if (!this->route_length) {
+		return -1;
+	}
+
+	while (written < max_points) {
+		int cell;
+
+		if (this->step == this->num_steps) {
+			if (this->leg + 1 >= this->route_length) {
+				break;
+			}
+			if (!RLHpa_Leg(this)) {
+				this->route_length = 0;
+				return written ? written : -1;
+			}
+			++this->leg;
+			continue;
+		}
+
+		cell = this->steps[this->step++];
+		path[written++] = (RLPathPoint){
+			cell % this->width,
+			cell / this->width
+		};
+	}
+
+	return written;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int RLPathHierarchy_GetExpanded(const RLPathHierarchy *this)
+{
+	if (!this) {
+		log_warn("NULL argument");
+		return 0;
+	}
+
+	return this->expanded;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int RLPathHierarchy_GetRebuilt(const RLPathHierarchy *this)
+{
+	if (!this) {
+		log_warn("NULL argument");
+		return 0;
+	}
+
+	return this->rebuilt;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLPathHierarchy_Destroy(RLPathHierarchy *this)
+{
+	if (CONDBIND(this, log_warn, "NULL argument")) {
+		for (int i = 0; i < this->num_clusters; ++i) {
+			g_free(this->clusters[i].costs);
+		}
+		g_free(this->clusters);
+		g_free(this->node_cells);
+		for (int i = 0; i < RLHPA_NUM_BORDERS; ++i) {
+			g_free(this->num_entrances[i]);
+			g_free(this->entrances[i]);
+		}
+		g_free(this->states);
+		g_free(this->pending);
+		g_free(this->distances);
+		g_free(this->parents);
+		g_free(this->links);
+		g_free(this->nodes);
+		g_free(this->heap);
+		g_free(this->start_costs);
+		g_free(this->goal_costs);
+		g_free(this->route);
+		g_free(this->steps);
+		g_free(this);
+	}
+}
@@ -0,0 +1,139 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	hpa.h
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Hierarchical pathfinding over a map's walkable plane, for long
+///			trips across large maps
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef HPA_H
+#define HPA_H
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include "mapgrid.h"
+#include "path.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+// Range of cluster sizes, a cluster border fits in one 64-cell word
+#define RLHPA_MIN_CLUSTER 4
+#define RLHPA_MAX_CLUSTER 64
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+typedef struct _RLPathHierarchy RLPathHierarchy;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns a pointer to a new RLPathHierarchy
+///
+/// The map is cut into square clusters. Where a run of walkable cells
+/// crosses between two clusters, an entrance is placed in its middle, or
+/// one at each end of runs six cells or longer. The cost of walking
+/// between every two entrances of a cluster without leaving it is
+/// computed up front, and queries search the graph of entrances instead
+/// of the cells.
+///
+/// The map must outlive the RLPathHierarchy, its size must not change.
+///
+/// \param	map				Map whose RLMAP_WALKABLE plane gives the passable
+///							cells
+/// \param	cluster_size	Width and height of a cluster in cells, between
+///							RLHPA_MIN_CLUSTER and RLHPA_MAX_CLUSTER
+///
+/// \return	Pointer to the new RLPathHierarchy, NULL if the size is out of
+///			range
+///////////////////////////////////////////////////////////////////////////////
+RLPathHierarchy * RLPathHierarchy_Create(const RLMapGrid *map,
+	int cluster_size);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Marks the clusters over a rectangle of edited cells for
+///			rebuilding
+///
+/// Only the marked clusters, and neighbours whose shared entrances moved,
+/// are rebuilt by the next query. Changes made with RLMapGrid_SetBit,
+/// RLMapGrid_FillBits or RLMapGrid_Changed need no call, as the next query
+/// marks the clusters they wrote from the map's change log, so a room dug
+/// one RLMapGrid_SetBit at a time stays incremental. Past RLMAP_CHANGES
+/// changes since the last query, every cluster is rebuilt. A version
+/// bumped by hand must be reported here, and is only accounted for when it
+/// was the sole change since the last query.
+///
+/// \param	this	An RLPathHierarchy
+/// \param	x		Left column of the rectangle
+/// \param	y		Top row of the rectangle
+/// \param	w		Width of the rectangle in cells
+/// \param	h		Height of the rectangle in cells
+///////////////////////////////////////////////////////////////////////////////
+void RLPathHierarchy_Invalidate(RLPathHierarchy *this, int x, int y, int w,
+	int h);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Plans a route between two cells through the cluster entrances
+///
+/// The route is kept as the entrances it passes, and turned into steps by
+/// RLPathHierarchy_Refine one cluster at a time. It follows the same moves
+/// as RLPathFinder_Find and is close to, though not always, the shortest.
+/// Unlike RLPathFinder_Find, the start must be walkable.
+///
+/// \param	this	An RLPathHierarchy
+/// \param	start_x	Column of the start
+/// \param	start_y	Row of the start
+/// \param	goal_x	Column of the goal
+/// \param	goal_y	Row of the goal
+///
+/// \return	Cost of the route in RLPATH_COST_STRAIGHT and
+///			RLPATH_COST_DIAGONAL units, -1 if there is none
+///////////////////////////////////////////////////////////////////////////////
+int RLPathHierarchy_Find(RLPathHierarchy *this, int start_x, int start_y,
+	int goal_x, int goal_y);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Writes the next steps of the planned route
+///
+/// Each call continues where the last one stopped, searching the cells of
+/// a cluster only when the route enters it. A leg blocked since the route
+/// was planned ends it, plan again from where the walker stands.
+///
+/// \param	this		An RLPathHierarchy
+/// \param	path		Destination for the steps
+/// \param	max_points	Number of steps path has room for
+///
+/// \return	Number of steps written, 0 once the goal is reached, -1 if the
+///			route is blocked or none is planned
+///////////////////////////////////////////////////////////////////////////////
+int RLPathHierarchy_Refine(RLPathHierarchy *this, RLPathPoint *path,
+	int max_points);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns the number of entrances the last query expanded
+///
+/// \param	this	An RLPathHierarchy
+///
+/// \return	Number of entrances taken off the open list
+///////////////////////////////////////////////////////////////////////////////
+int RLPathHierarchy_GetExpanded(const RLPathHierarchy *this);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns the number of clusters the last query rebuilt
+///
+/// \param	this	An RLPathHierarchy
+///
+/// \return	Number of clusters brought up to date with the map
+///////////////////////////////////////////////////////////////////////////////
+int RLPathHierarchy_GetRebuilt(const RLPathHierarchy *this);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Frees the memory associated with an RLPathHierarchy
+///
+/// \param	this	An RLPathHierarchy
+///////////////////////////////////////////////////////////////////////////////
+void RLPathHierarchy_Destroy(RLPathHierarchy *this);
+
+#endif
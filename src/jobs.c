@@ -0,0 +1,431 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	jobs.c
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Work-stealing job system, a worker thread per core beside the
+///			main thread
+///////////////////////////////////////////////////////////////////////////////
+
+#include "jobs.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdbool.h>
+#include <glib.h>
+
+#include "common.h"
+#include "log.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+#define RLJOB_QUEUE_MASK (RLJOB_QUEUE_SIZE - 1)
+
+// Rounds of failed steals a worker yields through before it sleeps
+#define RLJOB_SPINS 64
+
+// Slices per thread RLJobSystem_ParallelFor cuts a range into by default
+#define RLJOB_SLICES 4
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+	RLJobFunc func;
+	RLJobRangeFunc range;
+	void *data;
+	int begin;
+	int end;
+	RLJobCounter *counter;
+} RLJob;
+
+///////////////////////////////////////////////////////////////////////////////
+/// Chase-Lev deque. The owner pushes and pops at the bottom, thieves take
+/// from the top. The memory orders are those of Le et al., "Correct and
+/// Efficient Work-Stealing for Weak Memory Models". The ends are padded
+/// onto separate cache lines.
+///////////////////////////////////////////////////////////////////////////////
+typedef struct {
+	atomic_long top;
+	char top_padding[64 - sizeof(atomic_long)];
+	atomic_long bottom;
+	char bottom_padding[64 - sizeof(atomic_long)];
+	_Atomic(RLJob *) jobs[RLJOB_QUEUE_SIZE];
+} RLJobQueue;
+
+typedef struct {
+	RLJobSystem *system;
+	GThread *thread;
+	// State of the generator picking whom to steal from
+	uint32_t seed;
+	RLJobQueue queue;
+} RLJobWorker;
+
+struct _RLJobSystem {
+	int num_threads;
+	// The main thread's first, then one per worker thread
+	RLJobWorker *workers;
+	// Jobs queued and not yet taken, workers sleep while there are none
+	atomic_int queued;
+	atomic_int sleeping;
+	atomic_bool quit;
+	GMutex lock;
+	GCond wake;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static variables
+///////////////////////////////////////////////////////////////////////////////
+
+// RLJobWorker of the calling thread
+static GPrivate current = G_PRIVATE_INIT(NULL);
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+static bool RLJob_Push(RLJobQueue *queue, RLJob *job)
+{
+	const long b = atomic_load_explicit(&queue->bottom, memory_order_relaxed);
+	const long t = atomic_load_explicit(&queue->top, memory_order_acquire);
+
+	if (b - t >= RLJOB_QUEUE_SIZE) {
+		return false;
+	}
+
+	atomic_store_explicit(&queue->jobs[b & RLJOB_QUEUE_MASK], job,
+		memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+	atomic_store_explicit(&queue->bottom, b + 1, memory_order_relaxed);
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static RLJob * RLJob_Pop(RLJobQueue *queue)
+{
+	const long b = atomic_load_explicit(&queue->bottom,
+		memory_order_relaxed) - 1;
+	RLJob *job = NULL;
+	long t;
+
+	atomic_store_explicit(&queue->bottom, b, memory_order_relaxed);
+	atomic_thread_fence(memory_order_seq_cst);
+	t = atomic_load_explicit(&queue->top, memory_order_relaxed);
+
+	if (t <= b) {
+		job = atomic_load_explicit(&queue->jobs[b & RLJOB_QUEUE_MASK],
+			memory_order_relaxed);
+		if (t == b) {
+			// The last job, thieves may be after it too
+			if (!atomic_compare_exchange_strong_explicit(&queue->top, &t,
+				t + 1, memory_order_seq_cst, memory_order_relaxed)) {
+				job = NULL;
+			}
+			atomic_store_explicit(&queue->bottom, b + 1,
+				memory_order_relaxed);
+		}
+	}
+	else {
+		atomic_store_explicit(&queue->bottom, b + 1, memory_order_relaxed);
+	}
+
+	return job;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static RLJob * RLJob_Steal(RLJobQueue *queue)
+{
+	long t = atomic_load_explicit(&queue->top, memory_order_acquire);
+	long b;
+
+	atomic_thread_fence(memory_order_seq_cst);
+	b = atomic_load_explicit(&queue->bottom, memory_order_acquire);
+
+	if (t < b) {
+		RLJob *job = atomic_load_explicit(&queue->jobs[t & RLJOB_QUEUE_MASK],
+			memory_order_relaxed);
+
+		// Losing the race to the owner or another thief gives up the job
+		if (atomic_compare_exchange_strong_explicit(&queue->top, &t, t + 1,
+			memory_order_seq_cst, memory_order_relaxed)) {
+			return job;
+		}
+	}
+
+	return NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static RLJob * RLJob_Take(RLJobSystem *this, RLJobWorker *worker)
+{
+	RLJob *job = RLJob_Pop(&worker->queue);
+
+	// Otherwise try every other queue once, from a random one on
+	if (!job) {
+		int start;
+
+		worker->seed ^= worker->seed << 13;
+		worker->seed ^= worker->seed >> 17;
+		worker->seed ^= worker->seed << 5;
+		start = (int)(worker->seed % (uint32_t)this->num_threads);
+		for (int i = 0; i < this->num_threads && !job; ++i) {
+			RLJobWorker *victim =
+				&this->workers[(start + i) % this->num_threads];
+
+			if (victim != worker) {
+				job = RLJob_Steal(&victim->queue);
+			}
+		}
+	}
+
+	if (job) {
+		atomic_fetch_sub(&this->queued, 1);
+	}
+	return job;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLJob_Run(RLJob *job)
+{
+	if (job->range) {
+		job->range(job->data, job->begin, job->end);
+	}
+	else {
+		job->func(job->data);
+	}
+
+	if (job->counter) {
+		atomic_fetch_sub_explicit(&job->counter->pending, 1,
+			memory_order_release);
+	}
+	g_free(job);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLJob_Queue(RLJobSystem *this, RLJob *job)
+{
+	RLJobWorker *worker = g_private_get(&current);
+
+	if (job->counter) {
+		atomic_fetch_add_explicit(&job->counter->pending, 1,
+			memory_order_relaxed);
+	}
+
+	// Counted before it is visible, so a thief never takes the count
+	// below zero
+	atomic_fetch_add(&this->queued, 1);
+	if (!worker || worker->system != this ||
+		!RLJob_Push(&worker->queue, job)) {
+		atomic_fetch_sub(&this->queued, 1);
+		RLJob_Run(job);
+		return;
+	}
+
+	// Sleepers count themselves under the lock before checking queued, so
+	// either they see the job or this sees them
+	if (atomic_load(&this->sleeping)) {
+		g_mutex_lock(&this->lock);
+		g_cond_signal(&this->wake);
+		g_mutex_unlock(&this->lock);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static gpointer RLJob_Work(gpointer data)
+{
+	RLJobWorker *worker = data;
+	RLJobSystem *this = worker->system;
+	int idle = 0;
+
+	g_private_set(&current, worker);
+
+	while (!atomic_load(&this->quit)) {
+		RLJob *job = RLJob_Take(this, worker);
+
+		if (job) {
+			RLJob_Run(job);
+			idle = 0;
+			continue;
+		}
+		if (++idle < RLJOB_SPINS) {
+			g_thread_yield();
+			continue;
+		}
+
+		g_mutex_lock(&this->lock);
+		atomic_fetch_add(&this->sleeping, 1);
+		while (atomic_load(&this->queued) <= 0 && !atomic_load(&this->quit)) {
+			g_cond_wait(&this->wake, &this->lock);
+		}
+		atomic_fetch_sub(&this->sleeping, 1);
+		g_mutex_unlock(&this->lock);
+		idle = 0;
+	}
+
+	return NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Public functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+RLJobSystem * RLJobSystem_Create(int num_workers)
+{
+	RLJobSystem *this = NULL;
+
+	if (num_workers < 0) {
+		num_workers = MAX((int)g_get_num_processors() - 1, 0);
+	}
+
+	this = g_new0(RLJobSystem, 1);
+	this->num_threads = num_workers + 1;
+	this->workers = g_new0(RLJobWorker, (gsize)this->num_threads);
+	atomic_init(&this->queued, 0);
+	atomic_init(&this->sleeping, 0);
+	atomic_init(&this->quit, false);
+	g_mutex_init(&this->lock);
+	g_cond_init(&this->wake);
+
+	for (int i = 0; i < this->num_threads; ++i) {
+		RLJobWorker *worker = &this->workers[i];
+
+		worker->system = this;
+		worker->seed = (uint32_t)(i + 1) * 2654435761u;
+		atomic_init(&worker->queue.top, 0);
+		atomic_init(&worker->queue.bottom, 0);
+	}
+
+	g_private_set(&current, &this->workers[0]);
+	for (int i = 1; i < this->num_threads; ++i) {
+		this->workers[i].thread = g_thread_new(
+			"worker",
+			RLJob_Work,
+			&this->workers[i]
+			);
+	}
+
+	return this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int RLJobSystem_GetNumThreads(const RLJobSystem *this)
+{
+	if (!this) {
+		log_warn("NULL argument");
+		return 0;
+	}
+
+	return this->num_threads;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLJobSystem_Submit(RLJobSystem *this, RLJobFunc func, void *data,
+	RLJobCounter *counter)
+{
+	RLJob *job = NULL;
+
+	if (!this || !func) {
+		log_warn("NULL argument");
+		return;
+	}
+
+	job = g_new(RLJob, 1);
+	*job = (RLJob){func, NULL, data, 0, 0, counter};
+	RLJob_Queue(this, job);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLJobSystem_Wait(RLJobSystem *this, RLJobCounter *counter)
+{
+	RLJobWorker *worker = NULL;
+
+	if (!this || !counter) {
+		log_warn("NULL argument");
+		return;
+	}
+
+	worker = g_private_get(&current);
+	if (worker && worker->system != this) {
+		worker = NULL;
+	}
+
+	while (atomic_load_explicit(&counter->pending, memory_order_acquire)) {
+		RLJob *job = worker ? RLJob_Take(this, worker) : NULL;
+
+		if (job) {
+			RLJob_Run(job);
+		}
+		else {
+			g_thread_yield();
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLJobSystem_ParallelFor(RLJobSystem *this, int begin, int end, int grain,
+	RLJobRangeFunc func, void *data)
+{
+	RLJobCounter counter = {0};
+
+	if (!this || !func) {
+		log_warn("NULL argument");
+		return;
+	}
+	if (begin >= end) {
+		return;
+	}
+
+	if (grain <= 0) {
+		const int slices = this->num_threads * RLJOB_SLICES;
+
+		grain = MAX((end - begin) / slices + ((end - begin) % slices > 0), 1);
+	}
+
+	// Slices queue in order, and thieves take from the oldest end, so the
+	// calling thread works from the back of the range and thieves from
+	// the front
+	for (int i = begin; i < end; i = end - i > grain ? i + grain : end) {
+		RLJob *job = g_new(RLJob, 1);
+
+		*job = (RLJob){
+			NULL,
+			func,
+			data,
+			i,
+			end - i > grain ? i + grain : end,
+			&counter
+		};
+		RLJob_Queue(this, job);
+	}
+
+	RLJobSystem_Wait(this, &counter);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLJobSystem_Destroy(RLJobSystem *this)
+{
+	if (CONDBIND(this, log_warn, "NULL argument")) {
+		g_mutex_lock(&this->lock);
+		atomic_store(&this->quit, true);
+		g_cond_broadcast(&this->wake);
+		g_mutex_unlock(&this->lock);
+
+		for (int i = 1; i < this->num_threads; ++i) {
+			g_thread_join(this->workers[i].thread);
+		}
+		if (g_private_get(&current) == &this->workers[0]) {
+			g_private_set(&current, NULL);
+		}
+
+		g_mutex_clear(&this->lock);
+		g_cond_clear(&this->wake);
+		g_free(this->workers);
+		g_free(this);
+	}
+}
@@ -0,0 +1,122 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	jobs.h
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Work-stealing job system, a worker thread per core beside the
+///			main thread
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef JOBS_H
+#define JOBS_H
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdatomic.h>
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+// Jobs a thread can have queued at once, a power of two. Submitting past
+// it runs the job at once instead.
+#define RLJOB_QUEUE_SIZE 4096
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+typedef void (*RLJobFunc)(void *data);
+
+typedef void (*RLJobRangeFunc)(void *data, int begin, int end);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Number of submitted jobs not yet finished
+///
+/// Zero it before first use, e.g. RLJobCounter counter = {0}. Jobs that
+/// depend on others wait on the others' counter.
+///////////////////////////////////////////////////////////////////////////////
+typedef struct {
+	atomic_int pending;
+} RLJobCounter;
+
+typedef struct _RLJobSystem RLJobSystem;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns a pointer to a new RLJobSystem and starts its workers
+///
+/// The calling thread becomes the system's main thread. It and the
+/// workers each own a queue they push and pop jobs at one end of, and
+/// idle threads steal from the other end of a random queue. Workers with
+/// nothing to steal sleep until a job is submitted.
+///
+/// \param	num_workers	Number of worker threads, negative for one per core
+///						besides the main thread's
+///
+/// \return	Pointer to the new RLJobSystem
+///////////////////////////////////////////////////////////////////////////////
+RLJobSystem * RLJobSystem_Create(int num_workers);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns the number of threads running jobs, the workers and the
+///			main thread
+///
+/// \param	this	An RLJobSystem
+///
+/// \return	Number of threads
+///////////////////////////////////////////////////////////////////////////////
+int RLJobSystem_GetNumThreads(const RLJobSystem *this);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Queues a job on the calling thread
+///
+/// Only the main thread and the workers, from inside a job, can queue
+/// jobs. Other threads run the job at once.
+///
+/// \param	this	An RLJobSystem
+/// \param	func	Function the job runs
+/// \param	data	Argument to func
+/// \param	counter	Counter raised now and lowered when the job finishes,
+///					may be NULL
+///////////////////////////////////////////////////////////////////////////////
+void RLJobSystem_Submit(RLJobSystem *this, RLJobFunc func, void *data,
+	RLJobCounter *counter);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Runs queued jobs on the calling thread until a counter reaches
+///			zero
+///
+/// The thread helps with any job while it waits, so a job waiting on
+/// others it submitted cannot deadlock the system.
+///
+/// \param	this	An RLJobSystem
+/// \param	counter	Counter to wait on
+///////////////////////////////////////////////////////////////////////////////
+void RLJobSystem_Wait(RLJobSystem *this, RLJobCounter *counter);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Calls a function over consecutive slices of a range across the
+///			threads, returning when all are done
+///
+/// \param	this	An RLJobSystem
+/// \param	begin	First index of the range
+/// \param	end		Index past the last of the range
+/// \param	grain	Indices per slice, 0 or less to cut the range into a
+///					few slices per thread
+/// \param	func	Function called with each slice
+/// \param	data	First argument to func
+///////////////////////////////////////////////////////////////////////////////
+void RLJobSystem_ParallelFor(RLJobSystem *this, int begin, int end, int grain,
+	RLJobRangeFunc func, void *data);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Stops the workers and frees the memory associated with an
+///			RLJobSystem
+///
+/// No jobs may be queued or running.
+///
+/// \param	this	An RLJobSystem
+///////////////////////////////////////////////////////////////////////////////
+void RLJobSystem_Destroy(RLJobSystem *this);
+
+#endif
@@ -32,6 +32,66 @@
 
 #include <math.h>
 
+/* The matrix products and transpose have SSE (AVX for mat4x4_mul) and NEON
+ * versions, chosen at compile time from the target's instruction set, and
+ * mat4x4_invert has an SSE one. Defining LINMATH_NO_SIMD builds the scalar
+ * reference versions instead. The products add in the same order as the
+ * scalar code, so they match it exactly (up to the sign of zero) unless the
+ * compiler contracts the scalar code into fused multiply-adds. The inverse
+ * uses a different expansion and agrees to within float rounding. The lm_
+ * macros shim the intrinsics the SSE and NEON versions share.
+ *
+ * The _batch functions transform many points kept as separate coordinate
+ * arrays, two vectors of LM_WIDTH points per iteration, adding in the same
+ * order as their scalar tails. */
+#if !defined(LINMATH_NO_SIMD) && defined(__SSE__)
+#include <xmmintrin.h>
+#define LINMATH_SIMD
+#define LINMATH_SSE
+#if defined(__AVX__)
+#include <immintrin.h>
+#define LINMATH_AVX
+#endif
+typedef __m128 lm_f4;
+#define lm_load(p) _mm_loadu_ps(p)
+#define lm_store(p, v) _mm_storeu_ps(p, v)
+#define lm_splat(x) _mm_set1_ps(x)
+#define lm_add(a, b) _mm_add_ps(a, b)
+#define lm_mul(a, b) _mm_mul_ps(a, b)
+/* Lanes named first to last, the reverse of _MM_SHUFFLE */
+#define lm_shuffle(a, b, x, y, z, w) _mm_shuffle_ps(a, b, _MM_SHUFFLE(w, z, y, x))
+#define lm_swizzle(v, x, y, z, w) lm_shuffle(v, v, x, y, z, w)
+#elif !defined(LINMATH_NO_SIMD) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define LINMATH_SIMD
+#define LINMATH_NEON
+typedef float32x4_t lm_f4;
+#define lm_load(p) vld1q_f32(p)
+#define lm_store(p, v) vst1q_f32(p, v)
+#define lm_splat(x) vdupq_n_f32(x)
+#define lm_add(a, b) vaddq_f32(a, b)
+#define lm_mul(a, b) vmulq_f32(a, b)
+#endif
+
+/* The batch transforms below work LM_WIDTH floats at a time */
+#if defined(LINMATH_AVX)
+typedef __m256 lm_fw;
+#define LM_WIDTH 8
+#define lm_wload(p) _mm256_loadu_ps(p)
+#define lm_wstore(p, v) _mm256_storeu_ps(p, v)
+#define lm_wsplat(x) _mm256_set1_ps(x)
+#define lm_wadd(a, b) _mm256_add_ps(a, b)
+#define lm_wmul(a, b) _mm256_mul_ps(a, b)
+#elif defined(LINMATH_SIMD)
+typedef lm_f4 lm_fw;
+#define LM_WIDTH 4
+#define lm_wload(p) lm_load(p)
+#define lm_wstore(p, v) lm_store(p, v)
+#define lm_wsplat(x) lm_splat(x)
+#define lm_wadd(a, b) lm_add(a, b)
+#define lm_wmul(a, b) lm_mul(a, b)
+#endif
+
 #define LINMATH_H_DEFINE_VEC(n) \
 typedef float vec##n[n]; \
 static inline void vec##n##_add(vec##n r, vec##n const a, vec##n const b) \
@@ -146,10 +206,27 @@ static inline void mat4x4_col(vec4 r, mat4x4 M, int i)
 }
 static inline void mat4x4_transpose(mat4x4 M, mat4x4 N)
 {
+#if defined(LINMATH_SSE)
+	__m128 r0 = _mm_loadu_ps(N[0]), r1 = _mm_loadu_ps(N[1]);
+	__m128 r2 = _mm_loadu_ps(N[2]), r3 = _mm_loadu_ps(N[3]);
+	_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+	_mm_storeu_ps(M[0], r0);
+	_mm_storeu_ps(M[1], r1);
+	_mm_storeu_ps(M[2], r2);
+	_mm_storeu_ps(M[3], r3);
+#elif defined(LINMATH_NEON)
+	/* De-interleaving load of every fourth float is the transpose */
+	float32x4x4_t const t = vld4q_f32((float const *)N);
+	vst1q_f32(M[0], t.val[0]);
+	vst1q_f32(M[1], t.val[1]);
+	vst1q_f32(M[2], t.val[2]);
+	vst1q_f32(M[3], t.val[3]);
+#else
 	int i, j;
 	for(j=0; j<4; ++j)
 		for(i=0; i<4; ++i)
 			M[i][j] = N[j][i];
+#endif
 }
 static inline void mat4x4_add(mat4x4 M, mat4x4 a, mat4x4 b)
 {
@@ -181,6 +258,40 @@ static inline void mat4x4_scale_aniso(mat4x4 M, mat4x4 a, float x, float y, floa
 }
 static inline void mat4x4_mul(mat4x4 M, mat4x4 a, mat4x4 b)
 {
+#if defined(LINMATH_AVX)
+	/* Two columns of the product per register, each a sum of a's columns
+	 * scaled by the matching entries of b's column */
+	__m256 const a0 = _mm256_broadcast_ps((__m128 const *)a[0]);
+	__m256 const a1 = _mm256_broadcast_ps((__m128 const *)a[1]);
+	__m256 const a2 = _mm256_broadcast_ps((__m128 const *)a[2]);
+	__m256 const a3 = _mm256_broadcast_ps((__m128 const *)a[3]);
+	__m256 const b01 = _mm256_loadu_ps((float const *)b);
+	__m256 const b23 = _mm256_loadu_ps((float const *)b + 8);
+	__m256 r01 = _mm256_mul_ps(a0, _mm256_permute_ps(b01, 0x00));
+	__m256 r23 = _mm256_mul_ps(a0, _mm256_permute_ps(b23, 0x00));
+	r01 = _mm256_add_ps(r01, _mm256_mul_ps(a1, _mm256_permute_ps(b01, 0x55)));
+	r23 = _mm256_add_ps(r23, _mm256_mul_ps(a1, _mm256_permute_ps(b23, 0x55)));
+	r01 = _mm256_add_ps(r01, _mm256_mul_ps(a2, _mm256_permute_ps(b01, 0xAA)));
+	r23 = _mm256_add_ps(r23, _mm256_mul_ps(a2, _mm256_permute_ps(b23, 0xAA)));
+	r01 = _mm256_add_ps(r01, _mm256_mul_ps(a3, _mm256_permute_ps(b01, 0xFF)));
+	r23 = _mm256_add_ps(r23, _mm256_mul_ps(a3, _mm256_permute_ps(b23, 0xFF)));
+	_mm256_storeu_ps((float *)M, r01);
+	_mm256_storeu_ps((float *)M + 8, r23);
+#elif defined(LINMATH_SIMD)
+	/* Everything is read before M is written, so M may alias a or b */
+	lm_f4 const a0 = lm_load(a[0]), a1 = lm_load(a[1]);
+	lm_f4 const a2 = lm_load(a[2]), a3 = lm_load(a[3]);
+	lm_f4 r[4];
+	int c;
+	for(c=0; c<4; ++c) {
+		r[c] = lm_mul(a0, lm_splat(b[c][0]));
+		r[c] = lm_add(r[c], lm_mul(a1, lm_splat(b[c][1])));
+		r[c] = lm_add(r[c], lm_mul(a2, lm_splat(b[c][2])));
+		r[c] = lm_add(r[c], lm_mul(a3, lm_splat(b[c][3])));
+	}
+	for(c=0; c<4; ++c)
+		lm_store(M[c], r[c]);
+#else
 	mat4x4 temp;
 	int k, r, c;
 	for(c=0; c<4; ++c) for(r=0; r<4; ++r) {
@@ -189,15 +300,105 @@ static inline void mat4x4_mul(mat4x4 M, mat4x4 a, mat4x4 b)
 			temp[c][r] += a[k][r] * b[c][k];
 	}
 	mat4x4_dup(M, temp);
+#endif
 }
 static inline void mat4x4_mul_vec4(vec4 r, mat4x4 M, vec4 v)
 {
+#if defined(LINMATH_SIMD)
+	lm_f4 t = lm_mul(lm_load(M[0]), lm_splat(v[0]));
+	t = lm_add(t, lm_mul(lm_load(M[1]), lm_splat(v[1])));
+	t = lm_add(t, lm_mul(lm_load(M[2]), lm_splat(v[2])));
+	t = lm_add(t, lm_mul(lm_load(M[3]), lm_splat(v[3])));
+	lm_store(r, t);
+#else
 	int i, j;
 	for(j=0; j<4; ++j) {
 		r[j] = 0.f;
 		for(i=0; i<4; ++i)
 			r[j] += M[i][j] * v[i];
 	}
+#endif
+}
+/* Points are transformed as positions, w = 1, and the result's w dropped.
+ * Each output array may be the matching input array but must not otherwise
+ * overlap the inputs. */
+#if defined(LINMATH_SIMD)
+#define lm_wpoint3(m, j, x, y, z) lm_wadd(lm_wadd(lm_wadd(lm_wmul(m[0][j], x), \
+	lm_wmul(m[1][j], y)), lm_wmul(m[2][j], z)), m[3][j])
+#define lm_wpoint2(m, j, x, y) lm_wadd(lm_wadd(lm_wmul(m[0][j], x), \
+	lm_wmul(m[1][j], y)), m[3][j])
+#endif
+static inline void mat4x4_mul_vec3_batch(float *rx, float *ry, float *rz, mat4x4 M, float const *x, float const *y, float const *z, int n)
+{
+	int i = 0;
+#if defined(LINMATH_SIMD)
+	lm_fw m[4][3];
+	int j, k;
+	for(k=0; k<4; ++k) for(j=0; j<3; ++j)
+		m[k][j] = lm_wsplat(M[k][j]);
+	for(; i+2*LM_WIDTH<=n; i+=2*LM_WIDTH) {
+		lm_fw const x0 = lm_wload(x+i), x1 = lm_wload(x+i+LM_WIDTH);
+		lm_fw const y0 = lm_wload(y+i), y1 = lm_wload(y+i+LM_WIDTH);
+		lm_fw const z0 = lm_wload(z+i), z1 = lm_wload(z+i+LM_WIDTH);
+		lm_wstore(rx+i, lm_wpoint3(m, 0, x0, y0, z0));
+		lm_wstore(rx+i+LM_WIDTH, lm_wpoint3(m, 0, x1, y1, z1));
+		lm_wstore(ry+i, lm_wpoint3(m, 1, x0, y0, z0));
+		lm_wstore(ry+i+LM_WIDTH, lm_wpoint3(m, 1, x1, y1, z1));
+		lm_wstore(rz+i, lm_wpoint3(m, 2, x0, y0, z0));
+		lm_wstore(rz+i+LM_WIDTH, lm_wpoint3(m, 2, x1, y1, z1));
+	}
+#endif
+	for(; i<n; ++i) {
+		float const px = x[i], py = y[i], pz = z[i];
+		rx[i] = M[0][0]*px + M[1][0]*py + M[2][0]*pz + M[3][0];
+		ry[i] = M[0][1]*px + M[1][1]*py + M[2][1]*pz + M[3][1];
+		rz[i] = M[0][2]*px + M[1][2]*py + M[2][2]*pz + M[3][2];
+	}
+}
+/* 2D affine transform by the x and y rows and translation of M, z = 0 */
+static inline void mat4x4_mul_vec2_batch(float *rx, float *ry, mat4x4 M, float const *x, float const *y, int n)
+{
+	int i = 0;
+#if defined(LINMATH_SIMD)
+	lm_fw m[4][2];
+	int j, k;
+	for(k=0; k<4; ++k) for(j=0; j<2; ++j)
+		m[k][j] = lm_wsplat(M[k][j]);
+	for(; i+2*LM_WIDTH<=n; i+=2*LM_WIDTH) {
+		lm_fw const x0 = lm_wload(x+i), x1 = lm_wload(x+i+LM_WIDTH);
+		lm_fw const y0 = lm_wload(y+i), y1 = lm_wload(y+i+LM_WIDTH);
+		lm_wstore(rx+i, lm_wpoint2(m, 0, x0, y0));
+		lm_wstore(rx+i+LM_WIDTH, lm_wpoint2(m, 0, x1, y1));
+		lm_wstore(ry+i, lm_wpoint2(m, 1, x0, y0));
+		lm_wstore(ry+i+LM_WIDTH, lm_wpoint2(m, 1, x1, y1));
+	}
+#endif
+	for(; i<n; ++i) {
+		float const px = x[i], py = y[i];
+		rx[i] = M[0][0]*px + M[1][0]*py + M[3][0];
+		ry[i] = M[0][1]*px + M[1][1]*py + M[3][1];
+	}
+}
+/* r = v * s + t per axis, e.g. tile coordinates to pixels */
+static inline void vec2_scale_translate_batch(float *rx, float *ry, float const *x, float const *y, int n, float sx, float sy, float tx, float ty)
+{
+	int i = 0;
+#if defined(LINMATH_SIMD)
+	lm_fw const vsx = lm_wsplat(sx), vsy = lm_wsplat(sy);
+	lm_fw const vtx = lm_wsplat(tx), vty = lm_wsplat(ty);
+	for(; i+2*LM_WIDTH<=n; i+=2*LM_WIDTH) {
+		lm_fw const x0 = lm_wload(x+i), x1 = lm_wload(x+i+LM_WIDTH);
+		lm_fw const y0 = lm_wload(y+i), y1 = lm_wload(y+i+LM_WIDTH);
+		lm_wstore(rx+i, lm_wadd(lm_wmul(x0, vsx), vtx));
+		lm_wstore(rx+i+LM_WIDTH, lm_wadd(lm_wmul(x1, vsx), vtx));
+		lm_wstore(ry+i, lm_wadd(lm_wmul(y0, vsy), vty));
+		lm_wstore(ry+i+LM_WIDTH, lm_wadd(lm_wmul(y1, vsy), vty));
+	}
+#endif
+	for(; i<n; ++i) {
+		rx[i] = x[i]*sx + tx;
+		ry[i] = y[i]*sy + ty;
+	}
 }
 static inline void mat4x4_translate(mat4x4 T, float x, float y, float z)
 {
@@ -292,8 +493,71 @@ static inline void mat4x4_rotate_Z(mat4x4 Q, mat4x4 M, float angle)
 	};
 	mat4x4_mul(Q, M, R);
 }
+#if defined(LINMATH_SSE)
+/* 2x2 matrices held row by row in one register: A*B, adj(A)*B, A*adj(B) */
+static inline __m128 lm_mat2_mul(__m128 a, __m128 b)
+{
+	return _mm_add_ps(_mm_mul_ps(a, lm_swizzle(b, 0, 3, 0, 3)),
+		_mm_mul_ps(lm_swizzle(a, 1, 0, 3, 2), lm_swizzle(b, 2, 1, 2, 1)));
+}
+static inline __m128 lm_mat2_adj_mul(__m128 a, __m128 b)
+{
+	return _mm_sub_ps(_mm_mul_ps(lm_swizzle(a, 3, 3, 0, 0), b),
+		_mm_mul_ps(lm_swizzle(a, 1, 1, 2, 2), lm_swizzle(b, 2, 3, 0, 1)));
+}
+static inline __m128 lm_mat2_mul_adj(__m128 a, __m128 b)
+{
+	return _mm_sub_ps(_mm_mul_ps(a, lm_swizzle(b, 3, 0, 3, 0)),
+		_mm_mul_ps(lm_swizzle(a, 1, 0, 3, 2), lm_swizzle(b, 2, 1, 2, 1)));
+}
+#endif
 static inline void mat4x4_invert(mat4x4 T, mat4x4 M)
 {
+#if defined(LINMATH_SSE)
+	/* Blockwise inverse of | A B | from the adjugates of its 2x2 blocks.
+	 *                      | C D |
+	 * Inverting the transpose gives the transposed inverse, so the column
+	 * major layout needs no special handling. Assumes it is invertible. */
+	__m128 const m0 = _mm_loadu_ps(M[0]), m1 = _mm_loadu_ps(M[1]);
+	__m128 const m2 = _mm_loadu_ps(M[2]), m3 = _mm_loadu_ps(M[3]);
+	__m128 const A = _mm_movelh_ps(m0, m1), B = _mm_movehl_ps(m1, m0);
+	__m128 const C = _mm_movelh_ps(m2, m3), D = _mm_movehl_ps(m3, m2);
+
+	/* (|A|, |B|, |C|, |D|) */
+	__m128 const dets = _mm_sub_ps(
+		_mm_mul_ps(lm_shuffle(m0, m2, 0, 2, 0, 2), lm_shuffle(m1, m3, 1, 3, 1, 3)),
+		_mm_mul_ps(lm_shuffle(m0, m2, 1, 3, 1, 3), lm_shuffle(m1, m3, 0, 2, 0, 2)));
+	__m128 const det_a = lm_swizzle(dets, 0, 0, 0, 0);
+	__m128 const det_b = lm_swizzle(dets, 1, 1, 1, 1);
+	__m128 const det_c = lm_swizzle(dets, 2, 2, 2, 2);
+	__m128 const det_d = lm_swizzle(dets, 3, 3, 3, 3);
+
+	__m128 const d_c = lm_mat2_adj_mul(D, C);
+	__m128 const a_b = lm_mat2_adj_mul(A, B);
+	__m128 x = _mm_sub_ps(_mm_mul_ps(det_d, A), lm_mat2_mul(B, d_c));
+	__m128 w = _mm_sub_ps(_mm_mul_ps(det_a, D), lm_mat2_mul(C, a_b));
+	__m128 y = _mm_sub_ps(_mm_mul_ps(det_b, C), lm_mat2_mul_adj(D, a_b));
+	__m128 z = _mm_sub_ps(_mm_mul_ps(det_c, B), lm_mat2_mul_adj(A, d_c));
+
+	/* |M| = |A||D| + |B||C| - tr(adj(A)B adj(D)C), summed into every lane */
+	__m128 tr = _mm_mul_ps(a_b, lm_swizzle(d_c, 0, 2, 1, 3));
+	tr = _mm_add_ps(tr, lm_swizzle(tr, 2, 3, 0, 1));
+	tr = _mm_add_ps(tr, lm_swizzle(tr, 1, 0, 3, 2));
+	__m128 const det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(det_a, det_d),
+		_mm_mul_ps(det_b, det_c)), tr);
+	__m128 const idet = _mm_div_ps(_mm_setr_ps(1.f, -1.f, -1.f, 1.f), det);
+
+	/* Each result block is the adjugate of the one computed, which the
+	 * stores undo together with the block interleaving */
+	x = _mm_mul_ps(x, idet);
+	y = _mm_mul_ps(y, idet);
+	z = _mm_mul_ps(z, idet);
+	w = _mm_mul_ps(w, idet);
+	_mm_storeu_ps(T[0], lm_shuffle(x, y, 3, 1, 3, 1));
+	_mm_storeu_ps(T[1], lm_shuffle(x, y, 2, 0, 2, 0));
+	_mm_storeu_ps(T[2], lm_shuffle(z, w, 3, 1, 3, 1));
+	_mm_storeu_ps(T[3], lm_shuffle(z, w, 2, 0, 2, 0));
+#else
 	float s[6];
 	float c[6];
 	s[0] = M[0][0]*M[1][1] - M[1][0]*M[0][1];
@@ -332,6 +596,7 @@ static inline void mat4x4_invert(mat4x4 T, mat4x4 M)
 	T[3][1] = ( M[0][0] * c[3] - M[0][1] * c[1] + M[0][2] * c[0]) * idet;
 	T[3][2] = (-M[3][0] * s[3] + M[3][1] * s[1] - M[3][2] * s[0]) * idet;
 	T[3][3] = ( M[2][0] * s[3] - M[2][1] * s[1] + M[2][2] * s[0]) * idet;
+#endif
 }
 static inline void mat4x4_orthonormalize(mat4x4 R, mat4x4 M)
 {
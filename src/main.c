@@ -11,6 +11,8 @@
 #include <glib.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
 #include <stdbool.h>
 #include <SDL2/SDL.h>
 
@@ -23,16 +25,59 @@
 #include "common.h"
 #include "bmfont.h"
 #include "shaders.h"
+#include "tilemap.h"
+#include "quadindex.h"
+#include "display.h"
+#include "camera.h"
+#include "snapshot.h"
+#include "game.h"
+#include "timing.h"
+#include "target.h"
+#include "pngwrite.h"
+#include "profiler.h"
+#include "atlas.h"
+#include "dynatlas.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+// Longest an idle frame sleeps, so usage reports still come on time
+#define APP_WAIT_MS 1000
+#define APP_REPORT_S 60
+
+// Largest per-channel difference to a golden image still counted as equal
+#define APP_GOLDEN_TOLERANCE 2
+
+// Glyph subset written by `make atlas`, the full font is used until then
+#define APP_FONT "res/unifont"
+#define APP_FONT_SUBSET "res/unifont-subset"
+
+// Em height and texture size used when glyphs are rasterized from --ttf
+#define APP_TTF_PIXELS 16
+#define APP_TTF_ATLAS 1024
 
 ///////////////////////////////////////////////////////////////////////////////
 /// Static variables
 ///////////////////////////////////////////////////////////////////////////////
 
-static float delta = 0.0f;
 static bool running = true;
 static SDL_GLContext context;
 static SDL_Window *window = NULL;
 static const struct { int x, y; } window_size = {800, 600};
+static const struct { int x, y; } dungeon_size = {256, 256};
+static RLGame *game = NULL;
+static FrameClock *frame_clock = NULL;
+static UsageMeter usage;
+static Uint32 wake_event = (Uint32)-1;
+static bool idle = true;
+static bool dirty = true;
+static RLLayer *overlay = NULL;
+static int headless_frames = 0;
+static const char *capture_path = NULL;
+static const char *golden_path = NULL;
+static const char *ttf_path = NULL;
+static DynAtlas *glyph_cache = NULL;
 
 ///////////////////////////////////////////////////////////////////////////////
 /// Helper functions
@@ -111,7 +156,13 @@ GLuint GL_ProgramNewVarg(int num, ...)
 ///////////////////////////////////////////////////////////////////////////////
 void App_Init(void)
 {
-	if (SDL_Init(SDL_INIT_EVERYTHING)) {
+	// The offscreen driver creates its context on an EGL pbuffer, which
+	// needs no display server and works on software rasterizers
+	if (headless_frames) {
+		SDL_SetHint(SDL_HINT_VIDEODRIVER, "offscreen");
+	}
+
+	if (SDL_Init(headless_frames ? SDL_INIT_VIDEO : SDL_INIT_EVERYTHING)) {
 		log_exit("SDL2 Initialization failed");
 	}
 
@@ -129,7 +180,8 @@ void App_Init(void)
 		SDL_WINDOWPOS_CENTERED,
 		window_size.x,
 		window_size.y,
-		SDL_WINDOW_OPENGL | SDL_WINDOW_SHOWN))) {
+		SDL_WINDOW_OPENGL |
+		(headless_frames ? SDL_WINDOW_HIDDEN : SDL_WINDOW_SHOWN)))) {
 		log_exit("Window creation failed");
 	}
 	else if (!(context = SDL_GL_CreateContext(window))) {
@@ -145,7 +197,7 @@ void App_Init(void)
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 	glViewport(0, 0, window_size.x, window_size.y);
 	glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
-	SDL_GL_SetSwapInterval(1);
+	SDL_GL_SetSwapInterval(headless_frames ? 0 : 1);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -159,31 +211,283 @@ void App_Quit(void)
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-/// \brief Update the application state
+/// \brief Wakes the main thread when a new snapshot is published
+///
+/// \param data Unused
 ///////////////////////////////////////////////////////////////////////////////
-void App_Update(void)
+void App_Wake(void *data)
 {
 	SDL_Event event;
-	static float tcurr = 0.0f, tprev = 0.0f;
 
-	tcurr = SDL_GetPerformanceCounter();
-	delta = ((tcurr - tprev) / SDL_GetPerformanceFrequency()) * 1000.0f;
-	tprev = tcurr;
+	(void)data;
+	SDL_zero(event);
+	event.type = wake_event;
+	SDL_PushEvent(&event);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief Logs CPU use and frame rate once per report interval
+///
+/// \param force Log now and start a new interval
+///////////////////////////////////////////////////////////////////////////////
+void App_Report(bool force)
+{
+	double cpu, fpm, span;
+
+	if (!force && SDL_GetPerformanceCounter() - usage.start <
+		SDL_GetPerformanceFrequency() * APP_REPORT_S) {
+		return;
+	}
+
+	span = UsageMeter_Lap(&usage, &cpu, &fpm);
+	logfmt_info(
+		"%s rendering over %.0f s: %.1f frames/min, %.1f%% CPU",
+		idle ? "Idle" : "Continuous",
+		span,
+		fpm,
+		cpu
+		);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief Returns whether the next frame would differ from the last one
+///
+/// \param snapshot Last drawn snapshot
+/// \param display  Display the snapshot is drawn through
+///
+/// \return true if a frame must be drawn
+///////////////////////////////////////////////////////////////////////////////
+bool App_NeedsDraw(const RLSnapshot *snapshot, RLDisplay *display)
+{
+	return !idle || dirty || RLDisplay_IsDirty(display) || (snapshot &&
+		RLSnapshot_IsAnimating(snapshot, SDL_GetPerformanceCounter()));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief Parses the command line
+///
+/// --headless N	Render N frames offscreen, log their timing and exit
+/// --capture FILE	Write the last headless frame to a PNG file
+/// --golden FILE	Compare the last headless frame to a PNG file
+/// --ttf FILE		Draw glyphs rasterized on demand from a TrueType font
+///					instead of the unifont atlas
+///
+/// \param argc Number of arguments
+/// \param argv Arguments
+///////////////////////////////////////////////////////////////////////////////
+void App_ParseArgs(int argc, char *argv[])
+{
+	for (int i = 1; i < argc; ++i) {
+		if (i + 1 == argc) {
+			logfmt_exit("Missing value for %s", argv[i]);
+		}
+		else if (!strcmp(argv[i], "--headless")) {
+			headless_frames = atoi(argv[++i]);
+			if (headless_frames <= 0) {
+				log_exit("--headless needs a positive frame count");
+			}
+		}
+		else if (!strcmp(argv[i], "--capture")) {
+			capture_path = argv[++i];
+		}
+		else if (!strcmp(argv[i], "--golden")) {
+			golden_path = argv[++i];
+		}
+		else if (!strcmp(argv[i], "--ttf")) {
+			ttf_path = argv[++i];
+		}
+		else {
+			logfmt_exit("Unknown argument %s", argv[i]);
+		}
+	}
+
+	if ((capture_path || golden_path) && !headless_frames) {
+		log_exit("--capture and --golden need --headless");
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief Compares a frame read back from OpenGL to a golden image
+///
+/// \param pixels Bottom-up RGBA pixels of the frame
+///
+/// \return true if every pixel is within APP_GOLDEN_TOLERANCE
+///////////////////////////////////////////////////////////////////////////////
+bool App_CompareGolden(const unsigned char *pixels)
+{
+	int width, height, mismatched = 0, worst = 0;
+	const int row = window_size.x * 4;
+	unsigned char *golden = NULL;
+
+	if (!(golden = stbi_load(golden_path, &width, &height, NULL, 4))) {
+		logfmt_warn("Golden image %s could not be loaded", golden_path);
+		return false;
+	}
+	else if (width != window_size.x || height != window_size.y) {
+		logfmt_warn(
+			"Golden image is %dx%d, frame is %dx%d",
+			width,
+			height,
+			window_size.x,
+			window_size.y
+			);
+		stbi_image_free(golden);
+		return false;
+	}
+
+	for (int y = 0; y < height; ++y) {
+		const unsigned char *a = golden + y * row;
+		const unsigned char *b = pixels + (height - 1 - y) * row;
+		for (int x = 0; x < row; x += 4) {
+			int diff = 0;
+			for (int c = 0; c < 4; ++c) {
+				diff = MAX(diff, abs(a[x + c] - b[x + c]));
+			}
+			mismatched += diff > APP_GOLDEN_TOLERANCE;
+			worst = MAX(worst, diff);
+		}
+	}
+	stbi_image_free(golden);
+
+	logfmt_info(
+		"Golden image %s: %d pixels differ, largest difference %d",
+		golden_path,
+		mismatched,
+		worst
+		);
+	return !mismatched;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief Renders a fixed number of frames offscreen
+///
+/// Frames are drawn without camera interpolation and waited on with
+/// glFinish, so captures do not depend on timing and frame times cover
+/// the GPU work rather than just its submission.
+///
+/// \param queue   Queue the simulation publishes to
+/// \param display Display the snapshots are drawn through
+/// \param font    BMFont describing the glyph atlas
+/// \param tex     Glyph atlas texture
+///
+/// \return Process exit status, nonzero if the golden comparison failed
+///////////////////////////////////////////////////////////////////////////////
+int App_RunHeadless(RLSnapshotQueue *queue, RLDisplay *display, BMFont *font,
+	GLuint tex)
+{
+	const RLSnapshot *snapshot = NULL;
+	RenderTarget *target = NULL;
+	unsigned char *pixels = NULL;
+	const int row = window_size.x * 4;
+	int status = 0;
+
+	if (!(target = RenderTarget_Create(window_size.x, window_size.y))) {
+		log_exit("Render target creation failed");
+	}
+
+	RenderTarget_Bind(target);
+	for (int i = 0; i < headless_frames; ++i) {
+		snapshot = RLSnapshotQueue_Acquire(queue, !snapshot);
+		FrameClock_Tick(frame_clock);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		if (glyph_cache) {
+			DynAtlas_BeginFrame(glyph_cache);
+		}
+		glBindTexture(GL_TEXTURE_2D, tex);
+		RLSnapshot_Draw(snapshot, display, font, UINT64_MAX);
+		glFinish();
+	}
+	FrameClock_Tick(frame_clock);
+
+	if (capture_path || golden_path) {
+		pixels = g_malloc((gsize)row * (gsize)window_size.y);
+		RenderTarget_Read(target, pixels);
+		if (capture_path && !PNG_Write(
+			capture_path,
+			pixels + (window_size.y - 1) * row,
+			window_size.x,
+			window_size.y,
+			4,
+			-row)) {
+			status = 1;
+		}
+		if (golden_path && !App_CompareGolden(pixels)) {
+			status = 1;
+		}
+		g_free(pixels);
+	}
+
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	RenderTarget_Destroy(target);
+	return status;
+}
 
-	while (SDL_PollEvent(&event)) {
+///////////////////////////////////////////////////////////////////////////////
+/// \brief Update the application state
+///
+/// \param wait Block until an event arrives instead of polling
+///////////////////////////////////////////////////////////////////////////////
+void App_Update(bool wait)
+{
+	SDL_Event event;
+	int pending = wait ? SDL_WaitEventTimeout(&event, APP_WAIT_MS) :
+		SDL_PollEvent(&event);
+
+	for (; pending; pending = SDL_PollEvent(&event)) {
+		if (event.type == wake_event) {
+			dirty = true;
+			continue;
+		}
 		switch (event.type) {
 		case SDL_QUIT:
 			running = false;
 			break;
 		case SDL_WINDOWEVENT:
 			switch (event.window.event) {
+			case SDL_WINDOWEVENT_EXPOSED:
+				dirty = true;
+				break;
 			case SDL_WINDOWEVENT_RESIZED:
+				dirty = true;
 				glViewport(
 					0,
 					0,
 					event.window.data1,
 					event.window.data2
 					);
+				RLGame_PushInput(game, (RLInput){
+					RLINPUT_RESIZE,
+					event.window.data1,
+					event.window.data2
+				});
+				break;
+			default:
+				break;
+			}
+			break;
+		case SDL_KEYDOWN:
+			switch (event.key.keysym.sym) {
+			case SDLK_LEFT:
+				RLGame_PushInput(game, (RLInput){RLINPUT_MOVE, -1, 0});
+				break;
+			case SDLK_RIGHT:
+				RLGame_PushInput(game, (RLInput){RLINPUT_MOVE, 1, 0});
+				break;
+			case SDLK_UP:
+				RLGame_PushInput(game, (RLInput){RLINPUT_MOVE, 0, -1});
+				break;
+			case SDLK_DOWN:
+				RLGame_PushInput(game, (RLInput){RLINPUT_MOVE, 0, 1});
+				break;
+			case SDLK_F2:
+				App_Report(true);
+				idle = !idle;
+				dirty = true;
+				break;
+			case SDLK_F3:
+				overlay->visible = !overlay->visible;
+				Profiler_SetEnabled(overlay->visible);
+				dirty = true;
 				break;
 			default:
 				break;
@@ -203,165 +507,235 @@ void App_Update(void)
 /// Main
 ///////////////////////////////////////////////////////////////////////////////
 
-typedef struct { int r, g, b, a; } RLHue;
-
-typedef enum {
-	RLTILE_TEXT,
-	RLTILE_EXACT,
-	RLTILE_FLOOR,
-	RLTILE_CENTER
-} RLTileType;
-
-typedef struct {
-	int glyph;
-	RLHue hue;
-	RLTileType type;
-} RLTile;
-
-typedef struct {
-	struct {
-		int x;
-		int y;
-	} position;
-	struct {
-		int width;
-		int height;
-	} size;
-	GLuint VAO;
-	GLuint VBO;
-	GLuint IBO;
-	int num_tiles;
-	RLTile *tiles;
-	int num_indices;
-	GLuint *indices;
-	int num_vertices;
-	GLfloat *vertices;
-} RLTileMap;
-
-typedef struct {
-	RLTileMap *tile_maps;
-} RLDisplay;
-
-int main(void)
+int main(int argc, char *argv[])
 {
-	GLint utransform;
-	mat4x4 mtransform;
-	unsigned char *tex_data = NULL;
-	struct { int x, y; } tex_size = {0, 0};
-	GLuint VBO, EBO, VAO, vert, frag, prog, tex;
-	const GLfloat vertices[] = {
-		// Vertex coords	// Texture coords
-		 0.9f,   0.9f,  0.0f,   1.0f,   1.0f,
-		 0.9f,  -0.9f,  0.0f,   1.0f,   0.0f,
-		-0.9f,  -0.9f,  0.0f,   0.0f,   0.0f,
-		-0.9f,   0.9f,  0.0f,   0.0f,   1.0f
-	};
-	const GLuint indices[] = {
-		0, 1, 3,
-		1, 2, 3,
-	};
-
+	BMFont *font = NULL;
+	RLCamera camera;
+	RLDisplay *display = NULL;
+	RLSnapshotQueue *queue = NULL;
+	RLSnapshotStats stats;
+	FrameStats frame_stats;
+	const RLSnapshot *snapshot = NULL;
+	const gint64 start = g_get_monotonic_time();
+	Atlas *atlas = NULL;
+	const BMFontInfo *info = NULL;
+	struct { int x, y; } tile_size = {0, 0};
+	GLuint vert, frag, prog, tex;
+	int status = 0;
+	const bool subset = g_file_test(APP_FONT_SUBSET ".fnt",
+		G_FILE_TEST_EXISTS);
+
+	App_ParseArgs(argc, argv);
+
+	// Decode the atlas while SDL and the context come up
+	if (!ttf_path) {
+		atlas = Atlas_Load(subset ? APP_FONT_SUBSET ".png" :
+			APP_FONT ".png");
+	}
 	App_Init();
-
-	{
-		BMFont *font = BMFont_Create("res/unifont.fnt");
-		const BMFontInfo *info = BMFont_GetInfoPtr(font, '\');
+	QuadIndex_Init();
+	Profiler_Init();
+	frame_clock = FrameClock_Create(0, 0);
+
+	if (ttf_path) {
+		if (!(glyph_cache = DynAtlas_Create(
+			ttf_path,
+			APP_TTF_PIXELS,
+			APP_TTF_ATLAS))) {
+			log_exit("Font loading failed");
+		}
+		font = DynAtlas_GetFont(glyph_cache);
+		DynAtlas_GetCellSize(glyph_cache, &tile_size.x, &tile_size.y);
+	}
+	else if (!(font = BMFont_Create(subset ? APP_FONT_SUBSET ".fnt" :
+		APP_FONT ".fnt"))) {
+		log_exit("Font metrics loading failed");
+	}
+	else if ((info = BMFont_GetInfoPtr(font, '@'))) {
 		logfmt_info(
 			"'@' glyph metrics: x: %d, y: %d",
 			info->position.x,
 			info->position.y
 			);
-		BMFont_Destroy(font);
+		tile_size.x = info->size.width;
+		tile_size.y = info->size.height;
+	}
+
+	// The view and tile map dimensions divide by the cell size
+	if (tile_size.x <= 0 || tile_size.y <= 0) {
+		log_exit("Font has no cell metrics");
 	}
 
-	vert = GL_ShaderNew(GL_VERTEX_SHADER, shaders.vertex.basic);
-	frag = GL_ShaderNew(GL_FRAGMENT_SHADER, shaders.fragment.basic);
+	vert = GL_ShaderNew(GL_VERTEX_SHADER, shaders.vertex.tile);
+	frag = GL_ShaderNew(GL_FRAGMENT_SHADER, shaders.fragment.tile);
 	prog = GL_ProgramNew(vert, frag);
 	glDeleteShader(vert);
 	glDeleteShader(frag);
 
-	glGenBuffers(1, &VBO);
-	glGenBuffers(1, &EBO);
-	glGenVertexArrays(1, &VAO);
-
-	// Define simple VAO
-	glBindVertexArray(VAO);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-	glBufferData(
-		GL_ELEMENT_ARRAY_BUFFER,
-		sizeof(indices),
-		indices,
-		GL_STATIC_DRAW
-		);
-	glVertexAttribPointer(
-		0,
-		3,
-		GL_FLOAT,
-		GL_FALSE,
-		5 * sizeof(GLfloat),
-		(void *)0
-		);
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(
-		1,
-		2,
-		GL_FLOAT,
-		GL_FALSE, 5 * sizeof(GLfloat),
-		(void *)(3 * sizeof(GLfloat))
+	// The simulation owns the tiles, the display only draws its snapshots
+	RLCamera_Init(
+		&camera,
+		window_size.x,
+		window_size.y,
+		tile_size.x,
+		tile_size.y
 		);
-	glEnableVertexAttribArray(1);
-
-	// Load texture
-	stbi_set_flip_vertically_on_load(true);
-	if (!(tex_data = stbi_load(
-		"res/unifont.png",
-		&tex_size.x,
-		&tex_size.y,
-		NULL,
-		STBI_rgb_alpha))) {
+	queue = RLSnapshotQueue_Create();
+	if ((wake_event = SDL_RegisterEvents(1)) == (Uint32)-1) {
+		log_warn("Out of SDL user events, idle rendering disabled");
+		idle = false;
+	}
+	else {
+		RLSnapshotQueue_SetNotify(queue, App_Wake, NULL);
+	}
+	if (!(game = RLGame_Create(
+		queue,
+		dungeon_size.x,
+		dungeon_size.y,
+		&camera))) {
+		log_exit("Game creation failed");
+	}
+
+	display = RLDisplay_Create(prog);
+	for (int i = 0; i < RLGAME_NUM_LAYERS; ++i) {
+		RLTileMap *map = NULL;
+		RLLayer *layer = NULL;
+		const bool ui = i == RLGAME_LAYER_UI;
+		if (!(map = RLTileMap_Create(
+			0,
+			0,
+			ui ? window_size.x / tile_size.x : dungeon_size.x,
+			ui ? window_size.y / tile_size.y : dungeon_size.y,
+			tile_size.x,
+			tile_size.y
+			))) {
+			log_exit("Tile map creation failed");
+		}
+		layer = RLDisplay_AddLayer(
+			display,
+			map,
+			i,
+			ui ? RLLAYER_TRANSPARENT : RLLAYER_OPAQUE
+			);
+		layer->screen_space = ui;
+	}
+
+	// Profiler overlay above the game's layers, hidden until toggled
+	if (!(overlay = RLDisplay_AddLayer(
+		display,
+		RLTileMap_Create(
+			0,
+			0,
+			window_size.x / tile_size.x,
+			window_size.y / tile_size.y,
+			tile_size.x,
+			tile_size.y
+			),
+		RLGAME_NUM_LAYERS,
+		RLLAYER_TRANSPARENT
+		))) {
+		log_exit("Profiler overlay creation failed");
+	}
+	overlay->screen_space = true;
+	overlay->visible = false;
+
+	if (glyph_cache) {
+		tex = DynAtlas_GetTexture(glyph_cache);
+	}
+	else if (!Atlas_Upload(atlas, GL_NEAREST, GL_NEAREST)) {
 		log_exit("Font atlas loading failed");
 	}
+	else {
+		tex = Atlas_GetTexture(atlas);
+	}
 
-	glGenTextures(1, &tex);
-	glBindTexture(GL_TEXTURE_2D, tex);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-	glTexImage2D(
-		GL_TEXTURE_2D,
-		0,
-		GL_RGBA,
-		tex_size.x,
-		tex_size.y,
-		0,
-		GL_RGBA,
-		GL_UNSIGNED_BYTE,
-		tex_data
+	RLGame_Start(game);
+	logfmt_info(
+		"Startup took %.1f ms",
+		(double)(g_get_monotonic_time() - start) / 1000.0
 		);
-	glGenerateMipmap(GL_TEXTURE_2D);
-	stbi_image_free(tex_data);
-
-	mat4x4_identity(mtransform);
-	utransform = glGetUniformLocation(prog, "transform");
-	while (running) {
-		App_Update();
-		glClear(GL_COLOR_BUFFER_BIT);
-		glBindTexture(GL_TEXTURE_2D, tex);
-		glUseProgram(prog);
-		glUniformMatrix4fv(utransform, 1, GL_FALSE, (GLfloat *)mtransform);
-		glBindVertexArray(VAO);
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-		glBindVertexArray(0);
-		SDL_GL_SwapWindow(window);
+	if (headless_frames) {
+		status = App_RunHeadless(queue, display, font, tex);
 	}
+	else {
+		UsageMeter_Init(&usage);
+		while (running) {
+			// Sleep in the event queue while nothing on screen would change
+			if (!App_NeedsDraw(snapshot, display)) {
+				App_Update(true);
+				FrameClock_Reset(frame_clock);
+			}
+			else {
+				Profiler_BeginFrame();
+				Profiler_Begin(PROFILE_EVENTS);
+				App_Update(false);
+				Profiler_End(PROFILE_EVENTS);
+			}
+			App_Report(false);
+			if (!running || !App_NeedsDraw(snapshot, display)) {
+				continue;
+			}
 
-	glDeleteBuffers(1, &EBO);
-	glDeleteBuffers(1, &VBO);
-	glDeleteVertexArrays(1, &VAO);
+			// Wait for the very first snapshot, then draw the latest one
+			Profiler_BeginFrame();
+			snapshot = RLSnapshotQueue_Acquire(queue, !snapshot);
+			FrameClock_Tick(frame_clock);
+			if (overlay->visible) {
+				Profiler_Write(overlay->tile_map);
+			}
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			if (glyph_cache) {
+				DynAtlas_BeginFrame(glyph_cache);
+			}
+			glBindTexture(GL_TEXTURE_2D, tex);
+			RLSnapshot_Draw(
+				snapshot,
+				display,
+				font,
+				SDL_GetPerformanceCounter()
+				);
+			Profiler_Begin(PROFILE_SWAP);
+			SDL_GL_SwapWindow(window);
+			Profiler_End(PROFILE_SWAP);
+			Profiler_EndFrame();
+			UsageMeter_Frame(&usage);
+			dirty = false;
+		}
+
+		App_Report(true);
+	}
+	RLGame_Destroy(game);
+	RLSnapshotQueue_GetStats(queue, &stats);
+	logfmt_info(
+		"Snapshots published: %lu, dropped: %lu, stale frames: %lu, "
+		"render stall: %lu us",
+		(unsigned long)stats.published,
+		(unsigned long)stats.dropped,
+		(unsigned long)stats.stale,
+		(unsigned long)stats.stall_us
+		);
+	FrameClock_GetStats(frame_clock, &frame_stats);
+	logfmt_info(
+		"Frame time over %d frames, min: %.2f ms, avg: %.2f ms, p99: %.2f ms",
+		frame_stats.samples,
+		frame_stats.min,
+		frame_stats.avg,
+		frame_stats.p99
+		);
+	RLSnapshotQueue_Destroy(queue);
+	RLDisplay_Destroy(display);
+	if (glyph_cache) {
+		DynAtlas_Destroy(glyph_cache);
+	}
+	else {
+		BMFont_Destroy(font);
+		Atlas_Destroy(atlas);
+	}
+	glDeleteProgram(prog);
 
+	FrameClock_Destroy(frame_clock);
+	Profiler_Quit();
+	QuadIndex_Quit();
 	App_Quit();
-	return 0;
+	return status;
 }
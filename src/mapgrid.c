@@ -0,0 +1,165 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	mapgrid.c
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Gameplay properties of a dungeon map, one plane per property,
+///			laid out for neighbourhood queries
+///////////////////////////////////////////////////////////////////////////////
+
+#include "mapgrid.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+
+#include "common.h"
+#include "log.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+#define RLMAP_CACHE_LINE 64
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+static void * RLMapGrid_Alloc(size_t size)
+{
+	void *plane = NULL;
+
+	// aligned_alloc wants a multiple of the alignment
+	size = (size + RLMAP_CACHE_LINE - 1) / RLMAP_CACHE_LINE *
+		RLMAP_CACHE_LINE;
+	if (!(plane = aligned_alloc(RLMAP_CACHE_LINE, size))) {
+		log_exit("Map plane allocation failed");
+	}
+
+	return memset(plane, 0, size);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static bool RLMapGrid_Clip(const RLMapGrid *this, int *x, int *y, int *w,
+	int *h)
+{
+	const int right = MIN(*x + *w, this->size.width);
+	const int bottom = MIN(*y + *h, this->size.height);
+
+	*x = MAX(*x, 0);
+	*y = MAX(*y, 0);
+	*w = right - *x;
+	*h = bottom - *y;
+
+	return *w > 0 && *h > 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Public functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+RLMapGrid * RLMapGrid_Create(int width, int height)
+{
+	RLMapGrid *this = NULL;
+	size_t blocks, words;
+
+	if (width <= 0 || height <= 0) {
+		logfmt_warn("Invalid map size %dx%d", width, height);
+		return NULL;
+	}
+
+	this = g_new0(RLMapGrid, 1);
+	this->size.width = width;
+	this->size.height = height;
+	this->blocks_per_row = (width + RLMAP_BLOCK - 1) / RLMAP_BLOCK;
+	this->words_per_row = (width + RLMAP_WORD_BITS - 1) / RLMAP_WORD_BITS;
+
+	blocks = (size_t)this->blocks_per_row *
+		(size_t)((height + RLMAP_BLOCK - 1) / RLMAP_BLOCK);
+	words = (size_t)this->words_per_row * (size_t)height;
+	for (int i = 0; i < RLMAP_NUM_BYTES; ++i) {
+		this->bytes[i] = RLMapGrid_Alloc(blocks * RLMAP_BLOCK * RLMAP_BLOCK);
+	}
+	for (int i = 0; i < RLMAP_NUM_BITS; ++i) {
+		this->bits[i] = RLMapGrid_Alloc(words * sizeof(uint64_t));
+	}
+
+	return this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLMapGrid_FillBytes(RLMapGrid *this, RLMapBytePlane plane, int x, int y,
+	int w, int h, uint8_t value)
+{
+	if (!this) {
+		log_warn("NULL argument");
+		return;
+	}
+	if (!RLMapGrid_Clip(this, &x, &y, &w, &h)) {
+		return;
+	}
+
+	// A row of the rectangle is contiguous within each block it crosses
+	for (int row = y; row < y + h; ++row) {
+		for (int left = x; left < x + w;) {
+			const int span = MIN(x + w, (left / RLMAP_BLOCK + 1) *
+				RLMAP_BLOCK) - left;
+			memset(
+				&this->bytes[plane][RLMapGrid_ByteIndex(this, left, row)],
+				value,
+				(size_t)span
+				);
+			left += span;
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLMapGrid_FillBits(RLMapGrid *this, RLMapBitPlane plane, int x, int y,
+	int w, int h, bool value)
+{
+	int last_word;
+
+	if (!this) {
+		log_warn("NULL argument");
+		return;
+	}
+	if (!RLMapGrid_Clip(this, &x, &y, &w, &h)) {
+		return;
+	}
+
+	RLMapGrid_Changed(this, plane, x, y, w, h);
+	last_word = (x + w - 1) / RLMAP_WORD_BITS;
+	for (int row = y; row < y + h; ++row) {
+		uint64_t *words = this->bits[plane] + (size_t)row *
+			(size_t)this->words_per_row;
+
+		for (int i = x / RLMAP_WORD_BITS; i <= last_word; ++i) {
+			const int lo = MAX(x - i * RLMAP_WORD_BITS, 0);
+			const int hi = MIN(x + w - i * RLMAP_WORD_BITS, RLMAP_WORD_BITS);
+			const uint64_t mask = (~(uint64_t)0 >> (RLMAP_WORD_BITS -
+				(hi - lo))) << lo;
+
+			words[i] = value ? words[i] | mask : words[i] & ~mask;
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLMapGrid_Destroy(RLMapGrid *this)
+{
+	if (CONDBIND(this, log_warn, "NULL argument")) {
+		for (int i = 0; i < RLMAP_NUM_BYTES; ++i) {
+			free(this->bytes[i]);
+		}
+		for (int i = 0; i < RLMAP_NUM_BITS; ++i) {
+			free(this->bits[i]);
+		}
+		g_free(this);
+	}
+}
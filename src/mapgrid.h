@@ -0,0 +1,366 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	mapgrid.h
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Gameplay properties of a dungeon map, one plane per property,
+///			laid out for neighbourhood queries
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef MAPGRID_H
+#define MAPGRID_H
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+// Byte planes are stored in square blocks of this many cells a side, so a
+// block is one 64 byte cache line
+#define RLMAP_BLOCK 8
+
+// Cells per word of a bit plane row
+#define RLMAP_WORD_BITS 64
+
+// Changes to each bit plane kept by RLMapGrid_GetChange, a power of two
+#define RLMAP_CHANGES 256
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Per-cell byte properties
+///
+/// RLMAP_TERRAIN:	Terrain id, meaning left to the game
+/// RLMAP_LIGHT:	Light level, 0 is dark
+///////////////////////////////////////////////////////////////////////////////
+typedef enum {
+	RLMAP_TERRAIN,
+	RLMAP_LIGHT,
+	RLMAP_NUM_BYTES
+} RLMapBytePlane;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Per-cell flags
+///
+/// RLMAP_WALKABLE:		Creatures can stand on the cell
+/// RLMAP_TRANSPARENT:	Light and sight pass through the cell
+/// RLMAP_EXPLORED:		The player has seen the cell
+///////////////////////////////////////////////////////////////////////////////
+typedef enum {
+	RLMAP_WALKABLE,
+	RLMAP_TRANSPARENT,
+	RLMAP_EXPLORED,
+	RLMAP_NUM_BITS
+} RLMapBitPlane;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Rectangle of a bit plane written by the change that brought the
+///			plane to a version
+///////////////////////////////////////////////////////////////////////////////
+typedef struct {
+	uint32_t version;
+	int x;
+	int y;
+	int w;
+	int h;
+} RLMapChange;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Map of width by height cells
+///
+/// Byte planes hold RLMAP_BLOCK by RLMAP_BLOCK blocks in row-major order,
+/// each block row-major inside. Bit planes hold words_per_row words per map
+/// row, cell x of a row in bit x % 64 of word x / 64. Cells past the right
+/// and bottom edges pad the planes and are always zero. The planes are
+/// aligned to cache lines.
+///
+/// RLMapGrid_SetBit and RLMapGrid_FillBits bump the version of the plane
+/// they write, so copies derived from a plane can tell when to refresh,
+/// and log the rectangle written so they can refresh only that. Code
+/// writing bits directly calls RLMapGrid_Changed itself.
+///////////////////////////////////////////////////////////////////////////////
+typedef struct {
+	struct {
+		int width;
+		int height;
+	} size;
+	int blocks_per_row;
+	int words_per_row;
+	uint8_t *bytes[RLMAP_NUM_BYTES];
+	uint64_t *bits[RLMAP_NUM_BITS];
+	uint32_t versions[RLMAP_NUM_BITS];
+	RLMapChange changes[RLMAP_NUM_BITS][RLMAP_CHANGES];
+} RLMapGrid;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns a pointer to a new RLMapGrid with every plane zeroed
+///
+/// \param	width	Width of the map in cells
+/// \param	height	Height of the map in cells
+///
+/// \return	Pointer to the new RLMapGrid, NULL if the size is not positive
+///////////////////////////////////////////////////////////////////////////////
+RLMapGrid * RLMapGrid_Create(int width, int height);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns whether a cell lies on the map
+///
+/// \param	this	An RLMapGrid
+/// \param	x		Column of the cell
+/// \param	y		Row of the cell
+///
+/// \return	true if the cell is on the map
+///////////////////////////////////////////////////////////////////////////////
+static inline bool RLMapGrid_InBounds(const RLMapGrid *this, int x, int y)
+{
+	return x >= 0 && y >= 0 && x < this->size.width && y < this->size.height;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns the offset of a cell into a byte plane
+///
+/// \param	this	An RLMapGrid
+/// \param	x		Column of a cell on the map
+/// \param	y		Row of a cell on the map
+///
+/// \return	Offset of the cell
+///////////////////////////////////////////////////////////////////////////////
+static inline size_t RLMapGrid_ByteIndex(const RLMapGrid *this, int x, int y)
+{
+	const size_t block = (size_t)(y / RLMAP_BLOCK) *
+		(size_t)this->blocks_per_row + (size_t)(x / RLMAP_BLOCK);
+
+	return block * RLMAP_BLOCK * RLMAP_BLOCK +
+		(size_t)(y % RLMAP_BLOCK * RLMAP_BLOCK + x % RLMAP_BLOCK);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns a byte property of a cell, 0 off the map
+///
+/// \param	this	An RLMapGrid
+/// \param	plane	Property to read
+/// \param	x		Column of the cell
+/// \param	y		Row of the cell
+///
+/// \return	Value of the property
+///////////////////////////////////////////////////////////////////////////////
+static inline uint8_t RLMapGrid_GetByte(const RLMapGrid *this,
+	RLMapBytePlane plane, int x, int y)
+{
+	if (!RLMapGrid_InBounds(this, x, y)) {
+		return 0;
+	}
+
+	return this->bytes[plane][RLMapGrid_ByteIndex(this, x, y)];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Sets a byte property of a cell, ignored off the map
+///
+/// \param	this	An RLMapGrid
+/// \param	plane	Property to write
+/// \param	x		Column of the cell
+/// \param	y		Row of the cell
+/// \param	value	New value of the property
+///////////////////////////////////////////////////////////////////////////////
+static inline void RLMapGrid_SetByte(RLMapGrid *this, RLMapBytePlane plane,
+	int x, int y, uint8_t value)
+{
+	if (RLMapGrid_InBounds(this, x, y)) {
+		this->bytes[plane][RLMapGrid_ByteIndex(this, x, y)] = value;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns a flag of a cell, false off the map
+///
+/// \param	this	An RLMapGrid
+/// \param	plane	Flag to read
+/// \param	x		Column of the cell
+/// \param	y		Row of the cell
+///
+/// \return	Value of the flag
+///////////////////////////////////////////////////////////////////////////////
+static inline bool RLMapGrid_GetBit(const RLMapGrid *this,
+	RLMapBitPlane plane, int x, int y)
+{
+	if (!RLMapGrid_InBounds(this, x, y)) {
+		return false;
+	}
+
+	return this->bits[plane][(size_t)y * (size_t)this->words_per_row +
+		(size_t)(x / RLMAP_WORD_BITS)] >> (x % RLMAP_WORD_BITS) & 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Bumps the version of a bit plane and logs the rectangle written
+///
+/// \param	this	An RLMapGrid
+/// \param	plane	Flag written
+/// \param	x		Left column of the rectangle
+/// \param	y		Top row of the rectangle
+/// \param	w		Width of the rectangle in cells
+/// \param	h		Height of the rectangle in cells
+///////////////////////////////////////////////////////////////////////////////
+static inline void RLMapGrid_Changed(RLMapGrid *this, RLMapBitPlane plane,
+	int x, int y, int w, int h)
+{
+	const uint32_t version = ++this->versions[plane];
+
+	this->changes[plane][version % RLMAP_CHANGES] =
+		(RLMapChange){version, x, y, w, h};
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns the change that brought a bit plane to a version
+///
+/// Only the last RLMAP_CHANGES changes are kept, and a version bumped
+/// without RLMapGrid_Changed has no change.
+///
+/// \param	this	An RLMapGrid
+/// \param	plane	Flag written
+/// \param	version	Version of the plane right after the change
+///
+/// \return	Pointer to the change, NULL if it is not kept
+///////////////////////////////////////////////////////////////////////////////
+static inline const RLMapChange * RLMapGrid_GetChange(const RLMapGrid *this,
+	RLMapBitPlane plane, uint32_t version)
+{
+	const RLMapChange *change = &this->changes[plane][version %
+		RLMAP_CHANGES];
+
+	if (this->versions[plane] - version >= RLMAP_CHANGES ||
+		change->version != version) {
+		return NULL;
+	}
+
+	return change;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Sets a flag of a cell, ignored off the map
+///
+/// \param	this	An RLMapGrid
+/// \param	plane	Flag to write
+/// \param	x		Column of the cell
+/// \param	y		Row of the cell
+/// \param	value	New value of the flag
+///////////////////////////////////////////////////////////////////////////////
+static inline void RLMapGrid_SetBit(RLMapGrid *this, RLMapBitPlane plane,
+	int x, int y, bool value)
+{
+	uint64_t *word = NULL, mask;
+
+	if (!RLMapGrid_InBounds(this, x, y)) {
+		return;
+	}
+
+	word = &this->bits[plane][(size_t)y * (size_t)this->words_per_row +
+		(size_t)(x / RLMAP_WORD_BITS)];
+	mask = (uint64_t)1 << (x % RLMAP_WORD_BITS);
+	*word = value ? *word | mask : *word & ~mask;
+	RLMapGrid_Changed(this, plane, x, y, 1, 1);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns 64 consecutive flags of a row as one word
+///
+/// Bit i of the result is the flag of cell (x + i, y). Cells off the map
+/// read as unset, so a whole span can be tested against a mask at once.
+///
+/// \param	this	An RLMapGrid
+/// \param	plane	Flag to read
+/// \param	x		Column of the first cell, may be negative
+/// \param	y		Row of the cells
+///
+/// \return	Flags of the 64 cells
+///////////////////////////////////////////////////////////////////////////////
+static inline uint64_t RLMapGrid_GetBits(const RLMapGrid *this,
+	RLMapBitPlane plane, int x, int y)
+{
+	const uint64_t *row = NULL;
+	int word, shift;
+
+	if (y < 0 || y >= this->size.height || x >= this->size.width ||
+		x <= -RLMAP_WORD_BITS) {
+		return 0;
+	}
+
+	row = this->bits[plane] + (size_t)y * (size_t)this->words_per_row;
+	if (x < 0) {
+		return row[0] << -x;
+	}
+
+	word = x / RLMAP_WORD_BITS;
+	shift = x % RLMAP_WORD_BITS;
+	if (!shift) {
+		return row[word];
+	}
+	else if (word + 1 < this->words_per_row) {
+		return row[word] >> shift | row[word + 1] << (RLMAP_WORD_BITS - shift);
+	}
+	else {
+		return row[word] >> shift;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns the words of one row of a bit plane
+///
+/// \param	this	An RLMapGrid
+/// \param	plane	Flag to read
+/// \param	y		Row on the map
+///
+/// \return	Pointer to words_per_row words
+///////////////////////////////////////////////////////////////////////////////
+static inline const uint64_t * RLMapGrid_GetRow(const RLMapGrid *this,
+	RLMapBitPlane plane, int y)
+{
+	return this->bits[plane] + (size_t)y * (size_t)this->words_per_row;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Sets a byte property over a rectangle, clipped to the map
+///
+/// \param	this	An RLMapGrid
+/// \param	plane	Property to write
+/// \param	x		Left column of the rectangle
+/// \param	y		Top row of the rectangle
+/// \param	w		Width of the rectangle in cells
+/// \param	h		Height of the rectangle in cells
+/// \param	value	New value of the property
+///////////////////////////////////////////////////////////////////////////////
+void RLMapGrid_FillBytes(RLMapGrid *this, RLMapBytePlane plane, int x, int y,
+	int w, int h, uint8_t value);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Sets a flag over a rectangle, clipped to the map
+///
+/// Whole words are written at a time.
+///
+/// \param	this	An RLMapGrid
+/// \param	plane	Flag to write
+/// \param	x		Left column of the rectangle
+/// \param	y		Top row of the rectangle
+/// \param	w		Width of the rectangle in cells
+/// \param	h		Height of the rectangle in cells
+/// \param	value	New value of the flag
+///////////////////////////////////////////////////////////////////////////////
+void RLMapGrid_FillBits(RLMapGrid *this, RLMapBitPlane plane, int x, int y,
+	int w, int h, bool value);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Frees the memory associated with an RLMapGrid
+///
+/// \param	this	An RLMapGrid
+///////////////////////////////////////////////////////////////////////////////
+void RLMapGrid_Destroy(RLMapGrid *this);
+
+#endif
@@ -0,0 +1,611 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	path.c
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Grid pathfinding over a map's walkable plane, by A* or jump point
+///			search, reusing its node storage between queries
+///////////////////////////////////////////////////////////////////////////////
+
+#include "path.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+
+#include "common.h"
+#include "log.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+// Heap position of a node that has been expanded
+#define RLPATH_CLOSED -1
+
+#define RLPATH_SIGN(x) (((x) > 0) - ((x) < 0))
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// Search state of a cell, only valid while generation matches the query's
+///////////////////////////////////////////////////////////////////////////////
+typedef struct {
+	uint32_t generation;
+	int g;
+	int parent;
+	int heap;
+} RLPathNode;
+
+///////////////////////////////////////////////////////////////////////////////
+/// Open list entry, lower f first and among equal f the higher g, which is
+/// the node nearer the goal
+///////////////////////////////////////////////////////////////////////////////
+typedef struct {
+	uint64_t key;
+	int node;
+} RLPathEntry;
+
+///////////////////////////////////////////////////////////////////////////////
+/// Walkable plane as lines of 64-cell words, either the map's rows or a
+/// transposed copy holding its columns
+///////////////////////////////////////////////////////////////////////////////
+typedef struct {
+	const uint64_t *bits;
+	int words;
+	int length;
+	int count;
+} RLPathLines;
+
+struct _RLPathFinder {
+	const RLMapGrid *map;
+	RLPathLines rows;
+	RLPathLines columns;
+	// Walkable plane version the columns were copied from
+	uint32_t version;
+	int width;
+	int num_nodes;
+	RLPathNode *nodes;
+	RLPathEntry *heap;
+	int heap_size;
+	uint32_t generation;
+	struct {
+		int x;
+		int y;
+	} goal;
+	int cost;
+	int expanded;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static variables
+///////////////////////////////////////////////////////////////////////////////
+
+static const int directions[8][2] = {
+	{1, 0}, {-1, 0}, {0, 1}, {0, -1},
+	{1, 1}, {-1, 1}, {1, -1}, {-1, -1}
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+static inline bool RLPath_Open(const RLPathFinder *this, int x, int y)
+{
+	return RLMapGrid_GetBit(this->map, RLMAP_WALKABLE, x, y);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static int RLPath_Distance(int dx, int dy)
+{
+	const int ax = abs(dx), ay = abs(dy);
+
+	return RLPATH_COST_STRAIGHT * MAX(ax, ay) +
+		(RLPATH_COST_DIAGONAL - RLPATH_COST_STRAIGHT) * MIN(ax, ay);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLPath_Place(RLPathFinder *this, int i, RLPathEntry entry)
+{
+	this->heap[i] = entry;
+	this->nodes[entry.node].heap = i;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLPath_SiftUp(RLPathFinder *this, int i)
+{
+	const RLPathEntry entry = this->heap[i];
+
+	while (i > 0 && entry.key < this->heap[(i - 1) / 2].key) {
+		RLPath_Place(this, i, this->heap[(i - 1) / 2]);
+		i = (i - 1) / 2;
+	}
+	RLPath_Place(this, i, entry);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static int RLPath_Pop(RLPathFinder *this)
+{
+	const int node = this->heap[0].node;
+	const RLPathEntry last = this->heap[--this->heap_size];
+	int i = 0;
+
+	// Sift the last entry down from the root
+	while (2 * i + 1 < this->heap_size) {
+		int child = 2 * i + 1;
+		if (child + 1 < this->heap_size &&
+			this->heap[child + 1].key < this->heap[child].key) {
+			++child;
+		}
+		if (last.key <= this->heap[child].key) {
+			break;
+		}
+		RLPath_Place(this, i, this->heap[child]);
+		i = child;
+	}
+	if (this->heap_size) {
+		RLPath_Place(this, i, last);
+	}
+
+	this->nodes[node].heap = RLPATH_CLOSED;
+	return node;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLPath_Relax(RLPathFinder *this, int parent, int x, int y, int g)
+{
+	const int i = y * this->width + x;
+	RLPathNode *node = &this->nodes[i];
+	const int f = g + RLPath_Distance(this->goal.x - x, this->goal.y - y);
+	const RLPathEntry entry = {
+		(uint64_t)f << 32 | (uint32_t)(INT32_MAX - g),
+		i
+	};
+
+	if (node->generation != this->generation) {
+		node->generation = this->generation;
+		node->heap = this->heap_size++;
+	}
+	else if (node->heap == RLPATH_CLOSED || g >= node->g) {
+		// The heuristic is consistent, so expanded nodes are final
+		return;
+	}
+
+	node->g = g;
+	node->parent = parent;
+	this->heap[node->heap] = entry;
+	RLPath_SiftUp(this, node->heap);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLPath_ExpandAStar(RLPathFinder *this, int node, int x, int y)
+{
+	const int g = this->nodes[node].g;
+	uint64_t around[3];
+
+	// The 3x3 neighbourhood as bits 0 to 2 of three rows
+	for (int i = 0; i < 3; ++i) {
+		around[i] = RLMapGrid_GetBits(this->map, RLMAP_WALKABLE, x - 1,
+			y - 1 + i);
+	}
+
+	for (int i = 0; i < 8; ++i) {
+		const int dx = directions[i][0], dy = directions[i][1];
+
+		if (!(around[1 + dy] >> (1 + dx) & 1) || (dx && dy &&
+			(!(around[1] >> (1 + dx) & 1) || !(around[1 + dy] >> 1 & 1)))) {
+			continue;
+		}
+		RLPath_Relax(
+			this,
+			node,
+			x + dx,
+			y + dy,
+			g + (dx && dy ? RLPATH_COST_DIAGONAL : RLPATH_COST_STRAIGHT)
+			);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static inline uint64_t RLPath_GetBits(const RLPathLines *lines, int pos,
+	int line)
+{
+	const uint64_t *bits = NULL;
+	int word, shift;
+
+	// RLMapGrid_GetBits along rows or columns
+	if (line < 0 || line >= lines->count || pos >= lines->length ||
+		pos <= -RLMAP_WORD_BITS) {
+		return 0;
+	}
+
+	bits = lines->bits + (size_t)line * (size_t)lines->words;
+	if (pos < 0) {
+		return bits[0] << -pos;
+	}
+
+	word = pos / RLMAP_WORD_BITS;
+	shift = pos % RLMAP_WORD_BITS;
+	if (!shift) {
+		return bits[word];
+	}
+	else if (word + 1 < lines->words) {
+		return bits[word] >> shift | bits[word + 1] <<
+			(RLMAP_WORD_BITS - shift);
+	}
+	else {
+		return bits[word] >> shift;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static int RLPath_ScanForward(const RLPathLines *lines, int pos, int line,
+	int goal_pos, int goal_line)
+{
+	// Stops at the first wall, goal, or cell beside a wall corner, where a
+	// path may turn, taking 64 cells of the line at a time
+	for (;; pos += RLMAP_WORD_BITS) {
+		const uint64_t open = RLPath_GetBits(lines, pos, line);
+		uint64_t stop = ~open;
+
+		stop |= RLPath_GetBits(lines, pos, line - 1) &
+			~RLPath_GetBits(lines, pos - 1, line - 1);
+		stop |= RLPath_GetBits(lines, pos, line + 1) &
+			~RLPath_GetBits(lines, pos - 1, line + 1);
+		if (line == goal_line && goal_pos >= pos &&
+			goal_pos < pos + RLMAP_WORD_BITS) {
+			stop |= (uint64_t)1 << (goal_pos - pos);
+		}
+
+		if (stop) {
+			const int i = __builtin_ctzll(stop);
+			return open >> i & 1 ? pos + i : -1;
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static int RLPath_ScanBackward(const RLPathLines *lines, int pos, int line,
+	int goal_pos, int goal_line)
+{
+	// As RLPath_ScanForward, the word holding the 64 cells ending at pos
+	for (;; pos -= RLMAP_WORD_BITS) {
+		const int base = pos - (RLMAP_WORD_BITS - 1);
+		const uint64_t open = RLPath_GetBits(lines, base, line);
+		uint64_t stop = ~open;
+
+		stop |= RLPath_GetBits(lines, base, line - 1) &
+			~RLPath_GetBits(lines, base + 1, line - 1);
+		stop |= RLPath_GetBits(lines, base, line + 1) &
+			~RLPath_GetBits(lines, base + 1, line + 1);
+		if (line == goal_line && goal_pos >= base && goal_pos <= pos) {
+			stop |= (uint64_t)1 << (goal_pos - base);
+		}
+
+		if (stop) {
+			const int i = RLMAP_WORD_BITS - 1 - __builtin_clzll(stop);
+			return open >> i & 1 ? base + i : -1;
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static int RLPath_JumpHorizontal(const RLPathFinder *this, int x, int y,
+	int dx)
+{
+	return dx > 0 ?
+		RLPath_ScanForward(&this->rows, x, y, this->goal.x, this->goal.y) :
+		RLPath_ScanBackward(&this->rows, x, y, this->goal.x, this->goal.y);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static int RLPath_JumpVertical(const RLPathFinder *this, int x, int y,
+	int dy)
+{
+	return dy > 0 ?
+		RLPath_ScanForward(&this->columns, y, x, this->goal.y, this->goal.x) :
+		RLPath_ScanBackward(&this->columns, y, x, this->goal.y, this->goal.x);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLPath_Transpose(RLPathFinder *this)
+{
+	const RLMapGrid *map = this->map;
+	uint64_t *columns = (uint64_t *)this->columns.bits;
+
+	memset(columns, 0, sizeof(uint64_t) * (size_t)this->columns.words *
+		(size_t)this->columns.count);
+	for (int y = 0; y < map->size.height; ++y) {
+		const uint64_t *row = RLMapGrid_GetRow(map, RLMAP_WALKABLE, y);
+		const uint64_t bit = (uint64_t)1 << (y % RLMAP_WORD_BITS);
+
+		for (int w = 0; w < map->words_per_row; ++w) {
+			for (uint64_t open = row[w]; open; open &= open - 1) {
+				const int x = w * RLMAP_WORD_BITS + __builtin_ctzll(open);
+				columns[(size_t)x * (size_t)this->columns.words +
+					(size_t)(y / RLMAP_WORD_BITS)] |= bit;
+			}
+		}
+	}
+
+	this->version = map->versions[RLMAP_WALKABLE];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static bool RLPath_JumpDiagonal(const RLPathFinder *this, int *x, int *y,
+	int dx, int dy)
+{
+	for (;;) {
+		if (!RLPath_Open(this, *x, *y)) {
+			return false;
+		}
+		// A turn is possible wherever a straight jump from here finds one
+		if ((*x == this->goal.x && *y == this->goal.y) ||
+			RLPath_JumpHorizontal(this, *x + dx, *y, dx) >= 0 ||
+			RLPath_JumpVertical(this, *x, *y + dy, dy) >= 0) {
+			return true;
+		}
+		if (!RLPath_Open(this, *x + dx, *y) ||
+			!RLPath_Open(this, *x, *y + dy)) {
+			return false;
+		}
+		*x += dx;
+		*y += dy;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLPath_Jump(RLPathFinder *this, int node, int x, int y, int dx,
+	int dy)
+{
+	int jx = x + dx, jy = y + dy;
+
+	if (dx && dy) {
+		if (!RLPath_JumpDiagonal(this, &jx, &jy, dx, dy)) {
+			return;
+		}
+	}
+	else if (dx) {
+		jx = RLPath_JumpHorizontal(this, jx, jy, dx);
+	}
+	else {
+		jy = RLPath_JumpVertical(this, jx, jy, dy);
+	}
+
+	if (jx >= 0 && jy >= 0) {
+		RLPath_Relax(
+			this,
+			node,
+			jx,
+			jy,
+			this->nodes[node].g + RLPath_Distance(jx - x, jy - y)
+			);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLPath_ExpandJPS(RLPathFinder *this, int node, int x, int y)
+{
+	const RLPathNode *n = &this->nodes[node];
+	int dx, dy;
+
+	if (n->parent < 0) {
+		for (int i = 0; i < 8; ++i) {
+			dx = directions[i][0];
+			dy = directions[i][1];
+			if (!dx || !dy || (RLPath_Open(this, x + dx, y) &&
+				RLPath_Open(this, x, y + dy))) {
+				RLPath_Jump(this, node, x, y, dx, dy);
+			}
+		}
+		return;
+	}
+
+	// Only the directions an optimal path through the parent can take next
+	dx = RLPATH_SIGN(x - n->parent % this->width);
+	dy = RLPATH_SIGN(y - n->parent / this->width);
+	if (dx && dy) {
+		const bool h = RLPath_Open(this, x + dx, y);
+		const bool v = RLPath_Open(this, x, y + dy);
+
+		RLPath_Jump(this, node, x, y, dx, 0);
+		RLPath_Jump(this, node, x, y, 0, dy);
+		if (h && v) {
+			RLPath_Jump(this, node, x, y, dx, dy);
+		}
+	}
+	else if (dx) {
+		const bool up = RLPath_Open(this, x, y - 1);
+		const bool down = RLPath_Open(this, x, y + 1);
+
+		RLPath_Jump(this, node, x, y, dx, 0);
+		if (up) {
+			RLPath_Jump(this, node, x, y, 0, -1);
+		}
+		if (down) {
+			RLPath_Jump(this, node, x, y, 0, 1);
+		}
+		if (RLPath_Open(this, x + dx, y)) {
+			if (up) {
+				RLPath_Jump(this, node, x, y, dx, -1);
+			}
+			if (down) {
+				RLPath_Jump(this, node, x, y, dx, 1);
+			}
+		}
+	}
+	else {
+		const bool left = RLPath_Open(this, x - 1, y);
+		const bool right = RLPath_Open(this, x + 1, y);
+
+		RLPath_Jump(this, node, x, y, 0, dy);
+		if (left) {
+			RLPath_Jump(this, node, x, y, -1, 0);
+		}
+		if (right) {
+			RLPath_Jump(this, node, x, y, 1, 0);
+		}
+		if (RLPath_Open(this, x, y + dy)) {
+			if (left) {
+				RLPath_Jump(this, node, x, y, -1, dy);
+			}
+			if (right) {
+				RLPath_Jump(this, node, x, y, 1, dy);
+			}
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static int RLPath_Write(const RLPathFinder *this, int start, int goal,
+	RLPathPoint *path, int max_points)
+{
+	int length = 0, step;
+
+	// Jump points lie on straight or diagonal lines from their parents
+	for (int i = goal; i != start; i = this->nodes[i].parent) {
+		const int p = this->nodes[i].parent;
+		length += MAX(abs(i % this->width - p % this->width),
+			abs(i / this->width - p / this->width));
+	}
+	if (!path) {
+		return length;
+	}
+
+	step = length;
+	for (int i = goal; i != start; i = this->nodes[i].parent) {
+		const int p = this->nodes[i].parent;
+		int x = i % this->width, y = i / this->width;
+		const int dx = RLPATH_SIGN(p % this->width - x);
+		const int dy = RLPATH_SIGN(p / this->width - y);
+
+		for (; x != p % this->width || y != p / this->width; x += dx,
+			y += dy) {
+			if (--step < max_points) {
+				path[step] = (RLPathPoint){x, y};
+			}
+		}
+	}
+
+	return length;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Public functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+RLPathFinder * RLPathFinder_Create(const RLMapGrid *map)
+{
+	RLPathFinder *this = NULL;
+
+	if (!map) {
+		log_warn("NULL argument");
+		return NULL;
+	}
+
+	this = g_new0(RLPathFinder, 1);
+	this->map = map;
+	this->rows = (RLPathLines){
+		RLMapGrid_GetRow(map, RLMAP_WALKABLE, 0),
+		map->words_per_row,
+		map->size.width,
+		map->size.height
+	};
+	this->columns.words = (map->size.height + RLMAP_WORD_BITS - 1) /
+		RLMAP_WORD_BITS;
+	this->columns.length = map->size.height;
+	this->columns.count = map->size.width;
+	this->columns.bits = g_new(uint64_t, (gsize)this->columns.words *
+		(gsize)this->columns.count);
+	RLPath_Transpose(this);
+	this->width = map->size.width;
+	this->num_nodes = map->size.width * map->size.height;
+	this->nodes = g_new0(RLPathNode, (gsize)this->num_nodes);
+	this->heap = g_new(RLPathEntry, (gsize)this->num_nodes);
+	this->cost = -1;
+
+	return this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int RLPathFinder_Find(RLPathFinder *this, RLPathMode mode, int start_x,
+	int start_y, int goal_x, int goal_y, RLPathPoint *path, int max_points)
+{
+	int start, goal;
+
+	if (!this) {
+		log_warn("NULL argument");
+		return -1;
+	}
+
+	this->cost = -1;
+	this->expanded = 0;
+	if (!RLMapGrid_InBounds(this->map, start_x, start_y) ||
+		!RLPath_Open(this, goal_x, goal_y)) {
+		return -1;
+	}
+
+	// Bumping the generation forgets every node, clear them once it wraps
+	if (!++this->generation) {
+		memset(this->nodes, 0, sizeof(RLPathNode) * (size_t)this->num_nodes);
+		this->generation = 1;
+	}
+	if (this->version != this->map->versions[RLMAP_WALKABLE]) {
+		RLPath_Transpose(this);
+	}
+	this->goal.x = goal_x;
+	this->goal.y = goal_y;
+	this->heap_size = 0;
+	start = start_y * this->width + start_x;
+	goal = goal_y * this->width + goal_x;
+	RLPath_Relax(this, -1, start_x, start_y, 0);
+
+	while (this->heap_size) {
+		const int node = RLPath_Pop(this);
+		const int x = node % this->width, y = node / this->width;
+
+		++this->expanded;
+		if (node == goal) {
+			this->cost = this->nodes[goal].g;
+			return RLPath_Write(this, start, goal, path, MAX(max_points, 0));
+		}
+
+		if (mode == RLPATH_JPS) {
+			RLPath_ExpandJPS(this, node, x, y);
+		}
+		else {
+			RLPath_ExpandAStar(this, node, x, y);
+		}
+	}
+
+	return -1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int RLPathFinder_GetCost(const RLPathFinder *this)
+{
+	return CONDBIND(this, log_warn, "NULL argument") ? this->cost : -1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int RLPathFinder_GetExpanded(const RLPathFinder *this)
+{
+	return CONDBIND(this, log_warn, "NULL argument") ? this->expanded : 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLPathFinder_Destroy(RLPathFinder *this)
+{
+	if (CONDBIND(this, log_warn, "NULL argument")) {
+		g_free((uint64_t *)this->columns.bits);
+		g_free(this->nodes);
+		g_free(this->heap);
+		g_free(this);
+	}
+}
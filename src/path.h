@@ -0,0 +1,111 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	path.h
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Grid pathfinding over a map's walkable plane, by A* or jump point
+///			search, reusing its node storage between queries
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef PATH_H
+#define PATH_H
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include "mapgrid.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+// Cost of a step along a row or column, and of a diagonal step
+#define RLPATH_COST_STRAIGHT 10
+#define RLPATH_COST_DIAGONAL 14
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Search algorithm used by a query
+///
+/// RLPATH_ASTAR:	A* expanding every neighbour
+/// RLPATH_JPS:		Jump point search, expanding only the cells where an
+///					optimal path may turn. Finds paths of the same cost as
+///					A* while expanding far fewer nodes on open maps.
+///////////////////////////////////////////////////////////////////////////////
+typedef enum {
+	RLPATH_ASTAR,
+	RLPATH_JPS
+} RLPathMode;
+
+typedef struct {
+	int x;
+	int y;
+} RLPathPoint;
+
+typedef struct _RLPathFinder RLPathFinder;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns a pointer to a new RLPathFinder
+///
+/// Allocates a node per cell of the map once, queries allocate nothing.
+/// The map must outlive the RLPathFinder, its size must not change.
+///
+/// \param	map	Map whose RLMAP_WALKABLE plane gives the passable cells
+///
+/// \return	Pointer to the new RLPathFinder
+///////////////////////////////////////////////////////////////////////////////
+RLPathFinder * RLPathFinder_Create(const RLMapGrid *map);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Finds a shortest path between two cells
+///
+/// Moves go to any of the eight neighbours, but a diagonal move needs both
+/// cells it passes between to be walkable. The start cell need not be.
+///
+/// The path is written from the first step to the goal, without the start.
+/// When it has more than max_points steps, only the first max_points are
+/// written, so a monster wanting one step can pass a single point.
+///
+/// \param	this		An RLPathFinder
+/// \param	mode		Search algorithm
+/// \param	start_x		Column of the start
+/// \param	start_y		Row of the start
+/// \param	goal_x		Column of the goal
+/// \param	goal_y		Row of the goal
+/// \param	path		Destination for the steps, may be NULL
+/// \param	max_points	Number of steps path has room for
+///
+/// \return	Number of steps of the whole path, -1 if there is none
+///////////////////////////////////////////////////////////////////////////////
+int RLPathFinder_Find(RLPathFinder *this, RLPathMode mode, int start_x,
+	int start_y, int goal_x, int goal_y, RLPathPoint *path, int max_points);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns the cost of the last path found
+///
+/// \param	this	An RLPathFinder
+///
+/// \return	Cost in RLPATH_COST_STRAIGHT and RLPATH_COST_DIAGONAL units, -1
+///			if the last query found no path
+///////////////////////////////////////////////////////////////////////////////
+int RLPathFinder_GetCost(const RLPathFinder *this);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns the number of nodes the last query expanded
+///
+/// \param	this	An RLPathFinder
+///
+/// \return	Number of nodes taken off the open list
+///////////////////////////////////////////////////////////////////////////////
+int RLPathFinder_GetExpanded(const RLPathFinder *this);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Frees the memory associated with an RLPathFinder
+///
+/// \param	this	An RLPathFinder
+///////////////////////////////////////////////////////////////////////////////
+void RLPathFinder_Destroy(RLPathFinder *this);
+
+#endif
@@ -0,0 +1,223 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	pngwrite.c
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Minimal PNG encoder writing uncompressed (stored) deflate blocks
+///////////////////////////////////////////////////////////////////////////////
+
+#include "pngwrite.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "log.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+// Largest payload of a stored deflate block
+#define PNG_BLOCK 65535
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+	FILE *file;
+	uint32_t crc;
+	uint32_t adler[2];
+	uint64_t remaining;
+	uint32_t block_left;
+} PNGWriter;
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static variables
+///////////////////////////////////////////////////////////////////////////////
+
+static const unsigned char signature[8] = {137, 80, 78, 71, 13, 10, 26, 10};
+static const int color_types[5] = {0, 0, 4, 2, 6};
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+static uint32_t PNG_Crc(uint32_t crc, const unsigned char *data, size_t size)
+{
+	static uint32_t table[256];
+	static bool ready = false;
+
+	if (!ready) {
+		for (uint32_t n = 0; n < 256; ++n) {
+			uint32_t c = n;
+			for (int k = 0; k < 8; ++k) {
+				c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+			}
+			table[n] = c;
+		}
+		ready = true;
+	}
+
+	for (size_t i = 0; i < size; ++i) {
+		crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+	}
+
+	return crc;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void PNG_Put(PNGWriter *this, const unsigned char *data, size_t size)
+{
+	fwrite(data, 1, size, this->file);
+	this->crc = PNG_Crc(this->crc, data, size);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void PNG_Put32(PNGWriter *this, uint32_t value)
+{
+	const unsigned char bytes[4] = {
+		(unsigned char)(value >> 24),
+		(unsigned char)(value >> 16),
+		(unsigned char)(value >> 8),
+		(unsigned char)value
+	};
+
+	PNG_Put(this, bytes, sizeof(bytes));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void PNG_BeginChunk(PNGWriter *this, const char *type, uint32_t size)
+{
+	PNG_Put32(this, size);
+	this->crc = 0xFFFFFFFFu;
+	PNG_Put(this, (const unsigned char *)type, 4);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void PNG_EndChunk(PNGWriter *this)
+{
+	PNG_Put32(this, this->crc ^ 0xFFFFFFFFu);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void PNG_Deflate(PNGWriter *this, const unsigned char *data,
+	size_t size)
+{
+	// Zlib's adler32 with the modulo deferred as long as it cannot overflow
+	for (size_t i = 0; i < size; ++i) {
+		this->adler[0] += data[i];
+		this->adler[1] += this->adler[0];
+		if (!(i % 5552)) {
+			this->adler[0] %= 65521;
+			this->adler[1] %= 65521;
+		}
+	}
+	this->adler[0] %= 65521;
+	this->adler[1] %= 65521;
+
+	while (size) {
+		size_t run;
+
+		if (!this->block_left) {
+			const uint32_t len = (uint32_t)(this->remaining < PNG_BLOCK ?
+				this->remaining : PNG_BLOCK);
+			const unsigned char header[5] = {
+				this->remaining == len,
+				(unsigned char)len,
+				(unsigned char)(len >> 8),
+				(unsigned char)~len,
+				(unsigned char)(~len >> 8)
+			};
+			PNG_Put(this, header, sizeof(header));
+			this->block_left = len;
+		}
+
+		run = size < this->block_left ? size : this->block_left;
+		PNG_Put(this, data, run);
+		data += run;
+		size -= run;
+		this->block_left -= (uint32_t)run;
+		this->remaining -= run;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Public functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+bool PNG_Write(const char *path, const unsigned char *pixels, int width,
+	int height, int channels, int stride)
+{
+	PNGWriter writer = {NULL, 0, {1, 0}, 0, 0};
+	const unsigned char zlib[2] = {0x78, 0x01}, filter = 0;
+	uint64_t raw, blocks, size;
+	bool ok;
+
+	if (!path || !pixels) {
+		log_warn("NULL argument");
+		return false;
+	}
+	else if (width <= 0 || height <= 0 || channels < 1 || channels > 4) {
+		log_warn("Invalid image format");
+		return false;
+	}
+
+	// Every row is prefixed with its filter type, always none here
+	raw = (uint64_t)height * (1 + (uint64_t)width * (uint64_t)channels);
+	blocks = (raw + PNG_BLOCK - 1) / PNG_BLOCK;
+	size = 2 + raw + 5 * blocks + 4;
+	if (size > 0x7FFFFFFF) {
+		log_warn("Image too large for a single PNG chunk");
+		return false;
+	}
+
+	if (!(writer.file = fopen(path, "wb"))) {
+		logfmt_warn("Could not open %s for writing", path);
+		return false;
+	}
+
+	fwrite(signature, 1, sizeof(signature), writer.file);
+
+	PNG_BeginChunk(&writer, "IHDR", 13);
+	PNG_Put32(&writer, (uint32_t)width);
+	PNG_Put32(&writer, (uint32_t)height);
+	PNG_Put(&writer, (const unsigned char[5]){
+		8,
+		(unsigned char)color_types[channels],
+		0,
+		0,
+		0
+	}, 5);
+	PNG_EndChunk(&writer);
+
+	PNG_BeginChunk(&writer, "IDAT", (uint32_t)size);
+	PNG_Put(&writer, zlib, sizeof(zlib));
+	writer.remaining = raw;
+	for (int y = 0; y < height; ++y) {
+		PNG_Deflate(&writer, &filter, 1);
+		PNG_Deflate(
+			&writer,
+			pixels + (ptrdiff_t)y * stride,
+			(size_t)width * (size_t)channels
+			);
+	}
+	PNG_Put32(&writer, writer.adler[1] << 16 | writer.adler[0]);
+	PNG_EndChunk(&writer);
+
+	PNG_BeginChunk(&writer, "IEND", 0);
+	PNG_EndChunk(&writer);
+
+	ok = !ferror(writer.file);
+	if (fclose(writer.file) || !ok) {
+		logfmt_warn("Could not write %s", path);
+		return false;
+	}
+
+	return true;
+}
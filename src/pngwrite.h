@@ -0,0 +1,35 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	pngwrite.h
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Minimal PNG encoder writing uncompressed (stored) deflate blocks
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef PNGWRITE_H
+#define PNGWRITE_H
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdbool.h>
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Writes 8-bit pixels to a PNG file
+///
+/// The image data is not compressed, which keeps the encoder small and
+/// fast at the cost of file size. A negative stride writes the rows
+/// bottom-up, i.e. pass the last row of an OpenGL read back with -stride.
+///
+/// \param	path		Path of the file to write
+/// \param	pixels		First row of the image
+/// \param	width		Width of the image in pixels
+/// \param	height		Height of the image in pixels
+/// \param	channels	1 (grey), 2 (grey alpha), 3 (RGB) or 4 (RGBA)
+/// \param	stride		Bytes from the start of one row to the next
+///
+/// \return	true on success
+///////////////////////////////////////////////////////////////////////////////
+bool PNG_Write(const char *path, const unsigned char *pixels, int width,
+	int height, int channels, int stride);
+
+#endif
@@ -0,0 +1,351 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	profiler.c
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Per-frame CPU and GPU timings of the major frame phases, shown as
+///			a text overlay
+///////////////////////////////////////////////////////////////////////////////
+
+#include "profiler.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdint.h>
+#include <glib.h>
+#include <SDL2/SDL.h>
+
+#include "log.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+// Frame time at the top of the graph and the budget lines it is coloured by
+#define PROFILER_GRAPH_MS 33.3
+#define PROFILER_GRAPH_ROWS 4
+#define PROFILER_BUDGET_MS 16.7
+
+// Lower one eighth block, followed by the seven taller block elements
+#define PROFILER_BLOCK 0x2581
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// Queries issued during one frame, read back PROFILER_LATENCY frames later
+///////////////////////////////////////////////////////////////////////////////
+typedef struct {
+	uint64_t frame;
+	int num_sections;
+	GLuint queries[PROFILER_SECTIONS];
+	ProfileZone zones[PROFILER_SECTIONS];
+} ProfileSlot;
+
+typedef struct {
+	double cpu[PROFILE_NUM_ZONES];
+	double gpu[PROFILE_NUM_ZONES];
+	double frame;
+	bool has_gpu;
+} ProfileSample;
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static variables
+///////////////////////////////////////////////////////////////////////////////
+
+static const char *zone_names[PROFILE_NUM_ZONES] = {
+	"events",
+	"mesh",
+	"upload",
+	"draw",
+	"swap"
+};
+
+static struct {
+	bool initialized;
+	bool enabled;
+	bool in_frame;
+	bool in_query;
+	bool open[PROFILE_NUM_ZONES];
+	uint64_t frame;
+	Uint64 frequency;
+	Uint64 frame_start;
+	Uint64 starts[PROFILE_NUM_ZONES];
+	ProfileSlot slots[PROFILER_LATENCY];
+	ProfileSample history[PROFILER_HISTORY];
+} profiler;
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+static double Profiler_ToMs(Uint64 ticks)
+{
+	return (double)ticks * 1000.0 / (double)profiler.frequency;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Profiler_Collect(ProfileSlot *slot)
+{
+	ProfileSample *sample = NULL;
+	GLint available = 0;
+	GLuint64 elapsed = 0;
+
+	if (!slot->num_sections) {
+		return;
+	}
+
+	// Skip rather than stall when the GPU is more than a ring behind
+	glGetQueryObjectiv(
+		slot->queries[slot->num_sections - 1],
+		GL_QUERY_RESULT_AVAILABLE,
+		&available
+		);
+	if (available) {
+		sample = &profiler.history[slot->frame % PROFILER_HISTORY];
+		for (int i = 0; i < slot->num_sections; ++i) {
+			glGetQueryObjectui64v(
+				slot->queries[i],
+				GL_QUERY_RESULT,
+				&elapsed
+				);
+			sample->gpu[slot->zones[i]] += (double)elapsed / 1000000.0;
+		}
+		sample->has_gpu = true;
+	}
+
+	slot->num_sections = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Profiler_Text(RLTileMap *map, int x, int y, const char *text,
+	RLColor color)
+{
+	RLTile *tile = NULL;
+
+	for (int i = 0; text[i]; ++i) {
+		if ((tile = RLTileMap_GetTile(map, x + i, y))) {
+			*tile = RLTile_Make(text[i], RLTILE_TEXT, color, tile->bg);
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Profiler_Graph(RLTileMap *map, int left, int top, int width)
+{
+	const int columns = MIN(width, PROFILER_HISTORY);
+
+	// Newest frame on the right, one column per frame
+	for (int i = 0; i < columns; ++i) {
+		const uint64_t frame = profiler.frame - (uint64_t)(columns - i);
+		const double ms = frame && frame < profiler.frame ?
+			profiler.history[frame % PROFILER_HISTORY].frame : 0.0;
+		const RLColor color = ms > PROFILER_GRAPH_MS ? RLCOLOR(255, 80, 80,
+			255) : ms > PROFILER_BUDGET_MS ? RLCOLOR(255, 220, 80, 255) :
+			RLCOLOR(80, 220, 120, 255);
+		int eighths = (int)(MIN(ms / PROFILER_GRAPH_MS, 1.0) *
+			PROFILER_GRAPH_ROWS * 8.0 + 0.5);
+
+		for (int row = PROFILER_GRAPH_ROWS - 1; row >= 0 && eighths > 0;
+			--row) {
+			RLTile *tile = RLTileMap_GetTile(map, left + i, top + row);
+			if (!tile) {
+				break;
+			}
+			// Full cells are solid background, the top cell a block glyph
+			if (eighths >= 8) {
+				tile->bg = color;
+			}
+			else {
+				*tile = RLTile_Make(
+					PROFILER_BLOCK + eighths - 1,
+					RLTILE_EXACT,
+					color,
+					tile->bg
+					);
+			}
+			eighths -= 8;
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Public functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+void Profiler_Init(void)
+{
+	if (profiler.initialized) {
+		log_warn("Profiler already initialized");
+		return;
+	}
+
+	profiler.frequency = SDL_GetPerformanceFrequency();
+	for (int i = 0; i < PROFILER_LATENCY; ++i) {
+		glGenQueries(PROFILER_SECTIONS, profiler.slots[i].queries);
+	}
+	profiler.initialized = true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Profiler_SetEnabled(bool enabled)
+{
+	profiler.enabled = enabled && profiler.initialized;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Profiler_BeginFrame(void)
+{
+	ProfileSlot *slot = NULL;
+
+	if (!profiler.enabled || profiler.in_frame) {
+		return;
+	}
+
+	++profiler.frame;
+	slot = &profiler.slots[profiler.frame % PROFILER_LATENCY];
+	Profiler_Collect(slot);
+	slot->frame = profiler.frame;
+
+	profiler.history[profiler.frame % PROFILER_HISTORY] =
+		(ProfileSample){{0.0}, {0.0}, 0.0, false};
+	profiler.frame_start = SDL_GetPerformanceCounter();
+	profiler.in_frame = true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Profiler_Begin(ProfileZone zone)
+{
+	ProfileSlot *slot = &profiler.slots[profiler.frame % PROFILER_LATENCY];
+
+	if (!profiler.enabled || !profiler.in_frame || profiler.in_query) {
+		return;
+	}
+
+	profiler.open[zone] = true;
+	profiler.starts[zone] = SDL_GetPerformanceCounter();
+	if (slot->num_sections < PROFILER_SECTIONS) {
+		slot->zones[slot->num_sections] = zone;
+		glBeginQuery(GL_TIME_ELAPSED, slot->queries[slot->num_sections]);
+		profiler.in_query = true;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Profiler_End(ProfileZone zone)
+{
+	ProfileSlot *slot = &profiler.slots[profiler.frame % PROFILER_LATENCY];
+
+	// Closes sections even if profiling was switched off inside them
+	if (!profiler.open[zone]) {
+		return;
+	}
+
+	profiler.open[zone] = false;
+	profiler.history[profiler.frame % PROFILER_HISTORY].cpu[zone] +=
+		Profiler_ToMs(SDL_GetPerformanceCounter() - profiler.starts[zone]);
+	if (profiler.in_query) {
+		glEndQuery(GL_TIME_ELAPSED);
+		++slot->num_sections;
+		profiler.in_query = false;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Profiler_EndFrame(void)
+{
+	if (!profiler.in_frame) {
+		return;
+	}
+
+	profiler.history[profiler.frame % PROFILER_HISTORY].frame =
+		Profiler_ToMs(SDL_GetPerformanceCounter() - profiler.frame_start);
+	profiler.in_frame = false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Profiler_Write(RLTileMap *map)
+{
+	const RLColor text = RLCOLOR(230, 230, 230, 255);
+	const RLColor dim = RLCOLOR(150, 150, 150, 255);
+	double cpu[PROFILE_NUM_ZONES] = {0.0}, gpu[PROFILE_NUM_ZONES] = {0.0};
+	double frame = 0.0, gpu_frame = 0.0;
+	int frames = 0, gpu_frames = 0, left, row = 1;
+	char line[PROFILER_WIDTH + 1];
+
+	if (!map) {
+		log_warn("NULL argument");
+		return;
+	}
+
+	// Averages over completed frames, GPU ones over those read back
+	for (uint64_t f = profiler.frame > PROFILER_HISTORY ?
+		profiler.frame - PROFILER_HISTORY : 1; f < profiler.frame; ++f) {
+		const ProfileSample *sample = &profiler.history[f % PROFILER_HISTORY];
+		for (int z = 0; z < PROFILE_NUM_ZONES; ++z) {
+			cpu[z] += sample->cpu[z];
+			if (sample->has_gpu) {
+				gpu[z] += sample->gpu[z];
+				gpu_frame += sample->gpu[z];
+			}
+		}
+		frame += sample->frame;
+		gpu_frames += sample->has_gpu;
+		++frames;
+	}
+	frames = MAX(frames, 1);
+	gpu_frames = MAX(gpu_frames, 1);
+
+	RLTile_Fill(
+		map->tiles,
+		(size_t)map->num_tiles,
+		RLTile_Make(0, RLTILE_TEXT, 0, 0)
+		);
+	left = MAX(map->size.width - PROFILER_WIDTH, 0);
+	RLTile_BlendRect(
+		map->tiles,
+		map->size.width,
+		map->size.height,
+		left,
+		row,
+		PROFILER_WIDTH,
+		PROFILE_NUM_ZONES + PROFILER_GRAPH_ROWS + 3,
+		RLTILE_BG,
+		RLCOLOR(0, 0, 0, 190)
+		);
+
+	snprintf(line, sizeof(line), " %-10s %8s %8s", "phase", "cpu ms",
+		"gpu ms");
+	Profiler_Text(map, left, row++, line, dim);
+	for (int z = 0; z < PROFILE_NUM_ZONES; ++z) {
+		snprintf(line, sizeof(line), " %-10s %8.3f %8.3f", zone_names[z],
+			cpu[z] / frames, gpu[z] / gpu_frames);
+		Profiler_Text(map, left, row++, line, text);
+	}
+	snprintf(line, sizeof(line), " %-10s %8.3f %8.3f", "frame",
+		frame / frames, gpu_frame / gpu_frames);
+	Profiler_Text(map, left, row++, line, text);
+	snprintf(line, sizeof(line), " %d frame average, graph %.1f ms",
+		PROFILER_HISTORY, PROFILER_GRAPH_MS);
+	Profiler_Text(map, left, row++, line, dim);
+
+	Profiler_Graph(map, left + 1, row, PROFILER_WIDTH - 2);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Profiler_Quit(void)
+{
+	if (!profiler.initialized) {
+		return;
+	}
+
+	for (int i = 0; i < PROFILER_LATENCY; ++i) {
+		glDeleteQueries(PROFILER_SECTIONS, profiler.slots[i].queries);
+	}
+	profiler.initialized = false;
+	profiler.enabled = false;
+}
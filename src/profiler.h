@@ -0,0 +1,119 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	profiler.h
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Per-frame CPU and GPU timings of the major frame phases, shown as
+///			a text overlay
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdbool.h>
+
+#include "tilemap.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+// Frames a GPU timing may take to come back before it is dropped
+#define PROFILER_LATENCY 4
+
+// Timed sections per frame, further sections are only timed on the CPU
+#define PROFILER_SECTIONS 64
+
+// Frames the averages and the graph cover
+#define PROFILER_HISTORY 120
+
+// Columns taken by the overlay panel
+#define PROFILER_WIDTH 42
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Frame phases
+///
+/// PROFILE_EVENTS:	Event pump
+/// PROFILE_MESH:	Meshing tiles into the vertex buffer
+/// PROFILE_UPLOAD:	Mapping and unmapping the vertex buffer
+/// PROFILE_DRAW:	Draw calls
+/// PROFILE_SWAP:	Buffer swap
+///////////////////////////////////////////////////////////////////////////////
+typedef enum {
+	PROFILE_EVENTS,
+	PROFILE_MESH,
+	PROFILE_UPLOAD,
+	PROFILE_DRAW,
+	PROFILE_SWAP,
+	PROFILE_NUM_ZONES
+} ProfileZone;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Creates the timer queries, profiling starts disabled
+///
+/// Requires a current OpenGL context.
+///////////////////////////////////////////////////////////////////////////////
+void Profiler_Init(void);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Turns timing on or off
+///
+/// While off every other call returns immediately.
+///
+/// \param	enabled	Whether to time frames
+///////////////////////////////////////////////////////////////////////////////
+void Profiler_SetEnabled(bool enabled);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Starts timing a frame, does nothing if one is already started
+///
+/// Collects the GPU timings of the frame PROFILER_LATENCY frames ago if
+/// they are ready, without waiting for them.
+///////////////////////////////////////////////////////////////////////////////
+void Profiler_BeginFrame(void);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Starts timing a section of a frame phase
+///
+/// Sections must not nest, since only one GL_TIME_ELAPSED query can be
+/// active at a time. A phase may be timed in several sections per frame,
+/// their times are summed.
+///
+/// \param	zone	Phase the section belongs to
+///////////////////////////////////////////////////////////////////////////////
+void Profiler_Begin(ProfileZone zone);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Stops timing the current section
+///
+/// \param	zone	Phase passed to Profiler_Begin
+///////////////////////////////////////////////////////////////////////////////
+void Profiler_End(ProfileZone zone);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Stops timing the frame
+///////////////////////////////////////////////////////////////////////////////
+void Profiler_EndFrame(void);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Writes the averages and a frame time graph into a tile map
+///
+/// The panel takes PROFILER_WIDTH columns at the top right of the map.
+/// The rest of the map is cleared.
+///
+/// \param	map	Screen space tile map drawn above everything else
+///////////////////////////////////////////////////////////////////////////////
+void Profiler_Write(RLTileMap *map);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Frees the timer queries
+///////////////////////////////////////////////////////////////////////////////
+void Profiler_Quit(void);
+
+#endif
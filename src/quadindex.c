@@ -0,0 +1,96 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	quadindex.c
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Process-wide 16-bit index buffer shared by every quad mesh
+///////////////////////////////////////////////////////////////////////////////
+
+#include "quadindex.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <glib.h>
+
+#include "log.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static variables
+///////////////////////////////////////////////////////////////////////////////
+
+static GLuint IBO = 0;
+
+///////////////////////////////////////////////////////////////////////////////
+/// Public functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+void QuadIndex_Init(void)
+{
+	GLushort *indices = NULL;
+
+	if (IBO) {
+		log_warn("Quad index buffer already initialized");
+		return;
+	}
+
+	indices = g_new(GLushort, QUADINDEX_CHUNK_QUADS * 6);
+	for (int i = 0; i < QUADINDEX_CHUNK_QUADS; ++i) {
+		GLushort *quad = indices + i * 6;
+		const int base = i * 4;
+		quad[0] = (GLushort)(base + 0);
+		quad[1] = (GLushort)(base + 1);
+		quad[2] = (GLushort)(base + 3);
+		quad[3] = (GLushort)(base + 1);
+		quad[4] = (GLushort)(base + 2);
+		quad[5] = (GLushort)(base + 3);
+	}
+
+	// Unbind any VAO so the element binding is not recorded into it
+	glBindVertexArray(0);
+	glGenBuffers(1, &IBO);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO);
+	glBufferData(
+		GL_ELEMENT_ARRAY_BUFFER,
+		QUADINDEX_CHUNK_QUADS * 6 * (GLsizeiptr)sizeof(GLushort),
+		indices,
+		GL_STATIC_DRAW
+		);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+	g_free(indices);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void QuadIndex_Bind(void)
+{
+	if (!IBO) {
+		log_exit("Quad index buffer used before initialization");
+	}
+
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void QuadIndex_Draw(int num_quads, GLint base_vertex)
+{
+	for (int first = 0; first < num_quads; first += QUADINDEX_CHUNK_QUADS) {
+		const int count = MIN(num_quads - first, QUADINDEX_CHUNK_QUADS);
+		glDrawElementsBaseVertex(
+			GL_TRIANGLES,
+			count * 6,
+			GL_UNSIGNED_SHORT,
+			0,
+			base_vertex + first * 4
+			);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void QuadIndex_Quit(void)
+{
+	if (IBO) {
+		glDeleteBuffers(1, &IBO);
+		IBO = 0;
+	}
+}
@@ -0,0 +1,54 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	quadindex.h
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Process-wide 16-bit index buffer shared by every quad mesh
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef QUADINDEX_H
+#define QUADINDEX_H
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include "glad.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Number of quads addressable by one chunk of 16-bit indices
+///
+/// Four vertices per quad, so a chunk spans exactly 65536 vertices.
+///////////////////////////////////////////////////////////////////////////////
+#define QUADINDEX_CHUNK_QUADS 16384
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Generates the shared index buffer
+///
+/// Every quad uses the 0-1-3 / 1-2-3 pattern, so a single chunk of indices
+/// is drawn repeatedly with a different base vertex for meshes of any size.
+/// Requires a current OpenGL context.
+///////////////////////////////////////////////////////////////////////////////
+void QuadIndex_Init(void);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Binds the shared index buffer to the currently bound VAO
+///////////////////////////////////////////////////////////////////////////////
+void QuadIndex_Bind(void);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Draws consecutive quads from the currently bound VAO
+///
+/// \param	num_quads	Number of quads to draw
+/// \param	base_vertex	Index of the first vertex of the first quad
+///////////////////////////////////////////////////////////////////////////////
+void QuadIndex_Draw(int num_quads, GLint base_vertex);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Deletes the shared index buffer
+///////////////////////////////////////////////////////////////////////////////
+void QuadIndex_Quit(void);
+
+#endif
@@ -0,0 +1,467 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	regions.c
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Connected regions of a map's walkable plane, answering whether
+///			one cell can reach another without a search
+///////////////////////////////////////////////////////////////////////////////
+
+#include "regions.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+#include <glib.h>
+
+#include "common.h"
+#include "log.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+// A closed cell splits its region in at most as many parts as it has
+// neighbours along rows and columns
+#define RLREGIONS_MAX_FLOODS 4
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// Breadth first flood from one side of a closed cell. The cells it reached
+/// stay in the queue, so a side that runs out can be relabelled from it.
+///////////////////////////////////////////////////////////////////////////////
+typedef struct {
+	int *cells;
+	int head;
+	int size;
+	int capacity;
+	// Flood this one met, itself while it has met none
+	int set;
+} RLRegionsFlood;
+
+struct _RLRegions {
+	const RLMapGrid *map;
+	// Walkable plane version the labels are up to date with
+	uint32_t version;
+	int width;
+	int num_cells;
+	// Label of every cell, 0 where it is not walkable
+	int *labels;
+	// Union-find forest of the labels, merged as cells open
+	int *parents;
+	int num_labels;
+	int max_labels;
+	// Cells reached by the floods of a split, those with the split's stamp
+	uint32_t *marks;
+	uint8_t *owners;
+	uint32_t stamp;
+	RLRegionsFlood floods[RLREGIONS_MAX_FLOODS];
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static variables
+///////////////////////////////////////////////////////////////////////////////
+
+static const int directions[4][2] = {
+	{1, 0}, {-1, 0}, {0, 1}, {0, -1}
+};
+
+// Neighbours of a cell in order around it, starting north. The even ones
+// share a side with the cell.
+static const int ring[8][2] = {
+	{0, -1}, {1, -1}, {1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+static int RLRegions_Find(RLRegions *this, int label)
+{
+	// Path halving
+	while (this->parents[label] != label) {
+		this->parents[label] = this->parents[this->parents[label]];
+		label = this->parents[label];
+	}
+
+	return label;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static int RLRegions_NewLabel(RLRegions *this)
+{
+	if (this->num_labels == this->max_labels) {
+		this->max_labels *= 2;
+		this->parents = g_renew(int, this->parents, (gsize)this->max_labels);
+	}
+
+	this->parents[this->num_labels] = this->num_labels;
+	return this->num_labels++;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static int RLRegions_Scan(const uint64_t *row, int x, int end, bool set)
+{
+	// First cell from x whose flag is set, or unset
+	while (x < end) {
+		const uint64_t word = set ? row[x / RLMAP_WORD_BITS] :
+			~row[x / RLMAP_WORD_BITS];
+
+		if (word >> (x % RLMAP_WORD_BITS)) {
+			return MIN(x + __builtin_ctzll(word >> (x % RLMAP_WORD_BITS)),
+				end);
+		}
+		x = (x / RLMAP_WORD_BITS + 1) * RLMAP_WORD_BITS;
+	}
+
+	return end;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLRegions_Label(RLRegions *this)
+{
+	const int width = this->width;
+
+	this->num_labels = 1;
+	this->parents[0] = 0;
+
+	// Each run of walkable cells takes the labels of the runs above it,
+	// joining them, or a new one if there are none
+	for (int y = 0; y < this->map->size.height; ++y) {
+		const uint64_t *row = RLMapGrid_GetRow(this->map, RLMAP_WALKABLE, y);
+		int *labels = this->labels + y * width;
+		int x = 0;
+
+		while (x < width) {
+			const int start = RLRegions_Scan(row, x, width, true);
+			const int end = RLRegions_Scan(row, start, width, false);
+			int label = 0;
+
+			for (int i = x; i < start; ++i) {
+				labels[i] = 0;
+			}
+			for (int i = start; y > 0 && i < end; ++i) {
+				int above = labels[i - width];
+
+				if (!above || (i > start && above == labels[i - width - 1])) {
+					continue;
+				}
+				above = RLRegions_Find(this, above);
+				if (!label) {
+					label = above;
+				}
+				else if (above != label) {
+					this->parents[above] = label;
+				}
+			}
+			if (!label && start < end) {
+				label = RLRegions_NewLabel(this);
+			}
+			for (int i = start; i < end; ++i) {
+				labels[i] = label;
+			}
+			x = end;
+		}
+	}
+
+	for (int i = 0; i < this->num_cells; ++i) {
+		this->labels[i] = RLRegions_Find(this, this->labels[i]);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLRegions_Open(RLRegions *this, int x, int y)
+{
+	int root = 0;
+
+	for (int i = 0; i < 4; ++i) {
+		const int nx = x + directions[i][0], ny = y + directions[i][1];
+		int r;
+
+		if (!RLMapGrid_InBounds(this->map, nx, ny) ||
+			!this->labels[ny * this->width + nx]) {
+			continue;
+		}
+		r = RLRegions_Find(this, this->labels[ny * this->width + nx]);
+		if (!root) {
+			root = r;
+		}
+		else if (r != root) {
+			this->parents[r] = root;
+		}
+	}
+
+	this->labels[y * this->width + x] = root ? root :
+		RLRegions_NewLabel(this);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLRegions_Push(RLRegions *this, int flood, int cell)
+{
+	RLRegionsFlood *f = &this->floods[flood];
+
+	if (f->size == f->capacity) {
+		f->capacity = MAX(64, f->capacity * 2);
+		f->cells = g_renew(int, f->cells, (gsize)f->capacity);
+	}
+
+	f->cells[f->size++] = cell;
+	this->marks[cell] = this->stamp;
+	this->owners[cell] = (uint8_t)flood;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static int RLRegions_Root(const RLRegions *this, int flood)
+{
+	while (this->floods[flood].set != flood) {
+		flood = this->floods[flood].set;
+	}
+
+	return flood;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static bool RLRegions_Exhausted(const RLRegions *this, int num_floods,
+	int root)
+{
+	for (int i = 0; i < num_floods; ++i) {
+		const RLRegionsFlood *f = &this->floods[i];
+
+		if (f->head < f->size && RLRegions_Root(this, i) == root) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLRegions_Split(RLRegions *this, const int *seeds, int num_floods)
+{
+	int live = num_floods;
+
+	// Bumping the stamp forgets every mark, clear them once it wraps
+	if (!++this->stamp) {
+		memset(this->marks, 0, sizeof(uint32_t) * (size_t)this->num_cells);
+		this->stamp = 1;
+	}
+	for (int i = 0; i < num_floods; ++i) {
+		this->floods[i].head = 0;
+		this->floods[i].size = 0;
+		this->floods[i].set = i;
+		RLRegions_Push(this, i, seeds[i]);
+	}
+
+	// The floods take turns a cell at a time. Floods that meet join, and
+	// keep going together. Joined floods that run out are a region of
+	// their own. The last one left keeps the old label.
+	while (live > 1) {
+		for (int i = 0; i < num_floods && live > 1; ++i) {
+			RLRegionsFlood *f = &this->floods[i];
+			int cell, x, y, root;
+
+			if (f->head == f->size) {
+				continue;
+			}
+
+			cell = f->cells[f->head++];
+			x = cell % this->width;
+			y = cell / this->width;
+			for (int d = 0; d < 4; ++d) {
+				const int nx = x + directions[d][0], ny = y + directions[d][1];
+				const int n = ny * this->width + nx;
+				int other;
+
+				if (!RLMapGrid_InBounds(this->map, nx, ny) || !this->labels[n]) {
+					continue;
+				}
+				if (this->marks[n] != this->stamp) {
+					RLRegions_Push(this, i, n);
+					continue;
+				}
+				other = RLRegions_Root(this, this->owners[n]);
+				root = RLRegions_Root(this, i);
+				if (other != root) {
+					this->floods[root].set = other;
+					--live;
+				}
+			}
+
+			root = RLRegions_Root(this, i);
+			if (f->head == f->size && live > 1 &&
+				RLRegions_Exhausted(this, num_floods, root)) {
+				const int label = RLRegions_NewLabel(this);
+
+				for (int j = 0; j < num_floods; ++j) {
+					const RLRegionsFlood *g = &this->floods[j];
+
+					if (RLRegions_Root(this, j) != root) {
+						continue;
+					}
+					for (int k = 0; k < g->size; ++k) {
+						this->labels[g->cells[k]] = label;
+					}
+				}
+				--live;
+			}
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLRegions_Close(RLRegions *this, int x, int y)
+{
+	int seeds[RLREGIONS_MAX_FLOODS], num_seeds = 0, first = -1;
+	bool open[8], seeded = false;
+
+	this->labels[y * this->width + x] = 0;
+	for (int i = 0; i < 8; ++i) {
+		const int nx = x + ring[i][0], ny = y + ring[i][1];
+
+		open[i] = RLMapGrid_InBounds(this->map, nx, ny) &&
+			this->labels[ny * this->width + nx];
+		if (!open[i] && first < 0) {
+			first = i;
+		}
+	}
+	if (first < 0) {
+		return;
+	}
+
+	// Neighbours on one unbroken arc of walkable cells around the closed
+	// cell stay joined through it, one flood per arc is enough
+	for (int i = 1; i <= 8; ++i) {
+		const int p = (first + i) % 8;
+
+		if (!open[p]) {
+			seeded = false;
+		}
+		else if (!(p % 2) && !seeded) {
+			seeds[num_seeds++] = (y + ring[p][1]) * this->width + x + ring[p][0];
+			seeded = true;
+		}
+	}
+
+	if (num_seeds > 1) {
+		RLRegions_Split(this, seeds, num_seeds);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLRegions_Sync(RLRegions *this)
+{
+	if (this->version != this->map->versions[RLMAP_WALKABLE]) {
+		RLRegions_Label(this);
+		this->version = this->map->versions[RLMAP_WALKABLE];
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Public functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+RLRegions * RLRegions_Create(const RLMapGrid *map)
+{
+	RLRegions *this = NULL;
+
+	if (!map) {
+		log_warn("NULL argument");
+		return NULL;
+	}
+
+	this = g_new0(RLRegions, 1);
+	this->map = map;
+	this->width = map->size.width;
+	this->num_cells = map->size.width * map->size.height;
+	this->labels = g_new(int, (gsize)this->num_cells);
+	this->max_labels = this->num_cells + 1;
+	this->parents = g_new(int, (gsize)this->max_labels);
+	this->marks = g_new0(uint32_t, (gsize)this->num_cells);
+	this->owners = g_new(uint8_t, (gsize)this->num_cells);
+
+	RLRegions_Label(this);
+	this->version = map->versions[RLMAP_WALKABLE];
+
+	return this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLRegions_Update(RLRegions *this, int x, int y)
+{
+	const int *label = NULL;
+	bool walkable;
+
+	if (!this) {
+		log_warn("NULL argument");
+		return;
+	}
+	if (!RLMapGrid_InBounds(this->map, x, y)) {
+		return;
+	}
+
+	// Anything more than this one change since the last is relabelled
+	if (this->map->versions[RLMAP_WALKABLE] - this->version != 1) {
+		RLRegions_Sync(this);
+		return;
+	}
+
+	label = &this->labels[y * this->width + x];
+	walkable = RLMapGrid_GetBit(this->map, RLMAP_WALKABLE, x, y);
+	if (walkable && !*label) {
+		RLRegions_Open(this, x, y);
+	}
+	else if (!walkable && *label) {
+		RLRegions_Close(this, x, y);
+	}
+
+	// Labels left behind by merges and splits pile up, start afresh when
+	// they outnumber the cells
+	if (this->num_labels > 2 * this->num_cells) {
+		RLRegions_Label(this);
+	}
+	this->version = this->map->versions[RLMAP_WALKABLE];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int RLRegions_GetRegion(RLRegions *this, int x, int y)
+{
+	if (!this) {
+		log_warn("NULL argument");
+		return 0;
+	}
+
+	RLRegions_Sync(this);
+	if (!RLMapGrid_InBounds(this->map, x, y)) {
+		return 0;
+	}
+
+	return RLRegions_Find(this, this->labels[y * this->width + x]);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool RLRegions_Reachable(RLRegions *this, int x1, int y1, int x2, int y2)
+{
+	const int region = RLRegions_GetRegion(this, x1, y1);
+
+	return region && region == RLRegions_GetRegion(this, x2, y2);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLRegions_Destroy(RLRegions *this)
+{
+	if (CONDBIND(this, log_warn, "NULL argument")) {
+		for (int i = 0; i < RLREGIONS_MAX_FLOODS; ++i) {
+			g_free(this->floods[i].cells);
+		}
+		g_free(this->labels);
+		g_free(this->parents);
+		g_free(this->marks);
+		g_free(this->owners);
+		g_free(this);
+	}
+}
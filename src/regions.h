@@ -0,0 +1,89 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	regions.h
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Connected regions of a map's walkable plane, answering whether
+///			one cell can reach another without a search
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef REGIONS_H
+#define REGIONS_H
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdbool.h>
+
+#include "mapgrid.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+typedef struct _RLRegions RLRegions;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns a pointer to a new RLRegions with the map labelled
+///
+/// Cells are connected by the pathfinder's moves. A diagonal move needs
+/// both cells it passes between to be walkable, so a region is a set of
+/// walkable cells joined along rows and columns.
+///
+/// The map must outlive the RLRegions, its size must not change.
+///
+/// \param	map	Map whose RLMAP_WALKABLE plane gives the passable cells
+///
+/// \return	Pointer to the new RLRegions
+///////////////////////////////////////////////////////////////////////////////
+RLRegions * RLRegions_Create(const RLMapGrid *map);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Brings the labels up to date after a cell's walkable flag
+///			changed
+///
+/// A cell made walkable joins the regions around it at once. A cell made
+/// unwalkable that may split its region floods from each side at the same
+/// time, until all but one side have met another or run out. The sides
+/// that ran out get new labels, so the work is bounded by the smaller
+/// parts. A change to the walkable plane that was not reported this way
+/// labels the whole map again on the next query.
+///
+/// \param	this	An RLRegions
+/// \param	x		Column of the cell
+/// \param	y		Row of the cell
+///////////////////////////////////////////////////////////////////////////////
+void RLRegions_Update(RLRegions *this, int x, int y);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns the region of a cell
+///
+/// \param	this	An RLRegions
+/// \param	x		Column of the cell
+/// \param	y		Row of the cell
+///
+/// \return	Region id, valid until the walkable plane next changes, 0 if
+///			the cell is off the map or not walkable
+///////////////////////////////////////////////////////////////////////////////
+int RLRegions_GetRegion(RLRegions *this, int x, int y);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns whether a walkable path joins two cells
+///
+/// \param	this	An RLRegions
+/// \param	x1		Column of the first cell
+/// \param	y1		Row of the first cell
+/// \param	x2		Column of the second cell
+/// \param	y2		Row of the second cell
+///
+/// \return	true if both cells are walkable and in the same region
+///////////////////////////////////////////////////////////////////////////////
+bool RLRegions_Reachable(RLRegions *this, int x1, int y1, int x2, int y2);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Frees the memory associated with an RLRegions
+///
+/// \param	this	An RLRegions
+///////////////////////////////////////////////////////////////////////////////
+void RLRegions_Destroy(RLRegions *this);
+
+#endif
@@ -21,6 +21,25 @@ const struct _shaders shaders = {
 	void main(void) {									\n\
 		gl_Position = transform * vec4(position, 1.0f); \n\
 		vtexcoord = texcoord;							\n\
+	}",
+	"													\n\
+	#version 330 core									\n\
+														\n\
+	layout (location = 0) in vec2 position;				\n\
+	layout (location = 1) in vec2 texcoord;				\n\
+	layout (location = 2) in vec4 color;				\n\
+														\n\
+	out vec2 vtexcoord;									\n\
+	out vec4 vcolor;									\n\
+														\n\
+	uniform mat4 transform;								\n\
+	uniform sampler2D tex;								\n\
+	uniform float depth;								\n\
+														\n\
+	void main(void) {									\n\
+		gl_Position = transform * vec4(position, depth, 1.0f);\n\
+		vtexcoord = texcoord / vec2(textureSize(tex, 0));\n\
+		vcolor = color;									\n\
 	}"
 	},
 	{
@@ -33,6 +52,24 @@ const struct _shaders shaders = {
 														\n\
 	void main(void) {									\n\
 		gl_FragColor = texture(tex, vtexcoord);			\n\
+	}",
+	"													\n\
+	#version 330 core									\n\
+														\n\
+	in vec2 vtexcoord;									\n\
+	in vec4 vcolor;										\n\
+														\n\
+	out vec4 fragcolor;									\n\
+														\n\
+	uniform sampler2D tex;								\n\
+	uniform float cutoff;								\n\
+														\n\
+	void main(void) {									\n\
+		fragcolor = vtexcoord.x < 0.0f ? vcolor :		\n\
+			vcolor * texture(tex, vtexcoord);			\n\
+		if (fragcolor.a <= cutoff) {					\n\
+			discard;									\n\
+		}												\n\
 	}"
 	}
 };
@@ -10,9 +10,11 @@
 extern const struct _shaders {
 	struct {
 		const char *basic;
+		const char *tile;
 	} vertex;
 	struct {
 		const char *basic;
+		const char *tile;
 	} fragment;
 } shaders;
 
@@ -0,0 +1,333 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	snapshot.c
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Immutable display snapshots handed from the simulation thread to
+///			the render thread through a lock-free triple buffer
+///////////////////////////////////////////////////////////////////////////////
+
+#include "snapshot.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdatomic.h>
+#include <string.h>
+#include <glib.h>
+
+#include "common.h"
+#include "log.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+#define SNAPSHOT_BUFFERS 3
+
+// Set in the shared index while it holds a snapshot not yet acquired
+#define SNAPSHOT_FRESH 0x4
+#define SNAPSHOT_INDEX 0x3
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// Each buffer is owned by exactly one of the writer (back), the reader
+/// (front) or neither (middle). Ownership only changes by atomically
+/// exchanging an index with middle, so neither side ever waits on the other.
+///////////////////////////////////////////////////////////////////////////////
+struct _RLSnapshotQueue {
+	RLSnapshot buffers[SNAPSHOT_BUFFERS];
+	int back;
+	int front;
+	bool has_front;
+	atomic_int middle;
+	RLSnapshotNotify notify;
+	void *notify_data;
+	atomic_uint_fast64_t published;
+	atomic_uint_fast64_t dropped;
+	atomic_uint_fast64_t acquired;
+	atomic_uint_fast64_t stale;
+	atomic_uint_fast64_t stall_us;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLSnapshotQueue_Count(atomic_uint_fast64_t *counter,
+	uint64_t amount)
+{
+	atomic_fetch_add_explicit(counter, amount, memory_order_relaxed);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Public functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+RLSnapshotQueue * RLSnapshotQueue_Create(void)
+{
+	RLSnapshotQueue *this = g_new0(RLSnapshotQueue, 1);
+
+	this->back = 0;
+	this->front = 1;
+	atomic_init(&this->middle, 2);
+	atomic_init(&this->published, 0);
+	atomic_init(&this->dropped, 0);
+	atomic_init(&this->acquired, 0);
+	atomic_init(&this->stale, 0);
+	atomic_init(&this->stall_us, 0);
+
+	return this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int RLSnapshotQueue_AddLayer(RLSnapshotQueue *this, int width, int height)
+{
+	int index = 0;
+
+	if (!this) {
+		log_warn("NULL argument");
+		return -1;
+	}
+	else if (this->buffers[0].num_layers == RLDISPLAY_MAX_LAYERS) {
+		log_warn("Snapshot layer limit reached");
+		return -1;
+	}
+	else if (width <= 0 || height <= 0) {
+		log_warn("Invalid layer dimensions");
+		return -1;
+	}
+
+	index = this->buffers[0].num_layers;
+	for (int i = 0; i < SNAPSHOT_BUFFERS; ++i) {
+		RLSnapshotLayer *layer = &this->buffers[i].layers[index];
+		layer->width = width;
+		layer->height = height;
+		layer->tiles = g_new0(RLTile, (gsize)width * (gsize)height);
+		this->buffers[i].num_layers = index + 1;
+	}
+
+	return index;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLSnapshotQueue_SetNotify(RLSnapshotQueue *this, RLSnapshotNotify notify,
+	void *data)
+{
+	if (CONDBIND(this, log_warn, "NULL argument")) {
+		this->notify = notify;
+		this->notify_data = data;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+RLSnapshot * RLSnapshotQueue_Begin(RLSnapshotQueue *this)
+{
+	if (!this) {
+		log_warn("NULL argument");
+		return NULL;
+	}
+	else {
+		return &this->buffers[this->back];
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLSnapshotQueue_Publish(RLSnapshotQueue *this)
+{
+	int previous;
+
+	if (!this) {
+		log_warn("NULL argument");
+		return;
+	}
+
+	// Release the snapshot writes, acquire the buffer the reader let go of
+	previous = atomic_exchange_explicit(
+		&this->middle,
+		this->back | SNAPSHOT_FRESH,
+		memory_order_acq_rel
+		);
+	this->back = previous & SNAPSHOT_INDEX;
+
+	RLSnapshotQueue_Count(&this->published, 1);
+	if (previous & SNAPSHOT_FRESH) {
+		RLSnapshotQueue_Count(&this->dropped, 1);
+	}
+	if (this->notify) {
+		this->notify(this->notify_data);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+const RLSnapshot * RLSnapshotQueue_Acquire(RLSnapshotQueue *this, bool wait)
+{
+	int middle;
+
+	if (!this) {
+		log_warn("NULL argument");
+		return NULL;
+	}
+
+	middle = atomic_load_explicit(&this->middle, memory_order_relaxed);
+	if (!(middle & SNAPSHOT_FRESH)) {
+		gint64 start;
+
+		if (!wait) {
+			if (!this->has_front) {
+				return NULL;
+			}
+			RLSnapshotQueue_Count(&this->stale, 1);
+			return &this->buffers[this->front];
+		}
+
+		start = g_get_monotonic_time();
+		while (!(middle & SNAPSHOT_FRESH)) {
+			g_thread_yield();
+			middle = atomic_load_explicit(&this->middle, memory_order_relaxed);
+		}
+		RLSnapshotQueue_Count(
+			&this->stall_us,
+			(uint64_t)(g_get_monotonic_time() - start)
+			);
+	}
+
+	middle = atomic_exchange_explicit(
+		&this->middle,
+		this->front,
+		memory_order_acq_rel
+		);
+	this->front = middle & SNAPSHOT_INDEX;
+	this->has_front = true;
+	RLSnapshotQueue_Count(&this->acquired, 1);
+
+	return &this->buffers[this->front];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLSnapshotLayer_SetPalette(RLSnapshotLayer *this, const RLColor *palette)
+{
+	if (!this) {
+		log_warn("NULL argument");
+	}
+	else if (!palette) {
+		g_free(this->palette);
+		this->palette = NULL;
+	}
+	else {
+		if (!this->palette) {
+			this->palette = g_new(RLColor, RLTILEMAP_PALETTE_SIZE);
+		}
+		memcpy(
+			this->palette,
+			palette,
+			sizeof(RLColor) * RLTILEMAP_PALETTE_SIZE
+			);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool RLSnapshot_IsAnimating(const RLSnapshot *this, uint64_t now)
+{
+	if (!this) {
+		log_warn("NULL argument");
+		return false;
+	}
+
+	return this->step && now < this->time + this->step && (
+		this->previous.position.x != this->camera.position.x ||
+		this->previous.position.y != this->camera.position.y ||
+		this->previous.offset.x != this->camera.offset.x ||
+		this->previous.offset.y != this->camera.offset.y);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLSnapshot_Draw(const RLSnapshot *this, RLDisplay *display,
+	BMFont *font, uint64_t now)
+{
+	RLTile *tiles[RLDISPLAY_MAX_LAYERS] = {NULL};
+	RLColor *palettes[RLDISPLAY_MAX_LAYERS] = {NULL};
+	RLCamera camera;
+	float t = 1.0f;
+
+	if (!this || !display || !font) {
+		log_warn("NULL argument");
+		return;
+	}
+
+	if (this->step && now > this->time) {
+		t = MIN((float)((double)(now - this->time) / (double)this->step),
+			1.0f);
+	}
+	else if (this->step) {
+		t = 0.0f;
+	}
+	RLCamera_Lerp(&camera, &this->previous, &this->camera, t);
+
+	// Lend the snapshot tiles to the display for the duration of the draw
+	for (int z = 0; z < this->num_layers; ++z) {
+		RLLayer *layer = RLDisplay_FindLayer(display, z);
+		if (layer && layer->tile_map->size.width == this->layers[z].width &&
+			layer->tile_map->size.height == this->layers[z].height) {
+			tiles[z] = layer->tile_map->tiles;
+			palettes[z] = layer->tile_map->palette;
+			layer->tile_map->tiles = this->layers[z].tiles;
+			layer->tile_map->palette = this->layers[z].palette;
+		}
+	}
+
+	RLDisplay_Draw(display, font, &camera);
+
+	for (int z = 0; z < this->num_layers; ++z) {
+		if (tiles[z]) {
+			RLTileMap *tile_map = RLDisplay_FindLayer(display, z)->tile_map;
+			tile_map->tiles = tiles[z];
+			tile_map->palette = palettes[z];
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLSnapshotQueue_GetStats(RLSnapshotQueue *this, RLSnapshotStats *stats)
+{
+	if (CONDBIND(this && stats, log_warn, "NULL argument")) {
+		stats->published = atomic_load_explicit(
+			&this->published,
+			memory_order_relaxed
+			);
+		stats->dropped = atomic_load_explicit(
+			&this->dropped,
+			memory_order_relaxed
+			);
+		stats->acquired = atomic_load_explicit(
+			&this->acquired,
+			memory_order_relaxed
+			);
+		stats->stale = atomic_load_explicit(
+			&this->stale,
+			memory_order_relaxed
+			);
+		stats->stall_us = atomic_load_explicit(
+			&this->stall_us,
+			memory_order_relaxed
+			);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLSnapshotQueue_Destroy(RLSnapshotQueue *this)
+{
+	if (CONDBIND(this, log_warn, "NULL argument")) {
+		for (int i = 0; i < SNAPSHOT_BUFFERS; ++i) {
+			for (int j = 0; j < this->buffers[i].num_layers; ++j) {
+				g_free(this->buffers[i].layers[j].tiles);
+				g_free(this->buffers[i].layers[j].palette);
+			}
+		}
+		g_free(this);
+	}
+}
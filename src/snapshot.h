@@ -0,0 +1,196 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	snapshot.h
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Immutable display snapshots handed from the simulation thread to
+///			the render thread through a lock-free triple buffer
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "tile.h"
+#include "camera.h"
+#include "display.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Tiles of one layer
+///
+/// version is copied from the simulation's own layer so the writer can skip
+/// copying layers that did not change since this buffer was last written.
+/// palette holds RLTILEMAP_PALETTE_SIZE colours, or is NULL for none, and
+/// is set through RLSnapshotLayer_SetPalette.
+///////////////////////////////////////////////////////////////////////////////
+typedef struct {
+	int width;
+	int height;
+	uint64_t version;
+	RLTile *tiles;
+	RLColor *palette;
+} RLSnapshotLayer;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Everything the render thread needs to draw one frame
+///
+/// layers are indexed by the z of the display layer they replace. The
+/// camera is drawn interpolated from previous, one simulation step behind,
+/// using the performance counter time the snapshot was published at and
+/// the length of a step in ticks.
+///////////////////////////////////////////////////////////////////////////////
+typedef struct {
+	uint64_t frame;
+	uint64_t time;
+	uint64_t step;
+	RLCamera camera;
+	RLCamera previous;
+	int num_layers;
+	RLSnapshotLayer layers[RLDISPLAY_MAX_LAYERS];
+} RLSnapshot;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Handoff counters
+///
+/// published:	Snapshots completed by the simulation thread
+/// dropped:	Snapshots overwritten before the render thread drew them
+/// acquired:	Snapshots picked up by the render thread
+/// stale:		Render frames that redrew an already drawn snapshot
+/// stall_us:	Microseconds the render thread waited for a snapshot
+///////////////////////////////////////////////////////////////////////////////
+typedef struct {
+	uint64_t published;
+	uint64_t dropped;
+	uint64_t acquired;
+	uint64_t stale;
+	uint64_t stall_us;
+} RLSnapshotStats;
+
+typedef struct _RLSnapshotQueue RLSnapshotQueue;
+
+typedef void (*RLSnapshotNotify)(void *data);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns a pointer to a new RLSnapshotQueue without layers
+///
+/// \return	Pointer to the new RLSnapshotQueue
+///////////////////////////////////////////////////////////////////////////////
+RLSnapshotQueue * RLSnapshotQueue_Create(void);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Adds a layer of tiles to all three snapshots
+///
+/// Must be called before either thread starts using the queue.
+///
+/// \param	this	An RLSnapshotQueue
+/// \param	width	Width of the layer in tiles
+/// \param	height	Height of the layer in tiles
+///
+/// \return	Index of the new layer
+///////////////////////////////////////////////////////////////////////////////
+int RLSnapshotQueue_AddLayer(RLSnapshotQueue *this, int width, int height);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Sets a function called on the simulation thread after each publish
+///
+/// Lets a render thread that sleeps while idle be woken by new snapshots.
+/// Must be called before either thread starts using the queue.
+///
+/// \param	this	An RLSnapshotQueue
+/// \param	notify	Function to call, or NULL for none
+/// \param	data	Argument passed to notify
+///////////////////////////////////////////////////////////////////////////////
+void RLSnapshotQueue_SetNotify(RLSnapshotQueue *this, RLSnapshotNotify notify,
+	void *data);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns the snapshot owned by the simulation thread
+///
+/// The contents are whatever was last written to this buffer, two
+/// publishes ago, so the caller rewrites every field it relies on.
+///
+/// \param	this	An RLSnapshotQueue
+///
+/// \return	Writable snapshot
+///////////////////////////////////////////////////////////////////////////////
+RLSnapshot * RLSnapshotQueue_Begin(RLSnapshotQueue *this);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Makes the snapshot returned by Begin the latest complete one
+///
+/// Never blocks. An unread previous snapshot is dropped.
+///
+/// \param	this	An RLSnapshotQueue
+///////////////////////////////////////////////////////////////////////////////
+void RLSnapshotQueue_Publish(RLSnapshotQueue *this);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns the latest complete snapshot for the render thread
+///
+/// The snapshot stays valid and unchanged until the next call.
+///
+/// \param	this	An RLSnapshotQueue
+/// \param	wait	Whether to wait for a snapshot newer than the last one
+///
+/// \return	Latest snapshot, or NULL if none was ever published
+///////////////////////////////////////////////////////////////////////////////
+const RLSnapshot * RLSnapshotQueue_Acquire(RLSnapshotQueue *this, bool wait);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Sets the palette a snapshot layer's palette tiles are drawn with
+///
+/// \param	this	A layer of the snapshot returned by RLSnapshotQueue_Begin
+/// \param	palette	RLTILEMAP_PALETTE_SIZE colours to copy, or NULL for none
+///////////////////////////////////////////////////////////////////////////////
+void RLSnapshotLayer_SetPalette(RLSnapshotLayer *this, const RLColor *palette);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns whether the snapshot camera is still being interpolated
+///
+/// \param	this	A snapshot returned by RLSnapshotQueue_Acquire
+/// \param	now		Current performance counter value
+///
+/// \return	true if drawing the snapshot at a later time gives a different
+///			picture
+///////////////////////////////////////////////////////////////////////////////
+bool RLSnapshot_IsAnimating(const RLSnapshot *this, uint64_t now);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Draws a snapshot through a display
+///
+/// Each snapshot layer stands in for the tiles and palette of the display
+/// layer with the same z. Scrolling layers use the snapshot camera interpolated for
+/// the time elapsed since the snapshot was published.
+///
+/// \param	this	A snapshot returned by RLSnapshotQueue_Acquire
+/// \param	display	Display whose layers match the snapshot
+/// \param	font	BMFont describing the glyph atlas
+/// \param	now		Current performance counter value
+///////////////////////////////////////////////////////////////////////////////
+void RLSnapshot_Draw(const RLSnapshot *this, RLDisplay *display,
+	BMFont *font, uint64_t now);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Reads the handoff counters, callable from any thread
+///
+/// \param	this	An RLSnapshotQueue
+/// \param	stats	Destination of the counters
+///////////////////////////////////////////////////////////////////////////////
+void RLSnapshotQueue_GetStats(RLSnapshotQueue *this, RLSnapshotStats *stats);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Frees the memory associated with an RLSnapshotQueue
+///
+/// \param	this	An RLSnapshotQueue
+///////////////////////////////////////////////////////////////////////////////
+void RLSnapshotQueue_Destroy(RLSnapshotQueue *this);
+
+#endif
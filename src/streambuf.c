@@ -0,0 +1,240 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	streambuf.c
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Streaming vertex buffer split into fenced per-frame regions of a
+///			persistently mapped buffer (ARB_buffer_storage), with a fallback
+///			to buffer orphaning on contexts without buffer storage.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "streambuf.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <glib.h>
+#include <SDL2/SDL.h>
+
+#include "common.h"
+#include "log.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+// ARB_buffer_storage is not part of the generated GL 3.3 loader
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#define GL_MAP_COHERENT_BIT 0x0080
+
+#define STREAMBUF_WAIT_NS 1000000
+
+typedef void (APIENTRYP PFNGLBUFFERSTORAGEPROC)(GLenum target,
+	GLsizeiptr size, const void *data, GLbitfield flags);
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+struct _StreamBuffer {
+	GLuint buffer;
+	GLenum target;
+	bool persistent;
+	int region;
+	GLsizeiptr region_size;
+	GLsync fences[STREAMBUF_REGIONS];
+	unsigned char *mapped;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+static PFNGLBUFFERSTORAGEPROC StreamBuffer_LoadBufferStorage(void)
+{
+	static bool loaded = false;
+	static PFNGLBUFFERSTORAGEPROC buffer_storage = NULL;
+
+	if (!loaded) {
+		loaded = true;
+		if (SDL_GL_ExtensionSupported("GL_ARB_buffer_storage")) {
+			// Assigned through the object pointer to stay ISO C clean
+			*(void **)&buffer_storage = SDL_GL_GetProcAddress(
+				"glBufferStorage");
+		}
+		if (!buffer_storage) {
+			log_info("ARB_buffer_storage unavailable, orphaning buffers");
+		}
+	}
+
+	return buffer_storage;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void StreamBuffer_Wait(StreamBuffer *this)
+{
+	GLenum status;
+	GLsync fence = this->fences[this->region];
+
+	if (!fence) {
+		return;
+	}
+
+	do {
+		status = glClientWaitSync(
+			fence,
+			GL_SYNC_FLUSH_COMMANDS_BIT,
+			STREAMBUF_WAIT_NS
+			);
+	} while (status == GL_TIMEOUT_EXPIRED);
+
+	if (status == GL_WAIT_FAILED) {
+		log_warn("Fence wait failed");
+	}
+
+	glDeleteSync(fence);
+	this->fences[this->region] = NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Public functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+StreamBuffer * StreamBuffer_Create(GLenum target, GLsizeiptr region_size)
+{
+	StreamBuffer *this = NULL;
+	PFNGLBUFFERSTORAGEPROC buffer_storage = NULL;
+	const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT |
+		GL_MAP_COHERENT_BIT;
+
+	if (region_size <= 0) {
+		log_warn("Invalid region size");
+		return NULL;
+	}
+
+	this = g_new0(StreamBuffer, 1);
+	this->target = target;
+	this->region_size = region_size;
+
+	glGenBuffers(1, &this->buffer);
+	glBindBuffer(target, this->buffer);
+
+	if ((buffer_storage = StreamBuffer_LoadBufferStorage())) {
+		buffer_storage(target, region_size * STREAMBUF_REGIONS, NULL, flags);
+		this->mapped = glMapBufferRange(
+			target,
+			0,
+			region_size * STREAMBUF_REGIONS,
+			flags
+			);
+		this->persistent = this->mapped != NULL;
+	}
+
+	if (!this->persistent) {
+		if (buffer_storage) {
+			// Immutable storage cannot be orphaned, start over
+			log_warn("Persistent mapping failed, orphaning buffer");
+			glDeleteBuffers(1, &this->buffer);
+			glGenBuffers(1, &this->buffer);
+			glBindBuffer(target, this->buffer);
+		}
+		glBufferData(target, region_size, NULL, GL_STREAM_DRAW);
+	}
+
+	return this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void * StreamBuffer_Map(StreamBuffer *this)
+{
+	if (!this) {
+		log_warn("NULL argument");
+		return NULL;
+	}
+
+	glBindBuffer(this->target, this->buffer);
+
+	if (this->persistent) {
+		StreamBuffer_Wait(this);
+		return this->mapped + this->region * this->region_size;
+	}
+	else {
+		glBufferData(this->target, this->region_size, NULL, GL_STREAM_DRAW);
+		return glMapBufferRange(
+			this->target,
+			0,
+			this->region_size,
+			GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT
+			);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+GLintptr StreamBuffer_Unmap(StreamBuffer *this)
+{
+	if (!this) {
+		log_warn("NULL argument");
+		return 0;
+	}
+
+	if (this->persistent) {
+		// Coherent mapping, writes are visible without an explicit flush
+		return this->region * this->region_size;
+	}
+	else {
+		glBindBuffer(this->target, this->buffer);
+		if (!glUnmapBuffer(this->target)) {
+			log_warn("Buffer contents corrupted during unmap");
+		}
+		return 0;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void StreamBuffer_Fence(StreamBuffer *this)
+{
+	if (CONDBIND(this, log_warn, "NULL argument") && this->persistent) {
+		this->fences[this->region] = glFenceSync(
+			GL_SYNC_GPU_COMMANDS_COMPLETE,
+			0
+			);
+		this->region = (this->region + 1) % STREAMBUF_REGIONS;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+GLuint StreamBuffer_GetBuffer(StreamBuffer *this)
+{
+	if (!this) {
+		log_warn("NULL argument");
+		return 0;
+	}
+	else {
+		return this->buffer;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool StreamBuffer_IsPersistent(StreamBuffer *this)
+{
+	return this && this->persistent;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void StreamBuffer_Destroy(StreamBuffer *this)
+{
+	if (CONDBIND(this, log_warn, "NULL argument")) {
+		for (int i = 0; i < STREAMBUF_REGIONS; ++i) {
+			if (this->fences[i]) {
+				glDeleteSync(this->fences[i]);
+			}
+		}
+		if (this->persistent) {
+			glBindBuffer(this->target, this->buffer);
+			glUnmapBuffer(this->target);
+		}
+		glDeleteBuffers(1, &this->buffer);
+		g_free(this);
+	}
+}
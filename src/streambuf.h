@@ -0,0 +1,102 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	streambuf.h
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Streaming vertex buffer split into fenced per-frame regions of a
+///			persistently mapped buffer (ARB_buffer_storage), with a fallback
+///			to buffer orphaning on contexts without buffer storage.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef STREAMBUF_H
+#define STREAMBUF_H
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdbool.h>
+
+#include "glad.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+#define STREAMBUF_REGIONS 3
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+typedef struct _StreamBuffer StreamBuffer;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns a pointer to a new StreamBuffer
+///
+/// The buffer holds STREAMBUF_REGIONS regions of region_size bytes each when
+/// buffer storage is available, or a single orphaned region otherwise.
+///
+/// \param	target		Binding target of the buffer (i.e. GL_ARRAY_BUFFER)
+/// \param	region_size	Size in bytes of the data written each frame
+///
+/// \return	Pointer to the new StreamBuffer
+///////////////////////////////////////////////////////////////////////////////
+StreamBuffer * StreamBuffer_Create(GLenum target, GLsizeiptr region_size);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns a writable pointer to the current frame's region
+///
+/// Blocks only if the GPU is still reading the region from
+/// STREAMBUF_REGIONS frames ago. Leaves the buffer bound to its target.
+///
+/// \param	this	A StreamBuffer
+///
+/// \return	Pointer to region_size bytes of write-only memory
+///////////////////////////////////////////////////////////////////////////////
+void * StreamBuffer_Map(StreamBuffer *this);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Finishes writing the current region
+///
+/// Must be called before any draw that sources the region.
+///
+/// \param	this	A StreamBuffer
+///
+/// \return	Byte offset of the current region within the buffer
+///////////////////////////////////////////////////////////////////////////////
+GLintptr StreamBuffer_Unmap(StreamBuffer *this);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Fences the current region and advances to the next one
+///
+/// Must be called after the last draw that sources the current region.
+///
+/// \param	this	A StreamBuffer
+///////////////////////////////////////////////////////////////////////////////
+void StreamBuffer_Fence(StreamBuffer *this);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns the OpenGL name of the underlying buffer
+///
+/// \param	this	A StreamBuffer
+///
+/// \return	Buffer object name
+///////////////////////////////////////////////////////////////////////////////
+GLuint StreamBuffer_GetBuffer(StreamBuffer *this);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns whether the buffer is persistently mapped
+///
+/// \param	this	A StreamBuffer
+///
+/// \return	true if ARB_buffer_storage is in use, false if orphaning
+///////////////////////////////////////////////////////////////////////////////
+bool StreamBuffer_IsPersistent(StreamBuffer *this);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Frees the memory associated with a StreamBuffer
+///
+/// \param	this	A StreamBuffer
+///////////////////////////////////////////////////////////////////////////////
+void StreamBuffer_Destroy(StreamBuffer *this);
+
+#endif
@@ -0,0 +1,122 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	target.c
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Offscreen framebuffer with a color and a depth attachment
+///////////////////////////////////////////////////////////////////////////////
+
+#include "target.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <glib.h>
+
+#include "common.h"
+#include "log.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+struct _RenderTarget {
+	int width;
+	int height;
+	GLuint framebuffer;
+	GLuint color;
+	GLuint depth;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// Public functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+RenderTarget * RenderTarget_Create(int width, int height)
+{
+	RenderTarget *this = NULL;
+	GLenum status;
+
+	if (width <= 0 || height <= 0) {
+		log_warn("Invalid render target dimensions");
+		return NULL;
+	}
+
+	this = g_new0(RenderTarget, 1);
+	this->width = width;
+	this->height = height;
+
+	// Renderbuffers, the target is only ever drawn to and read back
+	glGenRenderbuffers(1, &this->color);
+	glBindRenderbuffer(GL_RENDERBUFFER, this->color);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+	glGenRenderbuffers(1, &this->depth);
+	glBindRenderbuffer(GL_RENDERBUFFER, this->depth);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width,
+		height);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	glGenFramebuffers(1, &this->framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, this->framebuffer);
+	glFramebufferRenderbuffer(
+		GL_FRAMEBUFFER,
+		GL_COLOR_ATTACHMENT0,
+		GL_RENDERBUFFER,
+		this->color
+		);
+	glFramebufferRenderbuffer(
+		GL_FRAMEBUFFER,
+		GL_DEPTH_ATTACHMENT,
+		GL_RENDERBUFFER,
+		this->depth
+		);
+	status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	if (status != GL_FRAMEBUFFER_COMPLETE) {
+		logfmt_warn("Framebuffer incomplete: 0x%x", status);
+		RenderTarget_Destroy(this);
+		return NULL;
+	}
+
+	return this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RenderTarget_Bind(RenderTarget *this)
+{
+	if (CONDBIND(this, log_warn, "NULL argument")) {
+		glBindFramebuffer(GL_FRAMEBUFFER, this->framebuffer);
+		glViewport(0, 0, this->width, this->height);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RenderTarget_Read(RenderTarget *this, unsigned char *pixels)
+{
+	if (CONDBIND(this && pixels, log_warn, "NULL argument")) {
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, this->framebuffer);
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		glReadPixels(
+			0,
+			0,
+			this->width,
+			this->height,
+			GL_RGBA,
+			GL_UNSIGNED_BYTE,
+			pixels
+			);
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RenderTarget_Destroy(RenderTarget *this)
+{
+	if (CONDBIND(this, log_warn, "NULL argument")) {
+		glDeleteFramebuffers(1, &this->framebuffer);
+		glDeleteRenderbuffers(1, &this->color);
+		glDeleteRenderbuffers(1, &this->depth);
+		g_free(this);
+	}
+}
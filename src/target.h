@@ -0,0 +1,59 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	target.h
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Offscreen framebuffer with a color and a depth attachment
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TARGET_H
+#define TARGET_H
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdbool.h>
+
+#include "glad.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+typedef struct _RenderTarget RenderTarget;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns a pointer to a new RenderTarget
+///
+/// \param	width	Width of the attachments in pixels
+/// \param	height	Height of the attachments in pixels
+///
+/// \return	Pointer to the new RenderTarget, or NULL if the framebuffer is
+///			incomplete
+///////////////////////////////////////////////////////////////////////////////
+RenderTarget * RenderTarget_Create(int width, int height);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Directs drawing into the target and sets the viewport to it
+///
+/// \param	this	A RenderTarget
+///////////////////////////////////////////////////////////////////////////////
+void RenderTarget_Bind(RenderTarget *this);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Reads the color attachment back
+///
+/// Rows are returned bottom-up, as OpenGL stores them.
+///
+/// \param	this	A RenderTarget
+/// \param	pixels	Destination of width * height RGBA pixels
+///////////////////////////////////////////////////////////////////////////////
+void RenderTarget_Read(RenderTarget *this, unsigned char *pixels);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Frees the memory associated with a RenderTarget
+///
+/// \param	this	A RenderTarget
+///////////////////////////////////////////////////////////////////////////////
+void RenderTarget_Destroy(RenderTarget *this);
+
+#endif
@@ -0,0 +1,229 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	tile.c
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Compact glyph tile record and bulk colour operations over tile
+///			arrays
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tile.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "log.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+// Four tiles span exactly three 16 byte vectors
+#define RLTILE_PERIOD_TILES 4
+#define RLTILE_PERIOD (RLTILE_PERIOD_TILES * sizeof(RLTile))
+
+_Static_assert(sizeof(RLTile) == 12, "RLTile must stay 12 bytes");
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+static inline uint8_t RLTile_Mix(uint8_t c, uint8_t t, uint8_t w)
+{
+	// Exact round(x / 255), so a weight of 0 leaves bytes untouched
+	const unsigned x = (unsigned)c * (255u - w) + (unsigned)t * w + 128u;
+	return (uint8_t)((x + (x >> 8)) >> 8);
+}
+
+#ifdef __SSE2__
+///////////////////////////////////////////////////////////////////////////////
+static inline __m128i RLTile_MixHalf(__m128i c, __m128i t, __m128i w)
+{
+	const __m128i full = _mm_set1_epi16(255), round = _mm_set1_epi16(128);
+	__m128i x = _mm_add_epi16(
+		_mm_mullo_epi16(c, _mm_sub_epi16(full, w)),
+		_mm_mullo_epi16(t, w)
+		);
+	x = _mm_add_epi16(x, round);
+	return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static inline __m128i RLTile_MixSSE2(__m128i c, __m128i t, __m128i w)
+{
+	const __m128i zero = _mm_setzero_si128();
+	return _mm_packus_epi16(
+		RLTile_MixHalf(
+			_mm_unpacklo_epi8(c, zero),
+			_mm_unpacklo_epi8(t, zero),
+			_mm_unpacklo_epi8(w, zero)
+			),
+		RLTile_MixHalf(
+			_mm_unpackhi_epi8(c, zero),
+			_mm_unpackhi_epi8(t, zero),
+			_mm_unpackhi_epi8(w, zero)
+			)
+		);
+}
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Per byte c = (c * (255 - w) + t * w) / 255 on selected planes
+///
+/// Tint, fade and blend are all this lerp with different target and weight
+/// colours. Bytes outside the selected planes get a weight of 0.
+///////////////////////////////////////////////////////////////////////////////
+static void RLTile_Lerp(RLTile *tiles, size_t count, int planes,
+	RLColor target, RLColor weight)
+{
+	uint8_t t[RLTILE_PERIOD], w[RLTILE_PERIOD];
+	uint8_t *bytes = (uint8_t *)tiles;
+	const size_t size = count * sizeof(RLTile);
+	size_t i = 0;
+
+	memset(t, 0, sizeof(t));
+	memset(w, 0, sizeof(w));
+	for (size_t k = 0; k < RLTILE_PERIOD_TILES; ++k) {
+		const size_t base = k * sizeof(RLTile);
+		if (planes & RLTILE_FG) {
+			memcpy(t + base + offsetof(RLTile, fg), &target, sizeof(RLColor));
+			memcpy(w + base + offsetof(RLTile, fg), &weight, sizeof(RLColor));
+		}
+		if (planes & RLTILE_BG) {
+			memcpy(t + base + offsetof(RLTile, bg), &target, sizeof(RLColor));
+			memcpy(w + base + offsetof(RLTile, bg), &weight, sizeof(RLColor));
+		}
+	}
+
+#ifdef __SSE2__
+	{
+		const __m128i tv[3] = {
+			_mm_loadu_si128((const __m128i *)(t + 0)),
+			_mm_loadu_si128((const __m128i *)(t + 16)),
+			_mm_loadu_si128((const __m128i *)(t + 32))
+		};
+		const __m128i wv[3] = {
+			_mm_loadu_si128((const __m128i *)(w + 0)),
+			_mm_loadu_si128((const __m128i *)(w + 16)),
+			_mm_loadu_si128((const __m128i *)(w + 32))
+		};
+		for (; i + RLTILE_PERIOD <= size; i += RLTILE_PERIOD) {
+			for (int v = 0; v < 3; ++v) {
+				__m128i *p = (__m128i *)(bytes + i + (size_t)v * 16);
+				_mm_storeu_si128(
+					p,
+					RLTile_MixSSE2(_mm_loadu_si128(p), tv[v], wv[v])
+					);
+			}
+		}
+	}
+#endif
+
+	for (; i < size; ++i) {
+		bytes[i] = RLTile_Mix(
+			bytes[i],
+			t[i % RLTILE_PERIOD],
+			w[i % RLTILE_PERIOD]
+			);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Public functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+void RLTile_Fill(RLTile *tiles, size_t count, RLTile tile)
+{
+	size_t i = 0;
+
+	if (!tiles) {
+		log_warn("NULL argument");
+		return;
+	}
+
+#ifdef __SSE2__
+	{
+		RLTile pattern[RLTILE_PERIOD_TILES] = {tile, tile, tile, tile};
+		const __m128i v0 = _mm_loadu_si128((const __m128i *)pattern + 0);
+		const __m128i v1 = _mm_loadu_si128((const __m128i *)pattern + 1);
+		const __m128i v2 = _mm_loadu_si128((const __m128i *)pattern + 2);
+		for (; i + RLTILE_PERIOD_TILES <= count; i += RLTILE_PERIOD_TILES) {
+			__m128i *p = (__m128i *)(tiles + i);
+			_mm_storeu_si128(p + 0, v0);
+			_mm_storeu_si128(p + 1, v1);
+			_mm_storeu_si128(p + 2, v2);
+		}
+	}
+#endif
+
+	for (; i < count; ++i) {
+		tiles[i] = tile;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLTile_Tint(RLTile *tiles, size_t count, int planes, RLColor tint)
+{
+	if (!tiles) {
+		log_warn("NULL argument");
+		return;
+	}
+
+	// c * k / 255 is a lerp towards black with weight 255 - k
+	RLTile_Lerp(tiles, count, planes, 0, ~tint);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLTile_Fade(RLTile *tiles, size_t count, int planes, RLColor target,
+	uint8_t amount)
+{
+	if (!tiles) {
+		log_warn("NULL argument");
+		return;
+	}
+
+	RLTile_Lerp(
+		tiles,
+		count,
+		planes,
+		target,
+		RLCOLOR(amount, amount, amount, amount)
+		);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLTile_BlendRect(RLTile *tiles, int width, int height, int x, int y,
+	int w, int h, int planes, RLColor color)
+{
+	const uint8_t alpha = RLCOLOR_A(color);
+	// Source over: alpha becomes a + (1 - a) * dst, i.e. a lerp towards 255
+	const RLColor target = color | RLCOLOR(0, 0, 0, 255);
+	int x0 = x < 0 ? 0 : x, y0 = y < 0 ? 0 : y;
+	int x1 = x + w > width ? width : x + w;
+	int y1 = y + h > height ? height : y + h;
+
+	if (!tiles) {
+		log_warn("NULL argument");
+		return;
+	}
+	if (x0 >= x1 || y0 >= y1) {
+		return;
+	}
+
+	for (int row = y0; row < y1; ++row) {
+		RLTile_Lerp(
+			tiles + (size_t)row * (size_t)width + (size_t)x0,
+			(size_t)(x1 - x0),
+			planes,
+			target,
+			RLCOLOR(alpha, alpha, alpha, alpha)
+			);
+	}
+}
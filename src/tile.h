@@ -0,0 +1,158 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	tile.h
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Compact glyph tile record and bulk colour operations over tile
+///			arrays
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TILE_H
+#define TILE_H
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stddef.h>
+#include <stdint.h>
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Packs 8-bit channels into an RLColor
+///////////////////////////////////////////////////////////////////////////////
+#define RLCOLOR(r,g,b,a) ((RLColor)(((uint32_t)(r) & 0xFF) | \
+	((uint32_t)(g) & 0xFF) << 8 | ((uint32_t)(b) & 0xFF) << 16 | \
+	((uint32_t)(a) & 0xFF) << 24))
+
+#define RLCOLOR_R(c) ((uint8_t)((c) & 0xFF))
+#define RLCOLOR_G(c) ((uint8_t)(((c) >> 8) & 0xFF))
+#define RLCOLOR_B(c) ((uint8_t)(((c) >> 16) & 0xFF))
+#define RLCOLOR_A(c) ((uint8_t)(((c) >> 24) & 0xFF))
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Tile flag marking fg and bg as indices into a tile map palette
+///
+/// Only the low byte of each colour is used as the index. Bulk colour
+/// operations treat palette tiles as direct colours, so recolour those by
+/// editing the palette instead.
+///////////////////////////////////////////////////////////////////////////////
+#define RLTILE_PALETTE 0x01
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Colour planes selected by bulk operations
+///////////////////////////////////////////////////////////////////////////////
+#define RLTILE_FG 0x01
+#define RLTILE_BG 0x02
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	RGBA8 colour, red in the least significant byte
+///////////////////////////////////////////////////////////////////////////////
+typedef uint32_t RLColor;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Describes how a glyph is placed inside its tile
+///
+/// RLTILE_TEXT:	Glyph is placed using its BMFont offsets
+/// RLTILE_EXACT:	Glyph is stretched to fill the tile
+/// RLTILE_FLOOR:	Glyph is centered horizontally on the bottom of the tile
+/// RLTILE_CENTER:	Glyph is centered in the tile
+///////////////////////////////////////////////////////////////////////////////
+typedef enum {
+	RLTILE_TEXT,
+	RLTILE_EXACT,
+	RLTILE_FLOOR,
+	RLTILE_CENTER
+} RLTileType;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	12 byte tile: codepoint, placement, flags and two colours
+///
+/// A glyph of 0 draws only the background, a bg alpha of 0 draws only the
+/// glyph.
+///////////////////////////////////////////////////////////////////////////////
+typedef struct {
+	uint32_t glyph : 21;
+	uint32_t type : 3;
+	uint32_t flags : 8;
+	RLColor fg;
+	RLColor bg;
+} RLTile;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns a new RLTile
+///
+/// \param	glyph	UTF-32 value of the glyph
+/// \param	type	Placement of the glyph in the tile
+/// \param	fg		Glyph colour
+/// \param	bg		Background colour
+///
+/// \return	The new RLTile
+///////////////////////////////////////////////////////////////////////////////
+static inline RLTile RLTile_Make(int glyph, RLTileType type, RLColor fg,
+	RLColor bg)
+{
+	RLTile tile;
+	tile.glyph = (uint32_t)glyph & 0x1FFFFF;
+	tile.type = (uint32_t)type & 0x7;
+	tile.flags = 0;
+	tile.fg = fg;
+	tile.bg = bg;
+	return tile;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Sets every tile of an array to a given tile
+///
+/// \param	tiles	Array of tiles
+/// \param	count	Number of tiles in the array
+/// \param	tile	Tile to copy
+///////////////////////////////////////////////////////////////////////////////
+void RLTile_Fill(RLTile *tiles, size_t count, RLTile tile);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Multiplies the colours of every tile by a tint
+///
+/// \param	tiles	Array of tiles
+/// \param	count	Number of tiles in the array
+/// \param	planes	RLTILE_FG and/or RLTILE_BG
+/// \param	tint	Per-channel multiplier, 255 leaves a channel unchanged
+///////////////////////////////////////////////////////////////////////////////
+void RLTile_Tint(RLTile *tiles, size_t count, int planes, RLColor tint);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Moves the colours of every tile towards a target colour
+///
+/// \param	tiles	Array of tiles
+/// \param	count	Number of tiles in the array
+/// \param	planes	RLTILE_FG and/or RLTILE_BG
+/// \param	target	Colour faded towards
+/// \param	amount	0 leaves the tiles unchanged, 255 replaces them by target
+///////////////////////////////////////////////////////////////////////////////
+void RLTile_Fade(RLTile *tiles, size_t count, int planes, RLColor target,
+	uint8_t amount);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Alpha blends a colour over a rectangle of a tile grid
+///
+/// The rectangle is clipped to the grid.
+///
+/// \param	tiles	Row-major grid of tiles
+/// \param	width	Width of the grid in tiles
+/// \param	height	Height of the grid in tiles
+/// \param	x		Left column of the rectangle
+/// \param	y		Top row of the rectangle
+/// \param	w		Width of the rectangle in tiles
+/// \param	h		Height of the rectangle in tiles
+/// \param	planes	RLTILE_FG and/or RLTILE_BG
+/// \param	color	Colour blended over the tiles using its alpha
+///////////////////////////////////////////////////////////////////////////////
+void RLTile_BlendRect(RLTile *tiles, int width, int height, int x, int y,
+	int w, int h, int planes, RLColor color);
+
+#endif
@@ -0,0 +1,364 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	tilemap.c
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Grid of glyph tiles meshed into a streaming vertex buffer
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tilemap.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stddef.h>
+#include <string.h>
+#include <glib.h>
+
+#include "common.h"
+#include "log.h"
+#include "quadindex.h"
+#include "profiler.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+// Tiles meshed beyond each edge of the view for glyphs overhanging cells
+#define RLTILEMAP_CULL_MARGIN 1
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+static RLTileVertex * RLTileMap_Quad(RLTileVertex *quad, const GLfloat rect[4],
+	const GLfloat uv[4], RLColor color)
+{
+	const GLubyte r = RLCOLOR_R(color), g = RLCOLOR_G(color);
+	const GLubyte b = RLCOLOR_B(color), a = RLCOLOR_A(color);
+
+	// Mapped memory is write-only, never read back from quad
+	quad[0] = (RLTileVertex){rect[2], rect[1], uv[2], uv[1], r, g, b, a};
+	quad[1] = (RLTileVertex){rect[2], rect[3], uv[2], uv[3], r, g, b, a};
+	quad[2] = (RLTileVertex){rect[0], rect[3], uv[0], uv[3], r, g, b, a};
+	quad[3] = (RLTileVertex){rect[0], rect[1], uv[0], uv[1], r, g, b, a};
+
+	return quad + 4;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLTileMap_Place(RLTileMap *this, const RLTile *tile,
+	const BMFontInfo *info, int left, int top, GLfloat rect[4])
+{
+	const int tw = this->tile_size.width, th = this->tile_size.height;
+	int w = info->size.width, h = info->size.height, x = left, y = top;
+
+	switch ((RLTileType)tile->type) {
+	case RLTILE_TEXT:
+		x += info->offset.x;
+		y += info->offset.y;
+		break;
+	case RLTILE_EXACT:
+		w = tw;
+		h = th;
+		break;
+	case RLTILE_FLOOR:
+		x += (tw - w) / 2;
+		y += th - h;
+		break;
+	case RLTILE_CENTER:
+		x += (tw - w) / 2;
+		y += (th - h) / 2;
+		break;
+	}
+
+	rect[0] = (GLfloat)x;
+	rect[1] = (GLfloat)y;
+	rect[2] = (GLfloat)(x + w);
+	rect[3] = (GLfloat)(y + h);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static int RLTileMap_FloorDiv(int a, int b)
+{
+	return a / b - (a % b != 0 && (a < 0) != (b < 0));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void RLTileMap_GetVisible(RLTileMap *this, const RLCamera *camera,
+	int bounds[4])
+{
+	const int tw = this->tile_size.width, th = this->tile_size.height;
+	int left, top;
+
+	if (!camera) {
+		bounds[0] = 0;
+		bounds[1] = 0;
+		bounds[2] = this->size.width;
+		bounds[3] = this->size.height;
+		return;
+	}
+
+	// The sub-tile offset can expose one more column and row
+	left = camera->position.x * camera->tile_size.width - this->position.x;
+	top = camera->position.y * camera->tile_size.height - this->position.y;
+	bounds[0] = RLTileMap_FloorDiv(left, tw) - RLTILEMAP_CULL_MARGIN;
+	bounds[1] = RLTileMap_FloorDiv(top, th) - RLTILEMAP_CULL_MARGIN;
+	bounds[2] = RLTileMap_FloorDiv(left + camera->viewport.width, tw) + 2 +
+		RLTILEMAP_CULL_MARGIN;
+	bounds[3] = RLTileMap_FloorDiv(top + camera->viewport.height, th) + 2 +
+		RLTILEMAP_CULL_MARGIN;
+
+	bounds[0] = CLAMP(bounds[0], 0, this->size.width);
+	bounds[1] = CLAMP(bounds[1], 0, this->size.height);
+	bounds[2] = CLAMP(bounds[2], bounds[0], this->size.width);
+	bounds[3] = CLAMP(bounds[3], bounds[1], this->size.height);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static bool RLTileMap_Reserve(RLTileMap *this, int num_vertices)
+{
+	if (num_vertices <= this->num_vertices) {
+		return true;
+	}
+
+	glBindVertexArray(this->VAO);
+
+	if (this->VBO) {
+		StreamBuffer_Destroy(this->VBO);
+	}
+	if (!(this->VBO = StreamBuffer_Create(
+		GL_ARRAY_BUFFER,
+		(GLsizeiptr)num_vertices * (GLsizeiptr)sizeof(RLTileVertex)
+		))) {
+		log_warn("Tile map vertex buffer creation failed");
+		this->num_vertices = 0;
+		glBindVertexArray(0);
+		return false;
+	}
+	this->num_vertices = num_vertices;
+
+	// Attribute offsets stay fixed, regions are selected with a base vertex
+	glVertexAttribPointer(
+		0,
+		2,
+		GL_FLOAT,
+		GL_FALSE,
+		sizeof(RLTileVertex),
+		(void *)offsetof(RLTileVertex, x)
+		);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(
+		1,
+		2,
+		GL_FLOAT,
+		GL_FALSE,
+		sizeof(RLTileVertex),
+		(void *)offsetof(RLTileVertex, u)
+		);
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(
+		2,
+		4,
+		GL_UNSIGNED_BYTE,
+		GL_TRUE,
+		sizeof(RLTileVertex),
+		(void *)offsetof(RLTileVertex, r)
+		);
+	glEnableVertexAttribArray(2);
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Public functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+RLTileMap * RLTileMap_Create(int x, int y, int width, int height,
+	int tile_width, int tile_height)
+{
+	RLTileMap *this = NULL;
+
+	if (width <= 0 || height <= 0 || tile_width <= 0 || tile_height <= 0) {
+		log_warn("Invalid tile map dimensions");
+		return NULL;
+	}
+
+	this = g_new0(RLTileMap, 1);
+	this->position.x = x;
+	this->position.y = y;
+	this->size.width = width;
+	this->size.height = height;
+	this->tile_size.width = tile_width;
+	this->tile_size.height = tile_height;
+	this->num_tiles = width * height;
+	this->tiles = g_new0(RLTile, (gsize)this->num_tiles);
+
+	// The vertex buffer is sized on first draw, once the view is known
+	glGenVertexArrays(1, &this->VAO);
+	glBindVertexArray(this->VAO);
+	QuadIndex_Bind();
+	glBindVertexArray(0);
+	return this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+RLTile * RLTileMap_GetTile(RLTileMap *this, int x, int y)
+{
+	if (!this) {
+		log_warn("NULL argument");
+		return NULL;
+	}
+	else if (x < 0 || y < 0 || x >= this->size.width ||
+		y >= this->size.height) {
+		return NULL;
+	}
+	else {
+		return &this->tiles[y * this->size.width + x];
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLTileMap_SetPalette(RLTileMap *this, const RLColor *palette)
+{
+	if (!this) {
+		log_warn("NULL argument");
+	}
+	else if (!palette) {
+		g_free(this->palette);
+		this->palette = NULL;
+	}
+	else {
+		if (!this->palette) {
+			this->palette = g_new(RLColor, RLTILEMAP_PALETTE_SIZE);
+		}
+		memcpy(
+			this->palette,
+			palette,
+			sizeof(RLColor) * RLTILEMAP_PALETTE_SIZE
+			);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int RLTileMap_Mesh(RLTileMap *this, BMFont *font, const RLCamera *camera,
+	RLTileVertex *dst)
+{
+	int bounds[4], origin_x = 0, origin_y = 0;
+	GLfloat rect[4], uv[4];
+	RLTileVertex *quad = dst;
+	const GLfloat solid[4] = {-1.0f, -1.0f, -1.0f, -1.0f};
+	const int tw = this ? this->tile_size.width : 0;
+	const int th = this ? this->tile_size.height : 0;
+
+	if (!this || !font || !dst) {
+		log_warn("NULL argument");
+		return 0;
+	}
+
+	if (camera) {
+		origin_x = camera->position.x * camera->tile_size.width;
+		origin_y = camera->position.y * camera->tile_size.height;
+	}
+
+	RLTileMap_GetVisible(this, camera, bounds);
+	for (int row = bounds[1]; row < bounds[3]; ++row) {
+		const int top = this->position.y + row * th - origin_y;
+		for (int col = bounds[0]; col < bounds[2]; ++col) {
+			const int left = this->position.x + col * tw - origin_x;
+			const RLTile *tile = &this->tiles[row * this->size.width + col];
+			const BMFontInfo *info = NULL;
+			RLColor fg = tile->fg, bg = tile->bg;
+
+			if ((tile->flags & RLTILE_PALETTE) && this->palette) {
+				fg = this->palette[fg & 0xFF];
+				bg = this->palette[bg & 0xFF];
+			}
+
+			if (RLCOLOR_A(bg)) {
+				rect[0] = (GLfloat)left;
+				rect[1] = (GLfloat)top;
+				rect[2] = (GLfloat)(left + tw);
+				rect[3] = (GLfloat)(top + th);
+				quad = RLTileMap_Quad(quad, rect, solid, bg);
+			}
+
+			if (tile->glyph && RLCOLOR_A(fg) &&
+				(info = BMFont_GetInfoPtr(font, (int)tile->glyph))) {
+				RLTileMap_Place(this, tile, info, left, top, rect);
+				uv[0] = (GLfloat)info->position.x;
+				uv[1] = (GLfloat)info->position.y;
+				uv[2] = uv[0] + (GLfloat)info->size.width;
+				uv[3] = uv[1] + (GLfloat)info->size.height;
+				quad = RLTileMap_Quad(quad, rect, uv, fg);
+			}
+		}
+	}
+
+	return (int)(quad - dst);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLTileMap_Draw(RLTileMap *this, BMFont *font, const RLCamera *camera)
+{
+	int bounds[4];
+	RLTileVertex *dst = NULL;
+	GLint base_vertex = 0;
+	int num_vertices = 0;
+
+	if (!this || !font) {
+		log_warn("NULL argument");
+		return;
+	}
+
+	// Room for a background and a glyph quad per visible tile
+	RLTileMap_GetVisible(this, camera, bounds);
+	num_vertices = (bounds[2] - bounds[0]) * (bounds[3] - bounds[1]) * 8;
+	if (!num_vertices || !RLTileMap_Reserve(this, num_vertices)) {
+		return;
+	}
+
+	glBindVertexArray(this->VAO);
+
+	Profiler_Begin(PROFILE_UPLOAD);
+	dst = StreamBuffer_Map(this->VBO);
+	Profiler_End(PROFILE_UPLOAD);
+	if (!dst) {
+		log_warn("Tile map vertex buffer mapping failed");
+		glBindVertexArray(0);
+		return;
+	}
+
+	Profiler_Begin(PROFILE_MESH);
+	num_vertices = RLTileMap_Mesh(this, font, camera, dst);
+	Profiler_End(PROFILE_MESH);
+
+	Profiler_Begin(PROFILE_UPLOAD);
+	base_vertex = (GLint)(StreamBuffer_Unmap(this->VBO) /
+		(GLintptr)sizeof(RLTileVertex));
+	Profiler_End(PROFILE_UPLOAD);
+
+	Profiler_Begin(PROFILE_DRAW);
+	QuadIndex_Draw(num_vertices / 4, base_vertex);
+	StreamBuffer_Fence(this->VBO);
+	Profiler_End(PROFILE_DRAW);
+
+	glBindVertexArray(0);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RLTileMap_Destroy(RLTileMap *this)
+{
+	if (CONDBIND(this, log_warn, "NULL argument")) {
+		if (this->VBO) {
+			StreamBuffer_Destroy(this->VBO);
+		}
+		if (this->VAO) {
+			glDeleteVertexArrays(1, &this->VAO);
+		}
+		g_free(this->tiles);
+		g_free(this->palette);
+		g_free(this);
+	}
+}
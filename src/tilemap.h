@@ -0,0 +1,135 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	tilemap.h
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Grid of glyph tiles meshed into a streaming vertex buffer
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TILEMAP_H
+#define TILEMAP_H
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include "glad.h"
+#include "bmfont.h"
+#include "streambuf.h"
+#include "tile.h"
+#include "camera.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+// Colours in a tile map palette, indexed by the low byte of a tile colour
+#define RLTILEMAP_PALETTE_SIZE 256
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+	GLfloat x, y;
+	GLfloat u, v;
+	GLubyte r, g, b, a;
+} RLTileVertex;
+
+typedef struct {
+	struct {
+		int x;
+		int y;
+	} position;
+	struct {
+		int width;
+		int height;
+	} size;
+	struct {
+		int width;
+		int height;
+	} tile_size;
+	GLuint VAO;
+	StreamBuffer *VBO;
+	int num_tiles;
+	RLTile *tiles;
+	// RLTILEMAP_PALETTE_SIZE colours, NULL while the map has none
+	RLColor *palette;
+	int num_vertices;
+} RLTileMap;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns a pointer to a new RLTileMap
+///
+/// \param	x			Left edge of the map in pixels
+/// \param	y			Top edge of the map in pixels
+/// \param	width		Width of the map in tiles
+/// \param	height		Height of the map in tiles
+/// \param	tile_width	Width of a tile in pixels
+/// \param	tile_height	Height of a tile in pixels
+///
+/// \return	Pointer to the new RLTileMap
+///////////////////////////////////////////////////////////////////////////////
+RLTileMap * RLTileMap_Create(int x, int y, int width, int height,
+	int tile_width, int tile_height);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns a pointer to the tile at a given cell
+///
+/// \param	this	An RLTileMap
+/// \param	x		Column of the tile
+/// \param	y		Row of the tile
+///
+/// \return	Pointer to the tile, or NULL if the cell is out of bounds
+///////////////////////////////////////////////////////////////////////////////
+RLTile * RLTileMap_GetTile(RLTileMap *this, int x, int y);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Sets the colours of tiles flagged RLTILE_PALETTE
+///
+/// \param	this	An RLTileMap
+/// \param	palette	RLTILEMAP_PALETTE_SIZE colours to copy, or NULL to draw
+///					palette tiles with their own colours
+///////////////////////////////////////////////////////////////////////////////
+void RLTileMap_SetPalette(RLTileMap *this, const RLColor *palette);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Writes a background quad and a glyph quad per visible tile into dst
+///
+/// Only tiles inside the camera's view plus a small margin are meshed, at
+/// pixel coordinates relative to the camera position. Texture coordinates
+/// are written in texels of the glyph atlas, negative coordinates select a
+/// solid colour. Tiles flagged RLTILE_PALETTE take their colours from the
+/// map's 256 entry palette when one is set.
+///
+/// \param	this	An RLTileMap
+/// \param	font	BMFont describing the glyph atlas
+/// \param	camera	Camera to cull against, or NULL to mesh in screen space
+/// \param	dst		Destination with room for 8 vertices per visible tile
+///
+/// \return	Number of vertices written
+///////////////////////////////////////////////////////////////////////////////
+int RLTileMap_Mesh(RLTileMap *this, BMFont *font, const RLCamera *camera,
+	RLTileVertex *dst);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Meshes the visible tiles straight into the streaming buffer and
+///			draws them
+///
+/// The streaming buffer grows to fit the visible tiles, so its size and
+/// the work per frame follow the viewport rather than the map. The caller
+/// binds the shader program and glyph atlas beforehand. Indices come from
+/// the shared quad index buffer.
+///
+/// \param	this	An RLTileMap
+/// \param	font	BMFont describing the glyph atlas
+/// \param	camera	Camera to cull against, or NULL to draw in screen space
+///////////////////////////////////////////////////////////////////////////////
+void RLTileMap_Draw(RLTileMap *this, BMFont *font, const RLCamera *camera);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Frees the memory associated with an RLTileMap
+///
+/// \param	this	An RLTileMap
+///////////////////////////////////////////////////////////////////////////////
+void RLTileMap_Destroy(RLTileMap *this);
+
+#endif
@@ -0,0 +1,294 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	timing.c
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Frame clock on integer performance counter ticks, with a fixed
+///			timestep accumulator, a frame limiter and frame time statistics
+///////////////////////////////////////////////////////////////////////////////
+
+#include "timing.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+
+#include "common.h"
+#include "log.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+// Steps the accumulator may hold after a stall before time is dropped
+#define FRAMECLOCK_MAX_STEPS 5
+
+// Final stretch of a limited frame spent spinning instead of sleeping
+#define FRAMECLOCK_SPIN_US 2000
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+struct _FrameClock {
+	Uint64 frequency;
+	Uint64 last;
+	Uint64 delta;
+	Uint64 step;
+	Uint64 accumulator;
+	Uint64 period;
+	Uint64 deadline;
+	Uint64 spin;
+	int num_samples;
+	int next_sample;
+	Uint64 samples[FRAMECLOCK_SAMPLES];
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+static int FrameClock_Compare(const void *a, const void *b)
+{
+	const Uint64 x = *(const Uint64 *)a, y = *(const Uint64 *)b;
+
+	return (x > y) - (x < y);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static double FrameClock_ToMs(FrameClock *this, Uint64 ticks)
+{
+	return (double)ticks * 1000.0 / (double)this->frequency;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Public functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+FrameClock * FrameClock_Create(int step_hz, int limit_hz)
+{
+	FrameClock *this = NULL;
+
+	if (step_hz < 0 || limit_hz < 0) {
+		log_warn("Invalid frame clock rate");
+		return NULL;
+	}
+
+	this = g_new0(FrameClock, 1);
+	this->frequency = SDL_GetPerformanceFrequency();
+	this->step = step_hz ? this->frequency / (Uint64)step_hz : 0;
+	this->period = limit_hz ? this->frequency / (Uint64)limit_hz : 0;
+	this->spin = this->frequency * FRAMECLOCK_SPIN_US / 1000000;
+
+	return this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void FrameClock_Tick(FrameClock *this)
+{
+	Uint64 now;
+
+	if (!this) {
+		log_warn("NULL argument");
+		return;
+	}
+
+	now = SDL_GetPerformanceCounter();
+
+	if (!this->last) {
+		this->delta = 0;
+		this->accumulator = this->step;
+		this->deadline = now;
+	}
+	else {
+		this->delta = now - this->last;
+		this->samples[this->next_sample] = this->delta;
+		this->next_sample = (this->next_sample + 1) % FRAMECLOCK_SAMPLES;
+		this->num_samples = MIN(this->num_samples + 1, FRAMECLOCK_SAMPLES);
+		// Drop time after a stall rather than running steps to catch up
+		this->accumulator = MIN(
+			this->accumulator + this->delta,
+			this->step * FRAMECLOCK_MAX_STEPS
+			);
+	}
+
+	this->last = now;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void FrameClock_Reset(FrameClock *this)
+{
+	if (CONDBIND(this, log_warn, "NULL argument")) {
+		this->last = 0;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool FrameClock_Step(FrameClock *this)
+{
+	if (!this) {
+		log_warn("NULL argument");
+		return false;
+	}
+	else if (!this->step || this->accumulator < this->step) {
+		return false;
+	}
+	else {
+		this->accumulator -= this->step;
+		return true;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+float FrameClock_GetAlpha(FrameClock *this)
+{
+	if (!this) {
+		log_warn("NULL argument");
+		return 0.0f;
+	}
+	else if (!this->step) {
+		return 0.0f;
+	}
+	else {
+		return (float)((double)this->accumulator / (double)this->step);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+double FrameClock_GetDelta(FrameClock *this)
+{
+	if (!this) {
+		log_warn("NULL argument");
+		return 0.0;
+	}
+	else {
+		return (double)this->delta / (double)this->frequency;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+Uint64 FrameClock_GetStepTicks(FrameClock *this)
+{
+	if (!this) {
+		log_warn("NULL argument");
+		return 0;
+	}
+	else {
+		return this->step;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void FrameClock_Limit(FrameClock *this)
+{
+	Uint64 now;
+
+	if (!this) {
+		log_warn("NULL argument");
+		return;
+	}
+	else if (!this->period) {
+		return;
+	}
+
+	now = SDL_GetPerformanceCounter();
+	this->deadline += this->period;
+
+	if (now >= this->deadline) {
+		this->deadline = now;
+		return;
+	}
+
+	if (this->deadline - now > this->spin) {
+		SDL_Delay((Uint32)((this->deadline - now - this->spin) * 1000 /
+			this->frequency));
+	}
+	while (SDL_GetPerformanceCounter() < this->deadline) {
+		// Spin, the remainder is shorter than SDL_Delay can be trusted with
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void FrameClock_GetStats(FrameClock *this, FrameStats *stats)
+{
+	Uint64 sorted[FRAMECLOCK_SAMPLES];
+	Uint64 total = 0;
+	int n;
+
+	if (!this || !stats) {
+		log_warn("NULL argument");
+		return;
+	}
+
+	*stats = (FrameStats){0, 0.0, 0.0, 0.0};
+	if (!(n = this->num_samples)) {
+		return;
+	}
+
+	// The ring is unordered once it wraps, only its contents matter
+	memcpy(sorted, this->samples, sizeof(Uint64) * (size_t)n);
+	qsort(sorted, (size_t)n, sizeof(Uint64), FrameClock_Compare);
+	for (int i = 0; i < n; ++i) {
+		total += sorted[i];
+	}
+
+	stats->samples = n;
+	stats->min = FrameClock_ToMs(this, sorted[0]);
+	stats->avg = FrameClock_ToMs(this, total) / n;
+	stats->p99 = FrameClock_ToMs(this, sorted[(n - 1) * 99 / 100]);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void FrameClock_Destroy(FrameClock *this)
+{
+	if (CONDBIND(this, log_warn, "NULL argument")) {
+		g_free(this);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void UsageMeter_Init(UsageMeter *this)
+{
+	if (CONDBIND(this, log_warn, "NULL argument")) {
+		this->start = SDL_GetPerformanceCounter();
+		this->cpu = clock();
+		this->frames = 0;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void UsageMeter_Frame(UsageMeter *this)
+{
+	if (CONDBIND(this, log_warn, "NULL argument")) {
+		++this->frames;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+double UsageMeter_Lap(UsageMeter *this, double *cpu, double *fpm)
+{
+	double wall;
+
+	if (!this || !cpu || !fpm) {
+		log_warn("NULL argument");
+		return 0.0;
+	}
+
+	wall = (double)(SDL_GetPerformanceCounter() - this->start) /
+		(double)SDL_GetPerformanceFrequency();
+	if (wall > 0.0) {
+		*cpu = (double)(clock() - this->cpu) / CLOCKS_PER_SEC / wall * 100.0;
+		*fpm = this->frames / wall * 60.0;
+	}
+	else {
+		*cpu = 0.0;
+		*fpm = 0.0;
+	}
+
+	UsageMeter_Init(this);
+	return wall;
+}
@@ -0,0 +1,178 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	timing.h
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Frame clock on integer performance counter ticks, with a fixed
+///			timestep accumulator, a frame limiter and frame time statistics
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TIMING_H
+#define TIMING_H
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <time.h>
+#include <stdbool.h>
+#include <SDL2/SDL.h>
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+// Frame times kept for the rolling statistics
+#define FRAMECLOCK_SAMPLES 256
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Frame times over the last FRAMECLOCK_SAMPLES frames, in ms
+///////////////////////////////////////////////////////////////////////////////
+typedef struct {
+	int samples;
+	double min;
+	double avg;
+	double p99;
+} FrameStats;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Process CPU time and frames drawn over a span of wall time
+///////////////////////////////////////////////////////////////////////////////
+typedef struct {
+	Uint64 start;
+	clock_t cpu;
+	int frames;
+} UsageMeter;
+
+typedef struct _FrameClock FrameClock;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns a pointer to a new FrameClock
+///
+/// \param	step_hz		Rate of the fixed steps, 0 for none
+/// \param	limit_hz	Frame rate FrameClock_Limit holds, 0 for unlimited
+///
+/// \return	Pointer to the new FrameClock
+///////////////////////////////////////////////////////////////////////////////
+FrameClock * FrameClock_Create(int step_hz, int limit_hz);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Starts a new frame
+///
+/// Measures the time since the previous call, records it for the
+/// statistics and adds it to the fixed step accumulator. The first call
+/// measures nothing but always leaves one step due.
+///
+/// \param	this	A FrameClock
+///////////////////////////////////////////////////////////////////////////////
+void FrameClock_Tick(FrameClock *this);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Forgets the previous frame
+///
+/// Call after deliberately sleeping, so the next FrameClock_Tick neither
+/// records the idle time as a frame nor owes steps for it.
+///
+/// \param	this	A FrameClock
+///////////////////////////////////////////////////////////////////////////////
+void FrameClock_Reset(FrameClock *this);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Consumes one fixed step from the accumulator
+///
+/// Meant as the condition of a loop running the fixed updates, i.e.
+///
+/// while (FrameClock_Step(clock)) {
+///		< advance animations by one step >
+/// }
+///
+/// \param	this	A FrameClock
+///
+/// \return	true if a step was due, false once the accumulator is drained
+///////////////////////////////////////////////////////////////////////////////
+bool FrameClock_Step(FrameClock *this);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns how far the accumulator is into the next step
+///
+/// \param	this	A FrameClock
+///
+/// \return	Interpolation factor in [0, 1) between the last two steps
+///////////////////////////////////////////////////////////////////////////////
+float FrameClock_GetAlpha(FrameClock *this);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns the duration of the last frame
+///
+/// \param	this	A FrameClock
+///
+/// \return	Seconds between the last two calls to FrameClock_Tick
+///////////////////////////////////////////////////////////////////////////////
+double FrameClock_GetDelta(FrameClock *this);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns the length of a fixed step
+///
+/// \param	this	A FrameClock
+///
+/// \return	Performance counter ticks per step, 0 without fixed steps
+///////////////////////////////////////////////////////////////////////////////
+Uint64 FrameClock_GetStepTicks(FrameClock *this);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Waits until the next frame is due under the frame limit
+///
+/// Sleeps for the bulk of the wait and spins the last stretch, since
+/// SDL_Delay may oversleep by a scheduler quantum. Frames that ran late
+/// reset the schedule instead of being made up with short frames.
+///
+/// \param	this	A FrameClock
+///////////////////////////////////////////////////////////////////////////////
+void FrameClock_Limit(FrameClock *this);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Computes statistics over the recent frame times
+///
+/// \param	this	A FrameClock
+/// \param	stats	Destination of the statistics
+///////////////////////////////////////////////////////////////////////////////
+void FrameClock_GetStats(FrameClock *this, FrameStats *stats);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Frees the memory associated with a FrameClock
+///
+/// \param	this	A FrameClock
+///////////////////////////////////////////////////////////////////////////////
+void FrameClock_Destroy(FrameClock *this);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Starts measuring a new span
+///
+/// \param	this	A UsageMeter
+///////////////////////////////////////////////////////////////////////////////
+void UsageMeter_Init(UsageMeter *this);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Counts a drawn frame
+///
+/// \param	this	A UsageMeter
+///////////////////////////////////////////////////////////////////////////////
+void UsageMeter_Frame(UsageMeter *this);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Reports the span so far and starts a new one
+///
+/// CPU time is summed over every thread of the process, so a busy
+/// simulation and render thread together can exceed 100 percent.
+///
+/// \param	this	A UsageMeter
+/// \param	cpu		Destination of the CPU utilisation in percent of a core
+/// \param	fpm		Destination of the frames drawn per minute
+///
+/// \return	Length of the span in seconds
+///////////////////////////////////////////////////////////////////////////////
+double UsageMeter_Lap(UsageMeter *this, double *cpu, double *fpm);
+
+#endif
@@ -0,0 +1,97 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	bench_ai.c
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Times RLAI turns at every thread count the host has cores for
+///
+/// BENCH_ACTORS monsters roam a BENCH_SIZE cave around a player standing
+/// still, for BENCH_TURNS turns per thread count.
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <glib.h>
+
+#include "ai.h"
+#include "testmaps.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+#define BENCH_SIZE 256
+#define BENCH_ACTORS 4000
+#define BENCH_TURNS 100
+#define BENCH_SIGHT 12
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+static double Bench_Play(const RLMapGrid *map, int workers, int px, int py)
+{
+	RLJobSystem *jobs = RLJobSystem_Create(workers);
+	RLAI *ai = RLAI_Create(map, jobs);
+	RLFov *fov = RLFov_Create(map, BENCH_SIGHT);
+	uint32_t seed = 7;
+	double start, elapsed;
+
+	RLFov_Update(fov, px, py);
+	while (RLAI_GetNumActors(ai) < BENCH_ACTORS) {
+		const int x = TestMaps_Range(&seed, BENCH_SIZE);
+		const int y = TestMaps_Range(&seed, BENCH_SIZE);
+
+		if (x != px || y != py) {
+			RLAI_Spawn(ai, x, y, 10);
+		}
+	}
+
+	start = TestMaps_Seconds();
+	for (int turn = 0; turn < BENCH_TURNS; ++turn) {
+		RLAI_Turn(ai, fov, px, py);
+	}
+	elapsed = TestMaps_Seconds() - start;
+
+	RLFov_Destroy(fov);
+	RLAI_Destroy(ai);
+	RLJobSystem_Destroy(jobs);
+
+	return elapsed;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Main
+///////////////////////////////////////////////////////////////////////////////
+
+int main(void)
+{
+	const int cores = (int)g_get_num_processors();
+	RLMapGrid *map = RLMapGrid_Create(BENCH_SIZE, BENCH_SIZE);
+	uint32_t seed = 3;
+	double single = 0.0;
+	int px, py;
+
+	TestMaps_Cave(map, 42, &seed);
+	TestMaps_Open(map, &seed, &px, &py);
+
+	printf("bench_ai, %d monsters on a %dx%d cave, %d cores\n", BENCH_ACTORS,
+		BENCH_SIZE, BENCH_SIZE, cores);
+	printf("  %-7s %10s %12s %8s\n", "threads", "ms/turn", "monsters/s",
+		"speedup");
+	for (int workers = 0; workers < cores; ++workers) {
+		const double elapsed = Bench_Play(map, workers, px, py);
+
+		if (!workers) {
+			single = elapsed;
+		}
+		printf("  %-7d %10.3f %12.0f %7.2fx\n", workers + 1,
+			elapsed * 1e3 / BENCH_TURNS,
+			BENCH_ACTORS * BENCH_TURNS / elapsed, single / elapsed);
+	}
+	RLMapGrid_Destroy(map);
+
+	return 0;
+}
@@ -0,0 +1,141 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	bench_dijkstra.c
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Times a turn of monsters chasing the player by a flow field
+///			against a path search per monster
+///
+/// A flow field turn computes the field from the player and steps every
+/// monster down it. A search turn asks RLPathFinder for the first step of
+/// each monster's path. Each turn repeats until BENCH_SECONDS pass.
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <glib.h>
+
+#include "dijkstra.h"
+#include "path.h"
+#include "testmaps.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+#define BENCH_SECONDS 0.5
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static variables
+///////////////////////////////////////////////////////////////////////////////
+
+static RLMapGrid *map = NULL;
+static RLFlowField *field = NULL;
+static RLPathFinder *finder = NULL;
+static RLPathPoint player;
+static RLPathPoint *monsters = NULL;
+static int num_monsters = 0;
+static volatile long sink;
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+static void Bench_FlowTurn(void)
+{
+	RLFlowField_AddSource(field, player.x, player.y, 0);
+	RLFlowField_Compute(field);
+	for (int i = 0; i < num_monsters; ++i) {
+		int dx, dy;
+
+		sink += RLFlowField_Step(field, monsters[i].x, monsters[i].y, &dx,
+			&dy);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Bench_SearchTurn(RLPathMode mode)
+{
+	for (int i = 0; i < num_monsters; ++i) {
+		RLPathPoint step;
+
+		sink += RLPathFinder_Find(finder, mode, monsters[i].x, monsters[i].y,
+			player.x, player.y, &step, 1);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Bench_AStarTurn(void)
+{
+	Bench_SearchTurn(RLPATH_ASTAR);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Bench_JpsTurn(void)
+{
+	Bench_SearchTurn(RLPATH_JPS);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static double Bench_Time(void (*turn)(void))
+{
+	const double start = TestMaps_Seconds();
+	double elapsed = 0.0;
+	long turns = 0;
+
+	do {
+		turn();
+		elapsed = TestMaps_Seconds() - start;
+		++turns;
+	} while (elapsed < BENCH_SECONDS);
+
+	return elapsed * 1e3 / (double)turns;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Bench_Map(int size)
+{
+	static const int counts[] = {10, 100, 1000};
+	uint32_t seed = 1;
+
+	map = RLMapGrid_Create(size, size);
+	TestMaps_Cave(map, 45, &seed);
+	field = RLFlowField_Create(map);
+	finder = RLPathFinder_Create(map);
+	TestMaps_Open(map, &seed, &player.x, &player.y);
+
+	for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c) {
+		num_monsters = counts[c];
+		monsters = g_new(RLPathPoint, (gsize)num_monsters);
+		for (int i = 0; i < num_monsters; ++i) {
+			TestMaps_Open(map, &seed, &monsters[i].x, &monsters[i].y);
+		}
+
+		printf("  %4d x %-4d %4d %10.3f %10.3f %10.3f\n", size, size,
+			num_monsters, Bench_Time(Bench_FlowTurn),
+			Bench_Time(Bench_AStarTurn), Bench_Time(Bench_JpsTurn));
+
+		g_free(monsters);
+	}
+
+	RLPathFinder_Destroy(finder);
+	RLFlowField_Destroy(field);
+	RLMapGrid_Destroy(map);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Main
+///////////////////////////////////////////////////////////////////////////////
+
+int main(void)
+{
+	printf("bench_dijkstra, cave maps, ms per turn\n");
+	printf("  %-11s %4s %10s %10s %10s\n", "map", "mobs", "flow field", "A*",
+		"JPS");
+	Bench_Map(256);
+	Bench_Map(1024);
+
+	return 0;
+}
@@ -0,0 +1,193 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	bench_ecs.c
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Times a pass over entities with a position and a glyph, stored
+///			by RLWorld and as an array of structs with every field
+///
+/// Half the entities also have health and a third an AI state, which the
+/// pass skips over. The cost of spawning, adding and removing a component
+/// and despawning is timed after.
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <glib.h>
+
+#include "ecs.h"
+#include "testmaps.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+#define BENCH_ENTITIES 100000
+#define BENCH_PASSES 200
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+	int x;
+	int y;
+} BenchPosition;
+
+typedef struct {
+	int glyph;
+	uint32_t fg;
+	uint32_t bg;
+} BenchGlyph;
+
+typedef struct {
+	int hp;
+	int max_hp;
+} BenchHealth;
+
+typedef struct {
+	int state[8];
+} BenchBrain;
+
+///////////////////////////////////////////////////////////////////////////////
+/// An entity as a struct with room for every component
+///////////////////////////////////////////////////////////////////////////////
+typedef struct {
+	bool alive;
+	bool has_position;
+	bool has_glyph;
+	bool has_health;
+	bool has_brain;
+	BenchPosition position;
+	BenchGlyph glyph;
+	BenchHealth health;
+	BenchBrain brain;
+	char name[32];
+} BenchEntity;
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+static long Bench_DrawArray(const BenchEntity *entities)
+{
+	long sum = 0;
+
+	for (int i = 0; i < BENCH_ENTITIES; ++i) {
+		const BenchEntity *entity = &entities[i];
+
+		if (entity->alive && entity->has_position && entity->has_glyph) {
+			sum += entity->position.x * 31 + entity->position.y +
+				entity->glyph.glyph;
+		}
+	}
+
+	return sum;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Bench_DrawTable(void *data, int count, const RLEntity *entities,
+	void **columns)
+{
+	const BenchPosition *positions = columns[0];
+	const BenchGlyph *glyphs = columns[1];
+	long *sum = data;
+
+	(void)entities;
+	for (int i = 0; i < count; ++i) {
+		*sum += positions[i].x * 31 + positions[i].y + glyphs[i].glyph;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Main
+///////////////////////////////////////////////////////////////////////////////
+
+int main(void)
+{
+	BenchEntity *array = g_new0(BenchEntity, BENCH_ENTITIES);
+	RLEntity *handles = g_new(RLEntity, BENCH_ENTITIES);
+	RLWorld *world = RLWorld_Create();
+	const int position = RLWorld_RegisterComponent(world,
+		sizeof(BenchPosition));
+	const int glyph = RLWorld_RegisterComponent(world, sizeof(BenchGlyph));
+	const int health = RLWorld_RegisterComponent(world, sizeof(BenchHealth));
+	const int brain = RLWorld_RegisterComponent(world, sizeof(BenchBrain));
+	RLQuery *query = NULL;
+	double start, pass_array, pass_world, spawn, change, despawn;
+	long array_sum = 0, world_sum = 0;
+
+	for (int i = 0; i < BENCH_ENTITIES; ++i) {
+		const RLEntity entity = RLWorld_Spawn(world);
+		BenchEntity *entry = &array[i];
+
+		entry->alive = entry->has_position = entry->has_glyph = true;
+		entry->position.x = i % 256;
+		entry->position.y = i / 256;
+		entry->glyph.glyph = i & 127;
+		*(BenchPosition *)RLWorld_Add(world, entity, position) =
+			entry->position;
+		*(BenchGlyph *)RLWorld_Add(world, entity, glyph) = entry->glyph;
+		if (i % 2) {
+			entry->has_health = true;
+			RLWorld_Add(world, entity, health);
+		}
+		if (i % 3 == 0) {
+			entry->has_brain = true;
+			RLWorld_Add(world, entity, brain);
+		}
+	}
+
+	start = TestMaps_Seconds();
+	for (int i = 0; i < BENCH_PASSES; ++i) {
+		array_sum += Bench_DrawArray(array);
+	}
+	pass_array = (TestMaps_Seconds() - start) / BENCH_PASSES;
+
+	query = RLWorld_CreateQuery(world, RLECS_BIT(position) |
+		RLECS_BIT(glyph), 0);
+	start = TestMaps_Seconds();
+	for (int i = 0; i < BENCH_PASSES; ++i) {
+		RLQuery_Each(query, Bench_DrawTable, &world_sum);
+	}
+	pass_world = (TestMaps_Seconds() - start) / BENCH_PASSES;
+
+	start = TestMaps_Seconds();
+	for (int i = 0; i < BENCH_ENTITIES; ++i) {
+		handles[i] = RLWorld_Spawn(world);
+	}
+	spawn = (TestMaps_Seconds() - start) / BENCH_ENTITIES;
+
+	start = TestMaps_Seconds();
+	for (int i = 0; i < BENCH_ENTITIES; ++i) {
+		RLWorld_Add(world, handles[i], position);
+	}
+	for (int i = 0; i < BENCH_ENTITIES; ++i) {
+		RLWorld_Remove(world, handles[i], position);
+	}
+	change = (TestMaps_Seconds() - start) / (2 * BENCH_ENTITIES);
+
+	start = TestMaps_Seconds();
+	for (int i = 0; i < BENCH_ENTITIES; ++i) {
+		RLWorld_Despawn(world, handles[i]);
+	}
+	despawn = (TestMaps_Seconds() - start) / BENCH_ENTITIES;
+
+	printf("bench_ecs, %d entities with a position and a glyph\n",
+		BENCH_ENTITIES);
+	printf("  %-22s %10.1f us\n", "array of structs pass", pass_array * 1e6);
+	printf("  %-22s %10.1f us %7.2fx%s\n", "RLQuery_Each pass",
+		pass_world * 1e6, pass_array / pass_world,
+		array_sum == world_sum ? "" : " (sums differ)");
+	printf("  %-22s %10.0f ns\n", "spawn", spawn * 1e9);
+	printf("  %-22s %10.0f ns\n", "add or remove", change * 1e9);
+	printf("  %-22s %10.0f ns\n", "despawn", despawn * 1e9);
+
+	RLWorld_Destroy(world);
+	g_free(handles);
+	g_free(array);
+
+	return 0;
+}
@@ -0,0 +1,76 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	bench_fov.c
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Times RLFov recomputes on cave maps of a few sizes
+///
+/// The viewer moves to a new open cell before each update, so every update
+/// recomputes.
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <glib.h>
+
+#include "fov.h"
+#include "testmaps.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+#define BENCH_VIEWERS 256
+#define BENCH_SECONDS 0.5
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+static void Bench_Map(int size, int radius)
+{
+	uint32_t seed = 1;
+	RLMapGrid *map = RLMapGrid_Create(size, size);
+	RLFov *fov = RLFov_Create(map, radius);
+	int x[BENCH_VIEWERS], y[BENCH_VIEWERS];
+	double start, elapsed = 0.0;
+	long updates = 0;
+
+	TestMaps_Cave(map, 45, &seed);
+	for (int i = 0; i < BENCH_VIEWERS; ++i) {
+		TestMaps_Open(map, &seed, &x[i], &y[i]);
+	}
+
+	start = TestMaps_Seconds();
+	do {
+		RLFov_Update(fov, x[updates % BENCH_VIEWERS],
+			y[updates % BENCH_VIEWERS]);
+		elapsed = TestMaps_Seconds() - start;
+		++updates;
+	} while (elapsed < BENCH_SECONDS);
+
+	printf("  %4d x %-4d radius %-9s %10.0f %10.1f\n", size, size,
+		radius ? "16" : "unlimited", (double)updates / elapsed,
+		elapsed * 1e6 / (double)updates);
+
+	RLFov_Destroy(fov);
+	RLMapGrid_Destroy(map);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Main
+///////////////////////////////////////////////////////////////////////////////
+
+int main(void)
+{
+	printf("bench_fov, cave maps\n");
+	printf("  %-28s %10s %10s\n", "map", "per second", "us each");
+	Bench_Map(256, 0);
+	Bench_Map(256, 16);
+	Bench_Map(1024, 0);
+	Bench_Map(1024, 16);
+
+	return 0;
+}
@@ -0,0 +1,174 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	bench_hpa.c
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Times RLPathHierarchy against RLPathFinder on long queries over
+///			cave and room maps
+///
+/// Each map gets BENCH_QUERIES pairs of open cells at least BENCH_DISTANCE
+/// apart on some axis and joined by a path. RLPathFinder writes the whole
+/// path, the hierarchy's query and full refine are timed apart. An edit is
+/// one cell flipped, then the next query, which rebuilds the clusters
+/// around it.
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <glib.h>
+
+#include "hpa.h"
+#include "path.h"
+#include "testmaps.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+#define BENCH_SIZE 1024
+#define BENCH_QUERIES 50
+#define BENCH_DISTANCE 700
+#define BENCH_MAX_POINTS 65536
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static variables
+///////////////////////////////////////////////////////////////////////////////
+
+static RLPathPoint path[BENCH_MAX_POINTS];
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+static void Bench_Finder(RLPathFinder *finder, RLPathMode mode,
+	const RLPathPoint *queries, const char *map_name)
+{
+	const double start = TestMaps_Seconds();
+	long expanded = 0;
+
+	for (int i = 0; i < BENCH_QUERIES; ++i) {
+		RLPathFinder_Find(finder, mode, queries[2 * i].x, queries[2 * i].y,
+			queries[2 * i + 1].x, queries[2 * i + 1].y, path,
+			BENCH_MAX_POINTS);
+		expanded += RLPathFinder_GetExpanded(finder);
+	}
+
+	printf("  %-6s %-6s %10.3f %10.0f %10s %10s %10s\n", map_name,
+		mode == RLPATH_JPS ? "JPS" : "A*",
+		(TestMaps_Seconds() - start) * 1e3 / BENCH_QUERIES,
+		(double)expanded / BENCH_QUERIES, "-", "-", "-");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Bench_Hierarchy(RLMapGrid *map, int cluster_size,
+	const RLPathPoint *queries, const char *map_name)
+{
+	RLPathHierarchy *hierarchy = NULL;
+	RLPathPoint edits[BENCH_QUERIES];
+	uint32_t seed = 9;
+	double start, build, find = 0.0, refine = 0.0, edit;
+	long expanded = 0;
+	char name[16];
+
+	start = TestMaps_Seconds();
+	hierarchy = RLPathHierarchy_Create(map, cluster_size);
+	build = TestMaps_Seconds() - start;
+
+	for (int i = 0; i < BENCH_QUERIES; ++i) {
+		double refined;
+		int written;
+
+		start = TestMaps_Seconds();
+		RLPathHierarchy_Find(hierarchy, queries[2 * i].x, queries[2 * i].y,
+			queries[2 * i + 1].x, queries[2 * i + 1].y);
+		refined = TestMaps_Seconds();
+		do {
+			written = RLPathHierarchy_Refine(hierarchy, path,
+				BENCH_MAX_POINTS);
+		} while (written > 0);
+		find += refined - start;
+		refine += TestMaps_Seconds() - refined;
+		expanded += RLPathHierarchy_GetExpanded(hierarchy);
+	}
+
+	// Each cell is walled in before a query and opened again before another
+	for (int i = 0; i < BENCH_QUERIES; ++i) {
+		TestMaps_Open(map, &seed, &edits[i].x, &edits[i].y);
+	}
+	start = TestMaps_Seconds();
+	for (int pass = 0; pass < 2; ++pass) {
+		for (int i = 0; i < BENCH_QUERIES; ++i) {
+			RLMapGrid_SetBit(map, RLMAP_WALKABLE, edits[i].x, edits[i].y,
+				pass);
+			RLPathHierarchy_Find(hierarchy, queries[2 * i].x,
+				queries[2 * i].y, queries[2 * i + 1].x,
+				queries[2 * i + 1].y);
+		}
+	}
+	edit = (TestMaps_Seconds() - start) / (2 * BENCH_QUERIES);
+
+	snprintf(name, sizeof(name), "HPA %d", cluster_size);
+	printf("  %-6s %-6s %10.3f %10.0f %10.3f %10.3f %10.1f\n", map_name,
+		name, find * 1e3 / BENCH_QUERIES, (double)expanded / BENCH_QUERIES,
+		refine * 1e3 / BENCH_QUERIES, edit * 1e3, build * 1e3);
+
+	RLPathHierarchy_Destroy(hierarchy);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Bench_Map(bool rooms)
+{
+	const char *map_name = rooms ? "rooms" : "cave";
+	uint32_t seed = 1;
+	RLMapGrid *map = RLMapGrid_Create(BENCH_SIZE, BENCH_SIZE);
+	RLPathFinder *finder = NULL;
+	RLPathPoint *queries = g_new(RLPathPoint, 2 * BENCH_QUERIES);
+
+	if (rooms) {
+		TestMaps_Rooms(map, &seed);
+	}
+	else {
+		TestMaps_Cave(map, 45, &seed);
+	}
+	finder = RLPathFinder_Create(map);
+
+	for (int i = 0; i < BENCH_QUERIES; ++i) {
+		RLPathPoint *start = &queries[2 * i], *goal = &queries[2 * i + 1];
+
+		do {
+			TestMaps_Open(map, &seed, &start->x, &start->y);
+			TestMaps_Open(map, &seed, &goal->x, &goal->y);
+		} while ((abs(goal->x - start->x) < BENCH_DISTANCE &&
+			abs(goal->y - start->y) < BENCH_DISTANCE) ||
+			RLPathFinder_Find(finder, RLPATH_JPS, start->x, start->y,
+			goal->x, goal->y, NULL, 0) < 0);
+	}
+
+	Bench_Finder(finder, RLPATH_ASTAR, queries, map_name);
+	Bench_Finder(finder, RLPATH_JPS, queries, map_name);
+	Bench_Hierarchy(map, 16, queries, map_name);
+	Bench_Hierarchy(map, 32, queries, map_name);
+
+	g_free(queries);
+	RLPathFinder_Destroy(finder);
+	RLMapGrid_Destroy(map);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Main
+///////////////////////////////////////////////////////////////////////////////
+
+int main(void)
+{
+	printf("bench_hpa, %dx%d maps, %d queries at least %d cells apart\n",
+		BENCH_SIZE, BENCH_SIZE, BENCH_QUERIES, BENCH_DISTANCE);
+	printf("  %-6s %-6s %10s %10s %10s %10s %10s\n", "map", "search",
+		"query ms", "expanded", "refine ms", "edit ms", "build ms");
+	Bench_Map(false);
+	Bench_Map(true);
+
+	return 0;
+}
@@ -0,0 +1,125 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	bench_jobs.c
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Times RLJobSystem_ParallelFor at every worker count the host has
+///			cores for
+///
+/// The work is a 3x3 box filter over a BENCH_SIZE grid, a row per index,
+/// timed serially and then with 0 to one less than the cores' workers. The
+/// cost of a slice is timed with empty slices.
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <math.h>
+#include <stdio.h>
+#include <glib.h>
+
+#include "jobs.h"
+#include "testmaps.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+#define BENCH_SIZE 2048
+#define BENCH_FILTERS 10
+#define BENCH_EMPTY_RUNS 10000
+#define BENCH_EMPTY_SLICES 64
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static variables
+///////////////////////////////////////////////////////////////////////////////
+
+static float *src = NULL;
+static float *dst = NULL;
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+static void Bench_Filter(void *data, int begin, int end)
+{
+	(void)data;
+
+	// The border rows and columns are left as they are
+	for (int y = MAX(begin, 1); y < MIN(end, BENCH_SIZE - 1); ++y) {
+		for (int x = 1; x < BENCH_SIZE - 1; ++x) {
+			float sum = 0.0f;
+
+			for (int dy = -1; dy <= 1; ++dy) {
+				for (int dx = -1; dx <= 1; ++dx) {
+					sum += src[(y + dy) * BENCH_SIZE + x + dx];
+				}
+			}
+			dst[y * BENCH_SIZE + x] = sqrtf(sum / 9.0f);
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Bench_Empty(void *data, int begin, int end)
+{
+	(void)data;
+	(void)begin;
+	(void)end;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Main
+///////////////////////////////////////////////////////////////////////////////
+
+int main(void)
+{
+	const int cores = (int)g_get_num_processors();
+	double start, serial;
+
+	src = g_new(float, BENCH_SIZE * BENCH_SIZE);
+	dst = g_new0(float, BENCH_SIZE * BENCH_SIZE);
+	for (int i = 0; i < BENCH_SIZE * BENCH_SIZE; ++i) {
+		src[i] = (float)(i % 97);
+	}
+
+	start = TestMaps_Seconds();
+	for (int i = 0; i < BENCH_FILTERS; ++i) {
+		Bench_Filter(NULL, 0, BENCH_SIZE);
+	}
+	serial = (TestMaps_Seconds() - start) / BENCH_FILTERS;
+
+	printf("bench_jobs, %dx%d 3x3 filter on %d cores\n", BENCH_SIZE,
+		BENCH_SIZE, cores);
+	printf("  %-7s %10s %8s %12s\n", "threads", "filter ms", "speedup",
+		"slice ns");
+	printf("  %-7s %10.2f\n", "serial", serial * 1e3);
+	for (int workers = 0; workers < cores; ++workers) {
+		RLJobSystem *jobs = RLJobSystem_Create(workers);
+		double filter, slice;
+
+		start = TestMaps_Seconds();
+		for (int i = 0; i < BENCH_FILTERS; ++i) {
+			RLJobSystem_ParallelFor(jobs, 0, BENCH_SIZE, 0, Bench_Filter,
+				NULL);
+		}
+		filter = (TestMaps_Seconds() - start) / BENCH_FILTERS;
+
+		start = TestMaps_Seconds();
+		for (int i = 0; i < BENCH_EMPTY_RUNS; ++i) {
+			RLJobSystem_ParallelFor(jobs, 0, BENCH_EMPTY_SLICES, 1,
+				Bench_Empty, NULL);
+		}
+		slice = (TestMaps_Seconds() - start) / BENCH_EMPTY_RUNS /
+			BENCH_EMPTY_SLICES;
+
+		printf("  %-7d %10.2f %7.2fx %12.0f\n", workers + 1, filter * 1e3,
+			serial / filter, slice * 1e9);
+		RLJobSystem_Destroy(jobs);
+	}
+
+	g_free(src);
+	g_free(dst);
+
+	return 0;
+}
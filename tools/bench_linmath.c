@@ -0,0 +1,271 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	bench_linmath.c
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Times the linmath kernels against their scalar references
+///
+/// Each kernel runs over arrays of BENCH_COUNT operands, or batches of
+/// BENCH_POINTS points, until BENCH_SECONDS pass. The batch transforms are
+/// also timed as a loop of mat4x4_mul_vec4, the way callers used to do it.
+/// `make bench` builds this with the default extensions and with
+/// -march=native.
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+
+#include "linmath_ref.h"
+#include "testmaps.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+#define BENCH_COUNT 1024
+#define BENCH_POINTS 4096
+#define BENCH_SECONDS 0.2
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static variables
+///////////////////////////////////////////////////////////////////////////////
+
+static mat4x4 a[BENCH_COUNT], b[BENCH_COUNT], out[BENCH_COUNT];
+static vec4 v[BENCH_COUNT], r[BENCH_COUNT];
+static float x[BENCH_POINTS], y[BENCH_POINTS], z[BENCH_POINTS];
+static float rx[BENCH_POINTS], ry[BENCH_POINTS], rz[BENCH_POINTS];
+static volatile float sink;
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+static void Bench_Mul(void)
+{
+	for (int i = 0; i < BENCH_COUNT; ++i) {
+		mat4x4_mul(out[i], a[i], b[i]);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Bench_RefMul(void)
+{
+	for (int i = 0; i < BENCH_COUNT; ++i) {
+		Ref_Mul(out[i], a[i], b[i]);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Bench_MulVec4(void)
+{
+	for (int i = 0; i < BENCH_COUNT; ++i) {
+		mat4x4_mul_vec4(r[i], a[i], v[i]);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Bench_RefMulVec4(void)
+{
+	for (int i = 0; i < BENCH_COUNT; ++i) {
+		Ref_MulVec4(r[i], a[i], v[i]);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Bench_Transpose(void)
+{
+	for (int i = 0; i < BENCH_COUNT; ++i) {
+		mat4x4_transpose(out[i], a[i]);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Bench_RefTranspose(void)
+{
+	for (int i = 0; i < BENCH_COUNT; ++i) {
+		Ref_Transpose(out[i], a[i]);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Bench_Invert(void)
+{
+	for (int i = 0; i < BENCH_COUNT; ++i) {
+		mat4x4_invert(out[i], a[i]);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Bench_RefInvert(void)
+{
+	for (int i = 0; i < BENCH_COUNT; ++i) {
+		Ref_Invert(out[i], a[i]);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Bench_Vec3Batch(void)
+{
+	mat4x4_mul_vec3_batch(rx, ry, rz, a[0], x, y, z, BENCH_POINTS);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Bench_Vec3Each(void)
+{
+	for (int i = 0; i < BENCH_POINTS; ++i) {
+		vec4 p = {x[i], y[i], z[i], 1.0f}, q;
+
+		mat4x4_mul_vec4(q, a[0], p);
+		rx[i] = q[0];
+		ry[i] = q[1];
+		rz[i] = q[2];
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Bench_RefVec3Batch(void)
+{
+	Ref_MulVec3Batch(rx, ry, rz, a[0], x, y, z, BENCH_POINTS);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Bench_Vec2Batch(void)
+{
+	mat4x4_mul_vec2_batch(rx, ry, a[0], x, y, BENCH_POINTS);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Bench_Vec2Each(void)
+{
+	for (int i = 0; i < BENCH_POINTS; ++i) {
+		vec4 p = {x[i], y[i], 0.0f, 1.0f}, q;
+
+		mat4x4_mul_vec4(q, a[0], p);
+		rx[i] = q[0];
+		ry[i] = q[1];
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Bench_RefVec2Batch(void)
+{
+	Ref_MulVec2Batch(rx, ry, a[0], x, y, BENCH_POINTS);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Bench_ScaleTranslate(void)
+{
+	vec2_scale_translate_batch(rx, ry, x, y, BENCH_POINTS, 8.0f, 16.0f,
+		-4.0f, 2.0f);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Bench_ScaleTranslateEach(void)
+{
+	for (int i = 0; i < BENCH_POINTS; ++i) {
+		vec4 p = {x[i], y[i], 0.0f, 1.0f}, q;
+
+		mat4x4_mul_vec4(q, b[0], p);
+		rx[i] = q[0];
+		ry[i] = q[1];
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Bench_RefScaleTranslate(void)
+{
+	Ref_ScaleTranslateBatch(rx, ry, x, y, BENCH_POINTS, 8.0f, 16.0f, -4.0f,
+		2.0f);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static double Bench_Time(void (*func)(void), int count)
+{
+	const double start = TestMaps_Seconds();
+	double elapsed = 0.0;
+	long calls = 0;
+
+	// Reading a result keeps the loops from being optimised away
+	do {
+		func();
+		sink += out[calls % BENCH_COUNT][0][0] + r[calls % BENCH_COUNT][0] +
+			rx[calls % BENCH_POINTS];
+		elapsed = TestMaps_Seconds() - start;
+		++calls;
+	} while (elapsed < BENCH_SECONDS);
+
+	return elapsed * 1e9 / (double)calls / count;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Bench_Compare(const char *name, void (*kernel)(void),
+	void (*reference)(void))
+{
+	const double simd = Bench_Time(kernel, BENCH_COUNT);
+	const double scalar = Bench_Time(reference, BENCH_COUNT);
+
+	printf("  %-28s %8.2f %8.2f %7.2fx\n", name, simd, scalar, scalar / simd);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Bench_Throughput(const char *name, void (*batch)(void),
+	void (*each)(void), void (*reference)(void))
+{
+	const double simd = Bench_Time(batch, BENCH_POINTS);
+	const double vec4 = Bench_Time(each, BENCH_POINTS);
+	const double scalar = Bench_Time(reference, BENCH_POINTS);
+
+	printf("  %-28s %8.0f %8.0f %8.0f\n", name, 1e3 / simd, 1e3 / vec4,
+		1e3 / scalar);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Main
+///////////////////////////////////////////////////////////////////////////////
+
+int main(void)
+{
+	uint32_t seed = 1;
+
+	for (int i = 0; i < BENCH_COUNT; ++i) {
+		for (int j = 0; j < 16; ++j) {
+			a[i][j / 4][j % 4] = (float)TestMaps_Range(&seed, 1000) / 100.0f;
+			b[i][j / 4][j % 4] = (float)TestMaps_Range(&seed, 1000) / 100.0f;
+		}
+		for (int j = 0; j < 4; ++j) {
+			a[i][j][j] += 40.0f;
+			v[i][j] = (float)TestMaps_Range(&seed, 1000) / 100.0f;
+		}
+	}
+	for (int i = 0; i < BENCH_POINTS; ++i) {
+		x[i] = (float)TestMaps_Range(&seed, 1000) / 10.0f;
+		y[i] = (float)TestMaps_Range(&seed, 1000) / 10.0f;
+		z[i] = (float)TestMaps_Range(&seed, 1000) / 10.0f;
+	}
+
+	// The scale and translation vec2_scale_translate_batch is given
+	mat4x4_identity(b[0]);
+	mat4x4_scale_aniso(b[0], b[0], 8.0f, 16.0f, 1.0f);
+	b[0][3][0] = -4.0f;
+	b[0][3][1] = 2.0f;
+
+	printf("bench_linmath (%s), ns per call\n", REF_KERNELS);
+	printf("  %-28s %8s %8s %8s\n", "kernel", "linmath", "scalar", "speedup");
+	Bench_Compare("mat4x4_mul", Bench_Mul, Bench_RefMul);
+	Bench_Compare("mat4x4_mul_vec4", Bench_MulVec4, Bench_RefMulVec4);
+	Bench_Compare("mat4x4_transpose", Bench_Transpose, Bench_RefTranspose);
+	Bench_Compare("mat4x4_invert", Bench_Invert, Bench_RefInvert);
+
+	printf("bench_linmath (%s), million points per second\n", REF_KERNELS);
+	printf("  %-28s %8s %8s %8s\n", "kernel", "batch", "mul_vec4", "scalar");
+	Bench_Throughput("mat4x4_mul_vec3_batch", Bench_Vec3Batch, Bench_Vec3Each,
+		Bench_RefVec3Batch);
+	Bench_Throughput("mat4x4_mul_vec2_batch", Bench_Vec2Batch, Bench_Vec2Each,
+		Bench_RefVec2Batch);
+	Bench_Throughput("vec2_scale_translate_batch", Bench_ScaleTranslate,
+		Bench_ScaleTranslateEach, Bench_RefScaleTranslate);
+
+	return 0;
+}
@@ -0,0 +1,100 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	bench_path.c
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Times RLPathFinder on random queries over cave and room maps
+///
+/// Each map gets BENCH_QUERIES pairs of open cells joined by a path, which
+/// both search modes then answer in turn.
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <glib.h>
+
+#include "path.h"
+#include "testmaps.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+#define BENCH_QUERIES 1000
+#define BENCH_MAX_POINTS 65536
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static variables
+///////////////////////////////////////////////////////////////////////////////
+
+static RLPathPoint path[BENCH_MAX_POINTS];
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+static void Bench_Map(int size, bool rooms)
+{
+	uint32_t seed = 1;
+	RLMapGrid *map = RLMapGrid_Create(size, size);
+	RLPathFinder *finder = NULL;
+	RLPathPoint *queries = g_new(RLPathPoint, 2 * BENCH_QUERIES);
+
+	if (rooms) {
+		TestMaps_Rooms(map, &seed);
+	}
+	else {
+		TestMaps_Cave(map, 45, &seed);
+	}
+	finder = RLPathFinder_Create(map);
+
+	for (int i = 0; i < BENCH_QUERIES; ++i) {
+		RLPathPoint *start = &queries[2 * i], *goal = &queries[2 * i + 1];
+
+		do {
+			TestMaps_Open(map, &seed, &start->x, &start->y);
+			TestMaps_Open(map, &seed, &goal->x, &goal->y);
+		} while (RLPathFinder_Find(finder, RLPATH_JPS, start->x, start->y,
+			goal->x, goal->y, NULL, 0) < 0);
+	}
+
+	for (int mode = RLPATH_ASTAR; mode <= RLPATH_JPS; ++mode) {
+		const double start = TestMaps_Seconds();
+		double elapsed;
+		long expanded = 0;
+
+		for (int i = 0; i < BENCH_QUERIES; ++i) {
+			RLPathFinder_Find(finder, (RLPathMode)mode, queries[2 * i].x,
+				queries[2 * i].y, queries[2 * i + 1].x, queries[2 * i + 1].y,
+				path, BENCH_MAX_POINTS);
+			expanded += RLPathFinder_GetExpanded(finder);
+		}
+		elapsed = TestMaps_Seconds() - start;
+
+		printf("  %4d x %-4d %-6s %-4s %10.0f %12.0f\n", size, size,
+			rooms ? "rooms" : "cave", mode == RLPATH_JPS ? "JPS" : "A*",
+			BENCH_QUERIES / elapsed, (double)expanded / BENCH_QUERIES);
+	}
+
+	g_free(queries);
+	RLPathFinder_Destroy(finder);
+	RLMapGrid_Destroy(map);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Main
+///////////////////////////////////////////////////////////////////////////////
+
+int main(void)
+{
+	printf("bench_path, %d random queries\n", BENCH_QUERIES);
+	printf("  %-23s %10s %12s\n", "map", "queries/s", "expanded/q");
+	Bench_Map(256, false);
+	Bench_Map(256, true);
+	Bench_Map(1024, false);
+	Bench_Map(1024, true);
+
+	return 0;
+}
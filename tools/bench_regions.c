@@ -0,0 +1,103 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	bench_regions.c
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Times RLRegions relabelling after single-cell edits against
+///			labelling the whole map
+///
+/// BENCH_EDITS random walkable cells are closed one at a time, then opened
+/// again in reverse order, each edit reported with RLRegions_Update. Edits
+/// are timed one by one, so averages below the clock's microsecond only
+/// hold over many of them.
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <glib.h>
+
+#include "path.h"
+#include "regions.h"
+#include "testmaps.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+#define BENCH_SIZE 1024
+#define BENCH_EDITS 20000
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+static double Bench_Edit(RLMapGrid *map, RLRegions *regions, int x, int y,
+	bool walkable)
+{
+	const double start = TestMaps_Seconds();
+
+	RLMapGrid_SetBit(map, RLMAP_WALKABLE, x, y, walkable);
+	RLRegions_Update(regions, x, y);
+
+	return TestMaps_Seconds() - start;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Bench_Map(bool rooms)
+{
+	uint32_t seed = 1;
+	RLMapGrid *map = RLMapGrid_Create(BENCH_SIZE, BENCH_SIZE);
+	RLRegions *regions = NULL;
+	RLPathPoint *cells = g_new(RLPathPoint, BENCH_EDITS);
+	double start, label, close = 0.0, open = 0.0, worst = 0.0;
+
+	if (rooms) {
+		TestMaps_Rooms(map, &seed);
+	}
+	else {
+		TestMaps_Cave(map, 42, &seed);
+	}
+
+	start = TestMaps_Seconds();
+	regions = RLRegions_Create(map);
+	label = TestMaps_Seconds() - start;
+
+	// Closing a cell may split its region, the costly case
+	for (int i = 0; i < BENCH_EDITS; ++i) {
+		double elapsed;
+
+		TestMaps_Open(map, &seed, &cells[i].x, &cells[i].y);
+		elapsed = Bench_Edit(map, regions, cells[i].x, cells[i].y, false);
+		close += elapsed;
+		worst = MAX(worst, elapsed);
+	}
+	for (int i = BENCH_EDITS - 1; i >= 0; --i) {
+		open += Bench_Edit(map, regions, cells[i].x, cells[i].y, true);
+	}
+
+	printf("  %-6s %10.2f %10.3f %10.0f %10.3f\n", rooms ? "rooms" : "cave",
+		label * 1e3, close * 1e6 / BENCH_EDITS, worst * 1e6,
+		open * 1e6 / BENCH_EDITS);
+
+	g_free(cells);
+	RLRegions_Destroy(regions);
+	RLMapGrid_Destroy(map);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Main
+///////////////////////////////////////////////////////////////////////////////
+
+int main(void)
+{
+	printf("bench_regions, %d x %d maps, %d edits\n", BENCH_SIZE, BENCH_SIZE,
+		BENCH_EDITS);
+	printf("  %-6s %10s %10s %10s %10s\n", "map", "label ms", "close us",
+		"worst us", "open us");
+	Bench_Map(false);
+	Bench_Map(true);
+
+	return 0;
+}
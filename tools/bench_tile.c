@@ -0,0 +1,144 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	bench_tile.c
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Times RLTile_Fill and RLTile_Fade on BENCH_TILES tiles against
+///			plain loops over the old 24 byte record
+///
+/// The old record held the glyph, an int per colour channel and the type,
+/// with a single colour. Its fade moves that colour, the new one both planes.
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <glib.h>
+
+#include "tile.h"
+#include "testmaps.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+#define BENCH_TILES (1 << 20)
+#define BENCH_PASSES 50
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+	int r, g, b, a;
+} BenchHue;
+
+///////////////////////////////////////////////////////////////////////////////
+/// The tile record RLTile replaced
+///////////////////////////////////////////////////////////////////////////////
+typedef struct {
+	int glyph;
+	BenchHue hue;
+	RLTileType type;
+} BenchOldTile;
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+static void Bench_OldFill(BenchOldTile *tiles, size_t count, BenchOldTile tile)
+{
+	for (size_t i = 0; i < count; ++i) {
+		tiles[i] = tile;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static int Bench_OldMix(int c, int t, int w)
+{
+	return (c * (255 - w) + t * w + 127) / 255;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Bench_OldFade(BenchOldTile *tiles, size_t count, BenchHue target,
+	int amount)
+{
+	for (size_t i = 0; i < count; ++i) {
+		BenchHue *hue = &tiles[i].hue;
+
+		hue->r = Bench_OldMix(hue->r, target.r, amount);
+		hue->g = Bench_OldMix(hue->g, target.g, amount);
+		hue->b = Bench_OldMix(hue->b, target.b, amount);
+		hue->a = Bench_OldMix(hue->a, target.a, amount);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Bench_Print(const char *name, double old, double now)
+{
+	printf("  %-13s %10.0f %10.0f %7.2fx\n", name,
+		BENCH_TILES * BENCH_PASSES / old / 1e6,
+		BENCH_TILES * BENCH_PASSES / now / 1e6, old / now);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Main
+///////////////////////////////////////////////////////////////////////////////
+
+int main(void)
+{
+	BenchOldTile *old_tiles = g_new(BenchOldTile, BENCH_TILES);
+	RLTile *tiles = g_new(RLTile, BENCH_TILES);
+	const BenchOldTile old_tile = {'#', {90, 90, 90, 255}, RLTILE_CENTER};
+	const RLTile tile = RLTile_Make('#', RLTILE_CENTER,
+		RLCOLOR(90, 90, 90, 255), RLCOLOR(20, 20, 25, 255));
+	const BenchHue old_target = {0, 0, 0, 255};
+	double start, old_fill, fill, old_fade, fade;
+	long sum = 0;
+
+	// Touch every page before timing
+	Bench_OldFill(old_tiles, BENCH_TILES, old_tile);
+	RLTile_Fill(tiles, BENCH_TILES, tile);
+
+	start = TestMaps_Seconds();
+	for (int i = 0; i < BENCH_PASSES; ++i) {
+		Bench_OldFill(old_tiles, BENCH_TILES, old_tile);
+		sum += old_tiles[i].glyph;
+	}
+	old_fill = TestMaps_Seconds() - start;
+
+	start = TestMaps_Seconds();
+	for (int i = 0; i < BENCH_PASSES; ++i) {
+		RLTile_Fill(tiles, BENCH_TILES, tile);
+		sum += tiles[i].glyph;
+	}
+	fill = TestMaps_Seconds() - start;
+
+	start = TestMaps_Seconds();
+	for (int i = 0; i < BENCH_PASSES; ++i) {
+		Bench_OldFade(old_tiles, BENCH_TILES, old_target, 16);
+		sum += old_tiles[i].hue.r;
+	}
+	old_fade = TestMaps_Seconds() - start;
+
+	start = TestMaps_Seconds();
+	for (int i = 0; i < BENCH_PASSES; ++i) {
+		RLTile_Fade(tiles, BENCH_TILES, RLTILE_FG | RLTILE_BG,
+			RLCOLOR(0, 0, 0, 255), 16);
+		sum += RLCOLOR_R(tiles[i].fg);
+	}
+	fade = TestMaps_Seconds() - start;
+
+	printf("bench_tile, %d tiles, checksum %ld\n", BENCH_TILES, sum);
+	printf("  %-13s %10s %10s %8s\n", "", "old", "RLTile", "speedup");
+	printf("  %-13s %10zu %10zu\n", "bytes", sizeof(BenchOldTile),
+		sizeof(RLTile));
+	Bench_Print("fill Mtiles/s", old_fill, fill);
+	Bench_Print("fade Mtiles/s", old_fade, fade);
+
+	g_free(tiles);
+	g_free(old_tiles);
+
+	return 0;
+}
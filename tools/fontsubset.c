@@ -0,0 +1,367 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	fontsubset.c
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Offline tool repacking the glyphs of a BMFont atlas named in a
+///			codepoint list into a smaller power of two atlas
+///
+/// Usage: fontsubset <font.fnt> <atlas.png> <codepoints.txt> <output>
+///
+/// Writes <output>.fnt and <output>.png. The codepoint list takes one
+/// U+XXXX or U+XXXX-U+YYYY range per line, '#' starts a comment.
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <glib.h>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#include "log.h"
+#include "common.h"
+#include "bmfont.h"
+#include "pngwrite.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+#define SUBSET_MAX_CODEPOINT 0x10FFFF
+
+// Empty texels kept around each glyph so filtering never samples a neighbour
+#define SUBSET_PADDING 1
+
+#define SUBSET_MAX_SIZE 16384
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+	BMFontInfo source;
+	int x;
+	int y;
+} SubsetGlyph;
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+static bool Subset_ParseCodepoint(const char *text, long *codepoint)
+{
+	char *end = NULL;
+
+	if (g_ascii_strncasecmp(text, "U+", 2)) {
+		return false;
+	}
+
+	*codepoint = strtol(text + 2, &end, 16);
+	return end != text + 2 && *codepoint >= 0 &&
+		*codepoint <= SUBSET_MAX_CODEPOINT;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static bool Subset_ReadCodepoints(const char *filename, bool *wanted)
+{
+	g_autofree char *file = NULL;
+	char **lines = NULL;
+	bool ok = true;
+
+	if (!g_file_get_contents(filename, &file, NULL, NULL)) {
+		logfmt_warn("File reading failed: %s", filename);
+		return false;
+	}
+
+	lines = g_strsplit(file, "\n", -1);
+	for (int i = 0; lines[i] && ok; ++i) {
+		char *line = lines[i], *comment = strchr(line, '#'), *dash = NULL;
+		long first = 0, last = 0;
+
+		if (comment) {
+			*comment = '\0';
+		}
+		if (!*g_strstrip(line)) {
+			continue;
+		}
+
+		if ((dash = strchr(line, '-'))) {
+			*dash = '\0';
+			ok = Subset_ParseCodepoint(g_strstrip(line), &first) &&
+				Subset_ParseCodepoint(g_strstrip(dash + 1), &last) &&
+				first <= last;
+		}
+		else {
+			ok = Subset_ParseCodepoint(line, &first);
+			last = first;
+		}
+
+		if (!ok) {
+			logfmt_warn("%s:%d: expected U+XXXX or U+XXXX-U+YYYY", filename,
+				i + 1);
+		}
+		for (long c = first; ok && c <= last; ++c) {
+			wanted[c] = true;
+		}
+	}
+	g_strfreev(lines);
+
+	return ok;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static int Subset_CompareSize(const void *a, const void *b)
+{
+	const BMFontInfo *x = &((const SubsetGlyph *)a)->source;
+	const BMFontInfo *y = &((const SubsetGlyph *)b)->source;
+
+	// Tallest first so each shelf wastes little height, then widest
+	if (x->size.height != y->size.height) {
+		return y->size.height - x->size.height;
+	}
+	else if (x->size.width != y->size.width) {
+		return y->size.width - x->size.width;
+	}
+	else {
+		return x->glyph - y->glyph;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static int Subset_CompareGlyph(const void *a, const void *b)
+{
+	return ((const SubsetGlyph *)a)->source.glyph -
+		((const SubsetGlyph *)b)->source.glyph;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static bool Subset_Pack(SubsetGlyph *glyphs, int num_glyphs, int width,
+	int height)
+{
+	int x = 0, y = 0, shelf = 0;
+
+	// Shelves filled left to right, glyphs must arrive tallest first
+	for (int i = 0; i < num_glyphs; ++i) {
+		const int w = glyphs[i].source.size.width + SUBSET_PADDING;
+		const int h = glyphs[i].source.size.height + SUBSET_PADDING;
+
+		if (w > width) {
+			return false;
+		}
+		if (x + w > width) {
+			x = 0;
+			y += shelf;
+			shelf = 0;
+		}
+		if (y + h > height) {
+			return false;
+		}
+
+		glyphs[i].x = x;
+		glyphs[i].y = y;
+		x += w;
+		shelf = MAX(shelf, h);
+	}
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static bool Subset_WriteFont(const char *filename, const char *page,
+	SubsetGlyph *glyphs, int num_glyphs, int width, int height)
+{
+	FILE *file = NULL;
+	int line_height = 0;
+	bool ok;
+
+	if (!(file = fopen(filename, "w"))) {
+		logfmt_warn("Could not open %s for writing", filename);
+		return false;
+	}
+
+	for (int i = 0; i < num_glyphs; ++i) {
+		line_height = MAX(line_height, glyphs[i].source.size.height);
+	}
+
+	// BMFont_Create treats every line from the first starting with "char" as
+	// a glyph, so the optional "chars count=" line is left out
+	fprintf(file, "info face=\"subset\" size=%d\n", line_height);
+	fprintf(file, "common lineHeight=%d scaleW=%d scaleH=%d pages=1\n",
+		line_height, width, height);
+	fprintf(file, "page id=0 file=\"%s\"\n", page);
+	for (int i = 0; i < num_glyphs; ++i) {
+		const BMFontInfo *info = &glyphs[i].source;
+		fprintf(
+			file,
+			"char id=%d x=%d y=%d width=%d height=%d xoffset=%d yoffset=%d "
+			"xadvance=%d page=0 chnl=15\n",
+			info->glyph,
+			glyphs[i].x,
+			glyphs[i].y,
+			info->size.width,
+			info->size.height,
+			info->offset.x,
+			info->offset.y,
+			info->size.width
+			);
+	}
+
+	ok = !ferror(file);
+	if (fclose(file) || !ok) {
+		logfmt_warn("Could not write %s", filename);
+		return false;
+	}
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Main
+///////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char *argv[])
+{
+	BMFont *font = NULL;
+	bool *wanted = NULL;
+	SubsetGlyph *glyphs = NULL;
+	unsigned char *source = NULL, *pixels = NULL;
+	int num_glyphs = 0, missing = 0, area = 0;
+	int source_width, source_height, channels, width = 1, height = 1;
+	g_autofree char *fnt_path = NULL, *png_path = NULL, *page = NULL;
+	int status = 1;
+
+	if (argc != 5) {
+		fprintf(stderr, "Usage: %s <font.fnt> <atlas.png> <codepoints.txt> "
+			"<output>\n", argv[0]);
+		return 1;
+	}
+
+	fnt_path = g_strdup_printf("%s.fnt", argv[4]);
+	png_path = g_strdup_printf("%s.png", argv[4]);
+	page = g_path_get_basename(png_path);
+
+	if (!(font = BMFont_Create(argv[1]))) {
+		log_warn("Font metrics loading failed");
+		return 1;
+	}
+	if (!(source = stbi_load(argv[2], &source_width, &source_height,
+		&channels, 0))) {
+		logfmt_warn("Atlas loading failed: %s", stbi_failure_reason());
+		goto error_source;
+	}
+
+	wanted = g_new0(bool, SUBSET_MAX_CODEPOINT + 1);
+	if (!Subset_ReadCodepoints(argv[3], wanted)) {
+		goto error_codepoints;
+	}
+
+	// Look up every wanted glyph, checking it lies inside the source atlas
+	for (int c = 0; c <= SUBSET_MAX_CODEPOINT; ++c) {
+		num_glyphs += wanted[c];
+	}
+	glyphs = g_new0(SubsetGlyph, (size_t)MAX(num_glyphs, 1));
+	num_glyphs = 0;
+	for (int c = 0; c <= SUBSET_MAX_CODEPOINT; ++c) {
+		const BMFontInfo *info = NULL;
+
+		if (!wanted[c]) {
+			continue;
+		}
+		else if (!(info = BMFont_GetInfoPtr(font, c))) {
+			++missing;
+			continue;
+		}
+		else if (info->position.x < 0 || info->position.y < 0 ||
+			info->size.width < 0 || info->size.height < 0 ||
+			info->position.x + info->size.width > source_width ||
+			info->position.y + info->size.height > source_height) {
+			logfmt_warn("Glyph U+%04X lies outside the atlas",
+				(unsigned)c);
+			goto error_glyphs;
+		}
+
+		glyphs[num_glyphs].source = *info;
+		area += (info->size.width + SUBSET_PADDING) *
+			(info->size.height + SUBSET_PADDING);
+		++num_glyphs;
+	}
+	if (missing) {
+		logfmt_warn("%d codepoints have no glyph in %s", missing, argv[1]);
+	}
+	if (!num_glyphs) {
+		log_warn("No glyphs to pack");
+		goto error_glyphs;
+	}
+
+	// Smallest power of two size that fits, square or twice as wide as tall
+	qsort(glyphs, (size_t)num_glyphs, sizeof(SubsetGlyph), Subset_CompareSize);
+	while (width * height < area ||
+		!Subset_Pack(glyphs, num_glyphs, width, height)) {
+		if (width == height) {
+			width *= 2;
+		}
+		else {
+			height *= 2;
+		}
+		if (width > SUBSET_MAX_SIZE) {
+			log_warn("Glyphs do not fit in the largest atlas");
+			goto error_glyphs;
+		}
+	}
+
+	pixels = g_new0(unsigned char, (size_t)width * (size_t)height *
+		(size_t)channels);
+	for (int i = 0; i < num_glyphs; ++i) {
+		const BMFontInfo *info = &glyphs[i].source;
+		for (int row = 0; row < info->size.height; ++row) {
+			memcpy(
+				pixels + ((size_t)(glyphs[i].y + row) * (size_t)width +
+					(size_t)glyphs[i].x) * (size_t)channels,
+				source + ((size_t)(info->position.y + row) *
+					(size_t)source_width + (size_t)info->position.x) *
+					(size_t)channels,
+				(size_t)info->size.width * (size_t)channels
+				);
+		}
+	}
+
+	qsort(glyphs, (size_t)num_glyphs, sizeof(SubsetGlyph),
+		Subset_CompareGlyph);
+	if (PNG_Write(png_path, pixels, width, height, channels,
+		width * channels) && Subset_WriteFont(fnt_path, page, glyphs,
+		num_glyphs, width, height)) {
+		logfmt_info(
+			"%d glyphs: %dx%d to %dx%d, %ld to %ld bytes decoded",
+			num_glyphs,
+			source_width,
+			source_height,
+			width,
+			height,
+			(long)source_width * source_height * channels,
+			(long)width * height * channels
+			);
+		status = 0;
+	}
+
+	g_free(pixels);
+
+error_glyphs:
+
+	g_free(glyphs);
+
+error_codepoints:
+
+	g_free(wanted);
+	stbi_image_free(source);
+
+error_source:
+
+	BMFont_Destroy(font);
+	return status;
+}
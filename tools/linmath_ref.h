@@ -0,0 +1,154 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	linmath_ref.h
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Scalar references for the linmath kernels with SIMD versions,
+///			copied from the LINMATH_NO_SIMD paths
+///
+/// Kept apart from linmath.h so one program can hold both. Building with
+/// -ffp-contract=off keeps the compiler from fusing the references into
+/// multiply-adds the kernels do not use.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef LINMATH_REF_H
+#define LINMATH_REF_H
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include "linmath.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+static inline void Ref_Mul(mat4x4 M, mat4x4 a, mat4x4 b)
+{
+	mat4x4 temp;
+
+	for (int c = 0; c < 4; ++c) {
+		for (int r = 0; r < 4; ++r) {
+			temp[c][r] = 0.f;
+			for (int k = 0; k < 4; ++k) {
+				temp[c][r] += a[k][r] * b[c][k];
+			}
+		}
+	}
+	mat4x4_dup(M, temp);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static inline void Ref_MulVec4(vec4 r, mat4x4 M, vec4 v)
+{
+	for (int j = 0; j < 4; ++j) {
+		r[j] = 0.f;
+		for (int i = 0; i < 4; ++i) {
+			r[j] += M[i][j] * v[i];
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static inline void Ref_Transpose(mat4x4 M, mat4x4 N)
+{
+	for (int j = 0; j < 4; ++j) {
+		for (int i = 0; i < 4; ++i) {
+			M[i][j] = N[j][i];
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static inline void Ref_Invert(mat4x4 T, mat4x4 M)
+{
+	float s[6], c[6], idet;
+
+	s[0] = M[0][0]*M[1][1] - M[1][0]*M[0][1];
+	s[1] = M[0][0]*M[1][2] - M[1][0]*M[0][2];
+	s[2] = M[0][0]*M[1][3] - M[1][0]*M[0][3];
+	s[3] = M[0][1]*M[1][2] - M[1][1]*M[0][2];
+	s[4] = M[0][1]*M[1][3] - M[1][1]*M[0][3];
+	s[5] = M[0][2]*M[1][3] - M[1][2]*M[0][3];
+
+	c[0] = M[2][0]*M[3][1] - M[3][0]*M[2][1];
+	c[1] = M[2][0]*M[3][2] - M[3][0]*M[2][2];
+	c[2] = M[2][0]*M[3][3] - M[3][0]*M[2][3];
+	c[3] = M[2][1]*M[3][2] - M[3][1]*M[2][2];
+	c[4] = M[2][1]*M[3][3] - M[3][1]*M[2][3];
+	c[5] = M[2][2]*M[3][3] - M[3][2]*M[2][3];
+
+	idet = 1.0f / (s[0]*c[5] - s[1]*c[4] + s[2]*c[3] + s[3]*c[2] -
+		s[4]*c[1] + s[5]*c[0]);
+
+	T[0][0] = ( M[1][1] * c[5] - M[1][2] * c[4] + M[1][3] * c[3]) * idet;
+	T[0][1] = (-M[0][1] * c[5] + M[0][2] * c[4] - M[0][3] * c[3]) * idet;
+	T[0][2] = ( M[3][1] * s[5] - M[3][2] * s[4] + M[3][3] * s[3]) * idet;
+	T[0][3] = (-M[2][1] * s[5] + M[2][2] * s[4] - M[2][3] * s[3]) * idet;
+
+	T[1][0] = (-M[1][0] * c[5] + M[1][2] * c[2] - M[1][3] * c[1]) * idet;
+	T[1][1] = ( M[0][0] * c[5] - M[0][2] * c[2] + M[0][3] * c[1]) * idet;
+	T[1][2] = (-M[3][0] * s[5] + M[3][2] * s[2] - M[3][3] * s[1]) * idet;
+	T[1][3] = ( M[2][0] * s[5] - M[2][2] * s[2] + M[2][3] * s[1]) * idet;
+
+	T[2][0] = ( M[1][0] * c[4] - M[1][1] * c[2] + M[1][3] * c[0]) * idet;
+	T[2][1] = (-M[0][0] * c[4] + M[0][1] * c[2] - M[0][3] * c[0]) * idet;
+	T[2][2] = ( M[3][0] * s[4] - M[3][1] * s[2] + M[3][3] * s[0]) * idet;
+	T[2][3] = (-M[2][0] * s[4] + M[2][1] * s[2] - M[2][3] * s[0]) * idet;
+
+	T[3][0] = (-M[1][0] * c[3] + M[1][1] * c[1] - M[1][2] * c[0]) * idet;
+	T[3][1] = ( M[0][0] * c[3] - M[0][1] * c[1] + M[0][2] * c[0]) * idet;
+	T[3][2] = (-M[3][0] * s[3] + M[3][1] * s[1] - M[3][2] * s[0]) * idet;
+	T[3][3] = ( M[2][0] * s[3] - M[2][1] * s[1] + M[2][2] * s[0]) * idet;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static inline void Ref_MulVec3Batch(float *rx, float *ry, float *rz,
+	mat4x4 M, const float *x, const float *y, const float *z, int n)
+{
+	for (int i = 0; i < n; ++i) {
+		const float px = x[i], py = y[i], pz = z[i];
+
+		rx[i] = M[0][0]*px + M[1][0]*py + M[2][0]*pz + M[3][0];
+		ry[i] = M[0][1]*px + M[1][1]*py + M[2][1]*pz + M[3][1];
+		rz[i] = M[0][2]*px + M[1][2]*py + M[2][2]*pz + M[3][2];
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static inline void Ref_MulVec2Batch(float *rx, float *ry, mat4x4 M,
+	const float *x, const float *y, int n)
+{
+	for (int i = 0; i < n; ++i) {
+		const float px = x[i], py = y[i];
+
+		rx[i] = M[0][0]*px + M[1][0]*py + M[3][0];
+		ry[i] = M[0][1]*px + M[1][1]*py + M[3][1];
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static inline void Ref_ScaleTranslateBatch(float *rx, float *ry,
+	const float *x, const float *y, int n, float sx, float sy, float tx,
+	float ty)
+{
+	for (int i = 0; i < n; ++i) {
+		rx[i] = x[i]*sx + tx;
+		ry[i] = y[i]*sy + ty;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Name of the kernels linmath.h was built with
+///////////////////////////////////////////////////////////////////////////////
+#if defined(LINMATH_AVX)
+#define REF_KERNELS "AVX"
+#elif defined(LINMATH_SSE)
+#define REF_KERNELS "SSE"
+#elif defined(LINMATH_NEON)
+#define REF_KERNELS "NEON"
+#else
+#define REF_KERNELS "scalar"
+#endif
+
+#endif
@@ -0,0 +1,151 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	test_ai.c
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Checks RLAI turns replay the same at any number of threads
+///
+/// The same game is played with 1, 2, 4 and 8 threads, hashing every
+/// monster's position and state after each turn. The hashes must match,
+/// and no monster may stand in a wall, on the player or on another.
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <glib.h>
+
+#include "ai.h"
+#include "testmaps.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+#define AI_SIZE 96
+#define AI_ACTORS 400
+#define AI_TURNS 200
+#define AI_SIGHT 12
+
+// FNV-1a
+#define AI_HASH_BASIS 14695981039346656037u
+#define AI_HASH_PRIME 1099511628211u
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static variables
+///////////////////////////////////////////////////////////////////////////////
+
+static int failures = 0;
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+static void Test_Expect(bool ok, const char *what, int threads, int turn)
+{
+	if (!ok && failures++ < 10) {
+		printf("  %s with %d threads on turn %d\n", what, threads, turn);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static bool Test_Taken(RLAI *ai, int x, int y)
+{
+	for (int i = 0; i < RLAI_GetNumActors(ai); ++i) {
+		const RLAIActor *actor = RLAI_GetActor(ai, i);
+
+		if (actor->x == x && actor->y == y) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static uint64_t Test_Play(const RLMapGrid *map, int threads)
+{
+	RLJobSystem *jobs = RLJobSystem_Create(threads - 1);
+	RLAI *ai = RLAI_Create(map, jobs);
+	RLFov *fov = RLFov_Create(map, AI_SIGHT);
+	bool *taken = g_new(bool, AI_SIZE * AI_SIZE);
+	uint32_t seed = 7;
+	uint64_t hash = AI_HASH_BASIS;
+	int px, py;
+
+	while (RLAI_GetNumActors(ai) < AI_ACTORS) {
+		RLAI_Spawn(ai, TestMaps_Range(&seed, AI_SIZE),
+			TestMaps_Range(&seed, AI_SIZE), 10);
+	}
+	do {
+		TestMaps_Open(map, &seed, &px, &py);
+	} while (Test_Taken(ai, px, py));
+
+	for (int turn = 0; turn < AI_TURNS; ++turn) {
+		const int nx = px + TestMaps_Range(&seed, 3) - 1;
+		const int ny = py + TestMaps_Range(&seed, 3) - 1;
+
+		RLFov_Update(fov, px, py);
+		RLAI_Turn(ai, fov, px, py);
+
+		// Wounding every third monster a third of the way in makes some flee
+		if (turn == AI_TURNS / 3) {
+			for (int i = 0; i < AI_ACTORS; i += 3) {
+				RLAI_GetActor(ai, i)->hp = 2;
+			}
+		}
+
+		for (int i = 0; i < AI_SIZE * AI_SIZE; ++i) {
+			taken[i] = false;
+		}
+		for (int i = 0; i < AI_ACTORS; ++i) {
+			const RLAIActor *actor = RLAI_GetActor(ai, i);
+			bool *cell = &taken[actor->y * AI_SIZE + actor->x];
+
+			Test_Expect(RLMapGrid_GetBit(map, RLMAP_WALKABLE, actor->x,
+				actor->y) && !*cell && (actor->x != px || actor->y != py),
+				"A monster is in a wall, on another or on the player",
+				threads, turn);
+			*cell = true;
+			hash = (hash ^ (uint64_t)(actor->x * 7919 + actor->y * 31 +
+				(int)actor->state)) * AI_HASH_PRIME;
+		}
+
+		// The player wanders
+		if (RLMapGrid_GetBit(map, RLMAP_WALKABLE, nx, ny) &&
+			!taken[ny * AI_SIZE + nx]) {
+			px = nx;
+			py = ny;
+		}
+	}
+
+	g_free(taken);
+	RLFov_Destroy(fov);
+	RLAI_Destroy(ai);
+	RLJobSystem_Destroy(jobs);
+
+	return hash;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Main
+///////////////////////////////////////////////////////////////////////////////
+
+int main(void)
+{
+	uint32_t seed = 3;
+	RLMapGrid *map = RLMapGrid_Create(AI_SIZE, AI_SIZE);
+	uint64_t first;
+
+	TestMaps_Cave(map, 42, &seed);
+	first = Test_Play(map, 1);
+	for (int threads = 2; threads <= 8; threads *= 2) {
+		Test_Expect(Test_Play(map, threads) == first,
+			"Replay differs from the one on a thread", threads, AI_TURNS);
+	}
+	RLMapGrid_Destroy(map);
+
+	printf("test_ai: %s\n", failures ? "FAILED" : "ok");
+	return failures != 0;
+}
@@ -0,0 +1,237 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	test_ecs.c
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Checks RLWorld against a plain model of its entities
+///
+/// ECS_OPERATIONS random spawns, despawns, adds and removes are applied to
+/// a world and to an array holding each entity's components. Every so often
+/// each component is read back and the queries are run, and both must
+/// agree with the model.
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ecs.h"
+#include "testmaps.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+#define ECS_OPERATIONS 400000
+#define ECS_ENTITIES 3000
+#define ECS_COMPONENTS 6
+#define ECS_MAX_SIZE 16
+
+// Operations between checks of the whole world
+#define ECS_CHECK_EVERY 997
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// What the world should hold for an entity
+///////////////////////////////////////////////////////////////////////////////
+typedef struct {
+	RLEntity entity;
+	bool alive;
+	uint64_t mask;
+	uint8_t values[ECS_COMPONENTS][ECS_MAX_SIZE];
+} TestEntity;
+
+///////////////////////////////////////////////////////////////////////////////
+/// Entities a query visited and the sum of the first byte of each column
+///////////////////////////////////////////////////////////////////////////////
+typedef struct {
+	const int *components;
+	int num_components;
+	int seen;
+	unsigned long sum;
+} TestVisit;
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static variables
+///////////////////////////////////////////////////////////////////////////////
+
+// Odd sizes catch columns laid out with the wrong stride
+static const size_t sizes[ECS_COMPONENTS] = {4, 8, 1, 12, 16, 3};
+
+static TestEntity model[ECS_ENTITIES];
+static int components[ECS_COMPONENTS];
+static int failures = 0;
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+static void Test_Expect(bool ok, const char *what, int operation)
+{
+	if (!ok && failures++ < 10) {
+		printf("  %s after operation %d\n", what, operation);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Test_Visit(void *data, int count, const RLEntity *entities,
+	void **columns)
+{
+	TestVisit *visit = data;
+
+	(void)entities;
+	visit->seen += count;
+	for (int k = 0; k < visit->num_components; ++k) {
+		const uint8_t *column = columns[k];
+
+		for (int i = 0; i < count; ++i) {
+			visit->sum += column[(size_t)i * sizes[visit->components[k]]];
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Test_Query(RLWorld *world, uint64_t with, uint64_t without,
+	int operation)
+{
+	int order[ECS_COMPONENTS], num_components = 0;
+	TestVisit visit = {order, 0, 0, 0};
+	int seen = 0;
+	unsigned long sum = 0;
+
+	// Columns come in the order of the component ids
+	for (int k = 0; k < ECS_COMPONENTS; ++k) {
+		if (with & RLECS_BIT(components[k])) {
+			order[num_components++] = k;
+		}
+	}
+	visit.num_components = num_components;
+	RLQuery_Each(RLWorld_CreateQuery(world, with, without), Test_Visit,
+		&visit);
+
+	for (int i = 0; i < ECS_ENTITIES; ++i) {
+		uint64_t mask = 0;
+
+		if (!model[i].alive) {
+			continue;
+		}
+		for (int k = 0; k < ECS_COMPONENTS; ++k) {
+			mask |= model[i].mask & RLECS_BIT(k) ?
+				RLECS_BIT(components[k]) : 0;
+		}
+		if ((mask & with) == with && !(mask & without)) {
+			++seen;
+			for (int k = 0; k < num_components; ++k) {
+				sum += model[i].values[order[k]][0];
+			}
+		}
+	}
+	Test_Expect(visit.seen == seen && visit.sum == sum,
+		"A query visits other entities than the model", operation);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Test_Check(RLWorld *world, int operation)
+{
+	for (int i = 0; i < ECS_ENTITIES; ++i) {
+		if (!model[i].alive) {
+			continue;
+		}
+		for (int k = 0; k < ECS_COMPONENTS; ++k) {
+			const uint8_t *value = RLWorld_Get(world, model[i].entity,
+				components[k]);
+			const bool has = model[i].mask & RLECS_BIT(k);
+
+			Test_Expect(!value == !has &&
+				(!value || !memcmp(value, model[i].values[k], sizes[k])),
+				"A component differs from the model", operation);
+		}
+	}
+
+	Test_Query(world, RLECS_BIT(components[0]) | RLECS_BIT(components[3]),
+		RLECS_BIT(components[2]), operation);
+	Test_Query(world, RLECS_BIT(components[1]), 0, operation);
+	Test_Query(world, RLECS_BIT(components[5]) | RLECS_BIT(components[4]) |
+		RLECS_BIT(components[2]), RLECS_BIT(components[0]), operation);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Main
+///////////////////////////////////////////////////////////////////////////////
+
+int main(void)
+{
+	RLWorld *world = RLWorld_Create();
+	RLQuery *query = NULL;
+	uint32_t seed = 1;
+
+	for (int k = 0; k < ECS_COMPONENTS; ++k) {
+		components[k] = RLWorld_RegisterComponent(world, sizes[k]);
+	}
+	query = RLWorld_CreateQuery(world, RLECS_BIT(components[0]) |
+		RLECS_BIT(components[3]), RLECS_BIT(components[2]));
+
+	for (int operation = 0; operation < ECS_OPERATIONS; ++operation) {
+		TestEntity *entry = &model[TestMaps_Range(&seed, ECS_ENTITIES)];
+		const int choice = TestMaps_Range(&seed, 10);
+		const int k = TestMaps_Range(&seed, ECS_COMPONENTS);
+
+		if (!entry->alive) {
+			if (choice < 5) {
+				entry->entity = RLWorld_Spawn(world);
+				entry->alive = true;
+				entry->mask = 0;
+			}
+		}
+		else if (choice == 0) {
+			RLWorld_Despawn(world, entry->entity);
+			entry->alive = false;
+			Test_Expect(!RLWorld_IsAlive(world, entry->entity) &&
+				!RLWorld_Get(world, entry->entity, components[0]),
+				"A despawned entity lives on", operation);
+		}
+		else if (choice < 6) {
+			uint8_t *value = RLWorld_Add(world, entry->entity,
+				components[k]);
+			const uint8_t byte = (uint8_t)TestMaps_Random(&seed);
+
+			if (!value) {
+				Test_Expect(false, "Adding a component failed", operation);
+				continue;
+			}
+
+			// A new component starts zeroed, an old one keeps its value
+			if (!(entry->mask & RLECS_BIT(k))) {
+				memset(entry->values[k], 0, ECS_MAX_SIZE);
+			}
+			Test_Expect(!memcmp(value, entry->values[k], sizes[k]),
+				"An added component has the wrong value", operation);
+			memset(value, byte, sizes[k]);
+			memset(entry->values[k], byte, sizes[k]);
+			entry->mask |= RLECS_BIT(k);
+		}
+		else {
+			RLWorld_Remove(world, entry->entity, components[k]);
+			entry->mask &= ~RLECS_BIT(k);
+		}
+
+		if (operation % ECS_CHECK_EVERY == 0) {
+			Test_Check(world, operation);
+		}
+	}
+	Test_Check(world, ECS_OPERATIONS);
+
+	// Queries are cached by their masks
+	Test_Expect(RLWorld_CreateQuery(world, RLECS_BIT(components[0]) |
+		RLECS_BIT(components[3]), RLECS_BIT(components[2])) == query,
+		"A query was created twice", ECS_OPERATIONS);
+	RLWorld_Destroy(world);
+
+	printf("test_ecs: %s\n", failures ? "FAILED" : "ok");
+	return failures != 0;
+}
@@ -0,0 +1,144 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	test_fov.c
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Checks RLFov is symmetric and that incremental updates match a
+///			fresh computation
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <glib.h>
+
+#include "fov.h"
+#include "testmaps.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+#define FOV_SIZE 40
+#define FOV_MAPS 6
+#define FOV_EDITS 2000
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static variables
+///////////////////////////////////////////////////////////////////////////////
+
+static uint32_t seed = 1;
+static int failures = 0;
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+static void Test_Expect(bool ok, const char *what, int map)
+{
+	if (!ok && failures++ < 10) {
+		printf("  %s on map %d\n", what, map);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Test_Symmetry(RLMapGrid *map, int radius, int index)
+{
+	const int cells = FOV_SIZE * FOV_SIZE;
+	bool *seen = g_new0(bool, (gsize)cells * (gsize)cells);
+	RLFov *fov = RLFov_Create(map, radius);
+	bool symmetric = true;
+
+	for (int a = 0; a < cells; ++a) {
+		if (!RLMapGrid_GetBit(map, RLMAP_TRANSPARENT, a % FOV_SIZE,
+			a / FOV_SIZE)) {
+			continue;
+		}
+		RLFov_Update(fov, a % FOV_SIZE, a / FOV_SIZE);
+		for (int b = 0; b < cells; ++b) {
+			seen[a * cells + b] = RLFov_IsVisible(fov, b % FOV_SIZE,
+				b / FOV_SIZE);
+		}
+	}
+
+	// Opaque cells are seen by their face and see nothing, so only pairs of
+	// transparent cells must agree
+	for (int a = 0; a < cells; ++a) {
+		for (int b = a + 1; b < cells; ++b) {
+			if (RLMapGrid_GetBit(map, RLMAP_TRANSPARENT, a % FOV_SIZE,
+				a / FOV_SIZE) && RLMapGrid_GetBit(map, RLMAP_TRANSPARENT,
+				b % FOV_SIZE, b / FOV_SIZE)) {
+				symmetric &= seen[a * cells + b] == seen[b * cells + a];
+			}
+		}
+	}
+	Test_Expect(symmetric, radius ? "Sight within a radius is not symmetric" :
+		"Sight is not symmetric", index);
+
+	RLFov_Destroy(fov);
+	g_free(seen);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Test_Incremental(RLMapGrid *map, int radius, int index)
+{
+	RLFov *fov = RLFov_Create(map, radius);
+	int x, y;
+	bool same = true;
+
+	TestMaps_Open(map, &seed, &x, &y);
+	RLFov_Update(fov, x, y);
+	for (int edit = 0; edit < FOV_EDITS && same; ++edit) {
+		const int ex = TestMaps_Range(&seed, FOV_SIZE);
+		const int ey = TestMaps_Range(&seed, FOV_SIZE);
+		RLFov *fresh = NULL;
+
+		RLMapGrid_SetBit(map, RLMAP_TRANSPARENT, ex, ey,
+			!RLMapGrid_GetBit(map, RLMAP_TRANSPARENT, ex, ey));
+		RLFov_Invalidate(fov, ex, ey);
+		if (TestMaps_Range(&seed, 8) == 0) {
+			TestMaps_Open(map, &seed, &x, &y);
+		}
+		RLFov_Update(fov, x, y);
+
+		fresh = RLFov_Create(map, radius);
+		RLFov_Update(fresh, x, y);
+		for (int cell = 0; cell < FOV_SIZE * FOV_SIZE; ++cell) {
+			same &= RLFov_IsVisible(fov, cell % FOV_SIZE, cell / FOV_SIZE) ==
+				RLFov_IsVisible(fresh, cell % FOV_SIZE, cell / FOV_SIZE);
+		}
+		RLFov_Destroy(fresh);
+	}
+	Test_Expect(same, "An incremental update differs from a fresh one",
+		index);
+
+	RLFov_Destroy(fov);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Main
+///////////////////////////////////////////////////////////////////////////////
+
+int main(void)
+{
+	for (int i = 0; i < FOV_MAPS; ++i) {
+		RLMapGrid *map = RLMapGrid_Create(FOV_SIZE, FOV_SIZE);
+
+		if (i % 2) {
+			TestMaps_Cave(map, 45, &seed);
+		}
+		else {
+			TestMaps_Noise(map, 20 + 5 * i, &seed);
+		}
+		Test_Symmetry(map, 0, i);
+		Test_Symmetry(map, 8, i);
+		Test_Incremental(map, 0, i);
+		Test_Incremental(map, 8, i);
+
+		RLMapGrid_Destroy(map);
+	}
+
+	printf("test_fov: %s\n", failures ? "FAILED" : "ok");
+	return failures != 0;
+}
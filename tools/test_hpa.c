@@ -0,0 +1,232 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	test_hpa.c
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Checks RLPathHierarchy against a reference Dijkstra and a fresh
+///			build after edits
+///
+/// Edits are a mix of ones reported with RLPathHierarchy_Invalidate and
+/// ones that are not. Routes must exist exactly when the reference finds a
+/// path, cost no less than it, refine into legal steps of the planned cost
+/// ending at the goal, and cost the same as routes of a fresh hierarchy.
+/// A room dug one cell at a time must only rebuild the clusters around it.
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <glib.h>
+
+#include "hpa.h"
+#include "testmaps.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+#define HPA_MAPS 60
+#define HPA_QUERIES 20
+
+// Steps asked of each RLPathHierarchy_Refine
+#define HPA_CHUNK 7
+
+// Map and cluster size of the room digging check
+#define HPA_ROOM_MAP 96
+#define HPA_ROOM_CLUSTER 8
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static variables
+///////////////////////////////////////////////////////////////////////////////
+
+static uint32_t seed = 1;
+static int failures = 0;
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+static void Test_Expect(bool ok, const char *what, int map)
+{
+	if (!ok && failures++ < 10) {
+		printf("  %s on map %d\n", what, map);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static int Test_Walk(const RLMapGrid *map, int x, int y,
+	const RLPathPoint *path, int n)
+{
+	int cost = 0;
+
+	// Returns -1 on the first step an RLPathFinder may not take
+	for (int i = 0; i < n; ++i) {
+		const int dx = path[i].x - x, dy = path[i].y - y;
+
+		if (abs(dx) > 1 || abs(dy) > 1 || (!dx && !dy) ||
+			!RLMapGrid_GetBit(map, RLMAP_WALKABLE, path[i].x, path[i].y) ||
+			(dx && dy && (
+			!RLMapGrid_GetBit(map, RLMAP_WALKABLE, x + dx, y) ||
+			!RLMapGrid_GetBit(map, RLMAP_WALKABLE, x, y + dy)))) {
+			return -1;
+		}
+		cost += dx && dy ? RLPATH_COST_DIAGONAL : RLPATH_COST_STRAIGHT;
+		x = path[i].x;
+		y = path[i].y;
+	}
+
+	return cost;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Test_Edit(RLMapGrid *map, RLPathHierarchy *hierarchy)
+{
+	const int x = TestMaps_Range(&seed, map->size.width);
+	const int y = TestMaps_Range(&seed, map->size.height);
+
+	// Every other edit goes unreported, often just before a reported one
+	RLMapGrid_SetBit(map, RLMAP_WALKABLE, x, y, TestMaps_Range(&seed, 2));
+	if (TestMaps_Range(&seed, 2)) {
+		RLPathHierarchy_Invalidate(hierarchy, x, y, 1, 1);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Test_Query(RLMapGrid *map, RLPathHierarchy *hierarchy,
+	int cluster_size, int *costs, RLPathPoint *path, int index)
+{
+	const int w = map->size.width;
+	RLPathHierarchy *fresh = NULL;
+	int sx, sy, gx, gy, cost, expected, n = 0, written;
+
+	if (!TestMaps_Open(map, &seed, &sx, &sy)) {
+		return;
+	}
+	gx = TestMaps_Range(&seed, w);
+	gy = TestMaps_Range(&seed, map->size.height);
+	if (TestMaps_Range(&seed, 2)) {
+		TestMaps_Open(map, &seed, &gx, &gy);
+	}
+
+	TestMaps_Distances(map, sx, sy, costs);
+	expected = RLMapGrid_GetBit(map, RLMAP_WALKABLE, gx, gy) ?
+		costs[gy * w + gx] : -1;
+	cost = RLPathHierarchy_Find(hierarchy, sx, sy, gx, gy);
+	Test_Expect((cost < 0) == (expected < 0),
+		"Route found where the reference has no path, or the reverse",
+		index);
+	Test_Expect(cost >= expected, "Route is shorter than the reference",
+		index);
+
+	fresh = RLPathHierarchy_Create(map, cluster_size);
+	Test_Expect(RLPathHierarchy_Find(fresh, sx, sy, gx, gy) == cost,
+		"Route differs from the one of a fresh hierarchy", index);
+	RLPathHierarchy_Destroy(fresh);
+	if (cost < 0) {
+		return;
+	}
+
+	// Refining is asked a few steps at a time, as a walker would
+	while ((written = RLPathHierarchy_Refine(hierarchy, path + n,
+		HPA_CHUNK)) > 0) {
+		n += written;
+	}
+	Test_Expect(written == 0, "Refine gave up on an unchanged map", index);
+	Test_Expect(Test_Walk(map, sx, sy, path, n) == cost &&
+		(n ? path[n - 1].x == gx && path[n - 1].y == gy :
+		sx == gx && sy == gy), "Refined steps do not walk the route",
+		index);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Test_Room(void)
+{
+	const int clusters = HPA_ROOM_MAP / HPA_ROOM_CLUSTER;
+	RLMapGrid *map = RLMapGrid_Create(HPA_ROOM_MAP, HPA_ROOM_MAP);
+	RLPathHierarchy *hierarchy = NULL, *fresh = NULL;
+	const int x = 1 + TestMaps_Range(&seed, HPA_ROOM_MAP - 4);
+	const int y = 1 + TestMaps_Range(&seed, HPA_ROOM_MAP - 4);
+	int sx, sy, gx, gy, cost;
+
+	TestMaps_Rooms(map, &seed);
+	TestMaps_Open(map, &seed, &sx, &sy);
+	TestMaps_Open(map, &seed, &gx, &gy);
+	hierarchy = RLPathHierarchy_Create(map, HPA_ROOM_CLUSTER);
+
+	// Nine changes reported by one call touch at most four clusters and
+	// the eight around them
+	for (int dy = 0; dy < 3; ++dy) {
+		for (int dx = 0; dx < 3; ++dx) {
+			RLMapGrid_SetBit(map, RLMAP_WALKABLE, x + dx, y + dy, true);
+		}
+	}
+	RLPathHierarchy_Invalidate(hierarchy, x, y, 3, 3);
+	cost = RLPathHierarchy_Find(hierarchy, sx, sy, gx, gy);
+	Test_Expect(RLPathHierarchy_GetRebuilt(hierarchy) > 0 &&
+		RLPathHierarchy_GetRebuilt(hierarchy) <= 12,
+		"A room dug a cell at a time rebuilt far clusters", HPA_MAPS);
+	fresh = RLPathHierarchy_Create(map, HPA_ROOM_CLUSTER);
+	Test_Expect(RLPathHierarchy_Find(fresh, sx, sy, gx, gy) == cost,
+		"Route after digging differs from a fresh hierarchy", HPA_MAPS);
+	RLPathHierarchy_Destroy(fresh);
+
+	// Past the changes the map keeps, every cluster is rebuilt
+	for (int i = 0; i <= RLMAP_CHANGES; ++i) {
+		RLMapGrid_SetBit(map, RLMAP_WALKABLE, x, y, true);
+	}
+	RLPathHierarchy_Find(hierarchy, sx, sy, gx, gy);
+	Test_Expect(RLPathHierarchy_GetRebuilt(hierarchy) == clusters * clusters,
+		"Changes the map forgot did not rebuild every cluster", HPA_MAPS);
+
+	RLPathHierarchy_Destroy(hierarchy);
+	RLMapGrid_Destroy(map);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Main
+///////////////////////////////////////////////////////////////////////////////
+
+int main(void)
+{
+	for (int i = 0; i < HPA_MAPS; ++i) {
+		const int w = 20 + TestMaps_Range(&seed, 80);
+		const int h = 20 + TestMaps_Range(&seed, 80);
+		const int cluster_size = RLHPA_MIN_CLUSTER + TestMaps_Range(&seed,
+			20);
+		RLMapGrid *map = RLMapGrid_Create(w, h);
+		RLPathHierarchy *hierarchy = NULL;
+		int *costs = g_new(int, (gsize)w * (gsize)h);
+		RLPathPoint *path = g_new(RLPathPoint, (gsize)w * (gsize)h * 2);
+
+		switch (i % 3) {
+		case 0:
+			TestMaps_Noise(map, 25, &seed);
+			break;
+		case 1:
+			TestMaps_Cave(map, 35 + TestMaps_Range(&seed, 15), &seed);
+			break;
+		default:
+			TestMaps_Rooms(map, &seed);
+			break;
+		}
+		hierarchy = RLPathHierarchy_Create(map, cluster_size);
+
+		for (int query = 0; query < HPA_QUERIES; ++query) {
+			for (int edit = TestMaps_Range(&seed, 4); edit > 0; --edit) {
+				Test_Edit(map, hierarchy);
+			}
+			Test_Query(map, hierarchy, cluster_size, costs, path, i);
+		}
+
+		g_free(path);
+		g_free(costs);
+		RLPathHierarchy_Destroy(hierarchy);
+		RLMapGrid_Destroy(map);
+	}
+	Test_Room();
+
+	printf("test_hpa: %s\n", failures ? "FAILED" : "ok");
+	return failures != 0;
+}
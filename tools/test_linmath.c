@@ -0,0 +1,241 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	test_linmath.c
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Checks the linmath kernels against their scalar references
+///
+/// Products, transposes and batch transforms must match the references
+/// bit for bit, up to the sign of zero. Inverses use a different expansion
+/// and must agree to within float rounding. `make test` builds this with
+/// the default extensions, with -march=native and with LINMATH_NO_SIMD.
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <math.h>
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "linmath_ref.h"
+#include "testmaps.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+#define LINMATH_TRIALS 10000
+
+// Longest batch checked, past two AVX iterations so every tail is covered
+#define LINMATH_MAX_BATCH 67
+
+// Value the batch outputs are filled with, to catch writes past n
+#define LINMATH_SENTINEL 12345.0f
+
+// Error of an inverse relative to its largest entry
+#define LINMATH_TOLERANCE 1e-5f
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static variables
+///////////////////////////////////////////////////////////////////////////////
+
+static uint32_t seed = 1;
+static int failures = 0;
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+static float Test_Float(void)
+{
+	// [-4, 4) in steps of 1/8192
+	return (float)TestMaps_Range(&seed, 1 << 16) / 8192.0f - 4.0f;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Test_Matrix(mat4x4 M)
+{
+	for (int i = 0; i < 4; ++i) {
+		for (int j = 0; j < 4; ++j) {
+			M[i][j] = Test_Float();
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Test_Expect(bool ok, const char *what, int trial)
+{
+	if (!ok && failures++ < 10) {
+		printf("  %s differs from the reference in trial %d\n", what, trial);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static bool Test_Equal(const float *a, const float *b, int n)
+{
+	for (int i = 0; i < n; ++i) {
+		if (a[i] != b[i]) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Test_Products(void)
+{
+	mat4x4 a, b, expected, got;
+	vec4 v, r, s;
+
+	for (int trial = 0; trial < LINMATH_TRIALS; ++trial) {
+		Test_Matrix(a);
+		Test_Matrix(b);
+		for (int i = 0; i < 4; ++i) {
+			v[i] = Test_Float();
+		}
+
+		Ref_Mul(expected, a, b);
+		mat4x4_mul(got, a, b);
+		Test_Expect(Test_Equal(*expected, *got, 16), "mat4x4_mul", trial);
+
+		// The product may be written over either factor
+		mat4x4_dup(got, a);
+		mat4x4_mul(got, got, b);
+		Test_Expect(Test_Equal(*expected, *got, 16), "mat4x4_mul in place",
+			trial);
+		mat4x4_dup(got, b);
+		mat4x4_mul(got, a, got);
+		Test_Expect(Test_Equal(*expected, *got, 16), "mat4x4_mul in place",
+			trial);
+
+		Ref_MulVec4(r, a, v);
+		mat4x4_mul_vec4(s, a, v);
+		Test_Expect(Test_Equal(r, s, 4), "mat4x4_mul_vec4", trial);
+
+		Ref_Transpose(expected, a);
+		mat4x4_transpose(got, a);
+		Test_Expect(Test_Equal(*expected, *got, 16), "mat4x4_transpose",
+			trial);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Test_Inverse(void)
+{
+	mat4x4 M, expected, got;
+
+	for (int trial = 0; trial < LINMATH_TRIALS; ++trial) {
+		float largest = 0.0f, error = 0.0f;
+
+		// A heavy diagonal keeps the matrices well conditioned
+		Test_Matrix(M);
+		for (int i = 0; i < 4; ++i) {
+			M[i][i] += 16.0f;
+		}
+
+		Ref_Invert(expected, M);
+		mat4x4_invert(got, M);
+		for (int i = 0; i < 4; ++i) {
+			for (int j = 0; j < 4; ++j) {
+				largest = fmaxf(largest, fabsf(expected[i][j]));
+				error = fmaxf(error, fabsf(expected[i][j] - got[i][j]));
+			}
+		}
+		Test_Expect(error <= LINMATH_TOLERANCE * largest, "mat4x4_invert",
+			trial);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Test_Batches(void)
+{
+	mat4x4 M;
+	float x[LINMATH_MAX_BATCH], y[LINMATH_MAX_BATCH], z[LINMATH_MAX_BATCH];
+	float rx[3][LINMATH_MAX_BATCH + 1], ry[3][LINMATH_MAX_BATCH + 1];
+	float rz[3][LINMATH_MAX_BATCH + 1];
+
+	for (int n = 0; n <= LINMATH_MAX_BATCH; ++n) {
+		const float sx = Test_Float(), sy = Test_Float();
+		const float tx = Test_Float(), ty = Test_Float();
+
+		Test_Matrix(M);
+		for (int i = 0; i < n; ++i) {
+			x[i] = Test_Float();
+			y[i] = Test_Float();
+			z[i] = Test_Float();
+		}
+
+		// Row 0 is the reference, 1 a separate output, 2 the input itself
+		for (int k = 0; k < 3; ++k) {
+			for (int i = 0; i <= n; ++i) {
+				rx[k][i] = k == 2 && i < n ? x[i] : LINMATH_SENTINEL;
+				ry[k][i] = k == 2 && i < n ? y[i] : LINMATH_SENTINEL;
+				rz[k][i] = k == 2 && i < n ? z[i] : LINMATH_SENTINEL;
+			}
+		}
+		Ref_MulVec3Batch(rx[0], ry[0], rz[0], M, x, y, z, n);
+		mat4x4_mul_vec3_batch(rx[1], ry[1], rz[1], M, x, y, z, n);
+		mat4x4_mul_vec3_batch(rx[2], ry[2], rz[2], M, rx[2], ry[2], rz[2],
+			n);
+		for (int k = 1; k < 3; ++k) {
+			Test_Expect(
+				Test_Equal(rx[0], rx[k], n + 1) &&
+				Test_Equal(ry[0], ry[k], n + 1) &&
+				Test_Equal(rz[0], rz[k], n + 1),
+				"mat4x4_mul_vec3_batch",
+				n
+				);
+		}
+
+		for (int i = 0; i <= n; ++i) {
+			rx[1][i] = ry[1][i] = LINMATH_SENTINEL;
+			rx[2][i] = i < n ? x[i] : LINMATH_SENTINEL;
+			ry[2][i] = i < n ? y[i] : LINMATH_SENTINEL;
+		}
+		Ref_MulVec2Batch(rx[0], ry[0], M, x, y, n);
+		mat4x4_mul_vec2_batch(rx[1], ry[1], M, x, y, n);
+		mat4x4_mul_vec2_batch(rx[2], ry[2], M, rx[2], ry[2], n);
+		for (int k = 1; k < 3; ++k) {
+			Test_Expect(
+				Test_Equal(rx[0], rx[k], n + 1) &&
+				Test_Equal(ry[0], ry[k], n + 1),
+				"mat4x4_mul_vec2_batch",
+				n
+				);
+		}
+
+		for (int i = 0; i <= n; ++i) {
+			rx[1][i] = ry[1][i] = LINMATH_SENTINEL;
+			rx[2][i] = i < n ? x[i] : LINMATH_SENTINEL;
+			ry[2][i] = i < n ? y[i] : LINMATH_SENTINEL;
+		}
+		Ref_ScaleTranslateBatch(rx[0], ry[0], x, y, n, sx, sy, tx, ty);
+		vec2_scale_translate_batch(rx[1], ry[1], x, y, n, sx, sy, tx, ty);
+		vec2_scale_translate_batch(rx[2], ry[2], rx[2], ry[2], n, sx, sy, tx,
+			ty);
+		for (int k = 1; k < 3; ++k) {
+			Test_Expect(
+				Test_Equal(rx[0], rx[k], n + 1) &&
+				Test_Equal(ry[0], ry[k], n + 1),
+				"vec2_scale_translate_batch",
+				n
+				);
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Main
+///////////////////////////////////////////////////////////////////////////////
+
+int main(void)
+{
+	Test_Products();
+	Test_Inverse();
+	Test_Batches();
+
+	printf("test_linmath (%s): %s\n", REF_KERNELS, failures ? "FAILED" : "ok");
+	return failures != 0;
+}
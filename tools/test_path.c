@@ -0,0 +1,181 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	test_path.c
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Checks RLPathFinder against a reference Dijkstra
+///
+/// Both search modes must find a path exactly when the reference does, of
+/// the same cost, made of legal steps ending at the goal. The map is edited
+/// between queries to exercise the reuse of the node arrays.
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <glib.h>
+
+#include "path.h"
+#include "testmaps.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+#define PATH_MAPS 60
+#define PATH_STARTS 10
+#define PATH_GOALS 10
+#define PATH_MAX_POINTS 4096
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static variables
+///////////////////////////////////////////////////////////////////////////////
+
+static uint32_t seed = 1;
+static int failures = 0;
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+static void Test_Expect(bool ok, const char *what, RLPathMode mode, int map)
+{
+	if (!ok && failures++ < 10) {
+		printf("  %s with %s on map %d\n", what,
+			mode == RLPATH_JPS ? "JPS" : "A*", map);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static int Test_Walk(const RLMapGrid *map, int x, int y,
+	const RLPathPoint *path, int n)
+{
+	int cost = 0;
+
+	// Returns -1 on the first step an RLPathFinder may not take
+	for (int i = 0; i < n; ++i) {
+		const int dx = path[i].x - x, dy = path[i].y - y;
+
+		if (abs(dx) > 1 || abs(dy) > 1 || (!dx && !dy) ||
+			!RLMapGrid_GetBit(map, RLMAP_WALKABLE, path[i].x, path[i].y) ||
+			(dx && dy && (
+			!RLMapGrid_GetBit(map, RLMAP_WALKABLE, x + dx, y) ||
+			!RLMapGrid_GetBit(map, RLMAP_WALKABLE, x, y + dy)))) {
+			return -1;
+		}
+		cost += dx && dy ? RLPATH_COST_DIAGONAL : RLPATH_COST_STRAIGHT;
+		x = path[i].x;
+		y = path[i].y;
+	}
+
+	return cost;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Test_Query(RLPathFinder *finder, const RLMapGrid *map,
+	const int *costs, int sx, int sy, int gx, int gy, int index)
+{
+	static RLPathPoint path[PATH_MAX_POINTS];
+	// A goal in a wall is unreachable, even from itself
+	const int expected = RLMapGrid_GetBit(map, RLMAP_WALKABLE, gx, gy) ?
+		costs[gy * map->size.width + gx] : -1;
+
+	for (int mode = RLPATH_ASTAR; mode <= RLPATH_JPS; ++mode) {
+		const int n = RLPathFinder_Find(finder, (RLPathMode)mode, sx, sy, gx,
+			gy, path, PATH_MAX_POINTS);
+		RLPathPoint first;
+
+		if (expected < 0) {
+			Test_Expect(n == -1 && RLPathFinder_GetCost(finder) == -1,
+				"Found a path the reference does not", (RLPathMode)mode,
+				index);
+			continue;
+		}
+
+		Test_Expect(n >= 0 && RLPathFinder_GetCost(finder) == expected,
+			"Path cost differs from the reference", (RLPathMode)mode, index);
+		if (n < 0) {
+			continue;
+		}
+		Test_Expect(Test_Walk(map, sx, sy, path, n) == expected &&
+			(!n || (path[n - 1].x == gx && path[n - 1].y == gy)),
+			"Path is not a walk of its cost to the goal", (RLPathMode)mode,
+			index);
+
+		// A single point is the first step of the same path
+		Test_Expect(RLPathFinder_Find(finder, (RLPathMode)mode, sx, sy, gx,
+			gy, &first, 1) == n && (!n || (first.x == path[0].x &&
+			first.y == path[0].y)), "Truncated path differs",
+			(RLPathMode)mode, index);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Main
+///////////////////////////////////////////////////////////////////////////////
+
+int main(void)
+{
+	for (int i = 0; i < PATH_MAPS; ++i) {
+		const int w = 20 + TestMaps_Range(&seed, 40);
+		const int h = 20 + TestMaps_Range(&seed, 40);
+		RLMapGrid *map = RLMapGrid_Create(w, h);
+		RLPathFinder *finder = RLPathFinder_Create(map);
+		int *costs = g_new(int, (gsize)w * (gsize)h);
+
+		switch (i % 3) {
+		case 0:
+			TestMaps_Noise(map, 25, &seed);
+			break;
+		case 1:
+			TestMaps_Cave(map, 35 + TestMaps_Range(&seed, 15), &seed);
+			break;
+		default:
+			TestMaps_Rooms(map, &seed);
+			break;
+		}
+
+		for (int start = 0; start < PATH_STARTS; ++start) {
+			int sx, sy;
+
+			for (int edit = 0; edit < 5; ++edit) {
+				RLMapGrid_SetBit(map, RLMAP_WALKABLE,
+					TestMaps_Range(&seed, w), TestMaps_Range(&seed, h),
+					TestMaps_Range(&seed, 2));
+			}
+
+			// Half the starts are walls, which a path may leave
+			if (start % 2) {
+				sx = TestMaps_Range(&seed, w);
+				sy = TestMaps_Range(&seed, h);
+			}
+			else if (!TestMaps_Open(map, &seed, &sx, &sy)) {
+				continue;
+			}
+
+			TestMaps_Distances(map, sx, sy, costs);
+			for (int goal = 0; goal < PATH_GOALS; ++goal) {
+				int gx = sx, gy = sy;
+
+				// Goals are open cells, any cell, or the start itself
+				if (goal % 3 == 0) {
+					TestMaps_Open(map, &seed, &gx, &gy);
+				}
+				else if (goal % 3 == 1) {
+					gx = TestMaps_Range(&seed, w);
+					gy = TestMaps_Range(&seed, h);
+				}
+				Test_Query(finder, map, costs, sx, sy, gx, gy, i);
+			}
+		}
+
+		g_free(costs);
+		RLPathFinder_Destroy(finder);
+		RLMapGrid_Destroy(map);
+	}
+
+	printf("test_path: %s\n", failures ? "FAILED" : "ok");
+	return failures != 0;
+}
@@ -0,0 +1,194 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	test_regions.c
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Checks RLRegions labels against a flood fill as cells change
+///
+/// Labels may be any numbers, so the check is that they split the walkable
+/// cells into the same parts a flood fill along rows and columns does.
+/// Some edits are not reported, which must relabel the whole map.
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <glib.h>
+
+#include "regions.h"
+#include "testmaps.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+#define REGIONS_MAPS 100
+#define REGIONS_EDITS 300
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static variables
+///////////////////////////////////////////////////////////////////////////////
+
+static uint32_t seed = 1;
+static int failures = 0;
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+static void Test_Expect(bool ok, const char *what, int map, int edit)
+{
+	if (!ok && failures++ < 10) {
+		printf("  %s on map %d after edit %d\n", what, map, edit);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Test_Flood(const RLMapGrid *map, int *parts, int *queue)
+{
+	static const int steps[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+	const int w = map->size.width, cells = w * map->size.height;
+	int num_parts = 0;
+
+	for (int i = 0; i < cells; ++i) {
+		parts[i] = 0;
+	}
+	for (int i = 0; i < cells; ++i) {
+		int head = 0, tail = 0;
+
+		if (parts[i] || !RLMapGrid_GetBit(map, RLMAP_WALKABLE, i % w,
+			i / w)) {
+			continue;
+		}
+		parts[i] = ++num_parts;
+		queue[tail++] = i;
+		while (head < tail) {
+			const int cell = queue[head++];
+
+			for (int k = 0; k < 4; ++k) {
+				const int nx = cell % w + steps[k][0];
+				const int ny = cell / w + steps[k][1];
+
+				if (RLMapGrid_GetBit(map, RLMAP_WALKABLE, nx, ny) &&
+					!parts[ny * w + nx]) {
+					parts[ny * w + nx] = num_parts;
+					queue[tail++] = ny * w + nx;
+				}
+			}
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static int Test_Compare(const void *a, const void *b)
+{
+	return (*(const int *)a > *(const int *)b) -
+		(*(const int *)a < *(const int *)b);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static bool Test_SamePartition(RLRegions *regions, const RLMapGrid *map,
+	const int *parts, int *labels)
+{
+	const int w = map->size.width, cells = w * map->size.height;
+	int num_parts = 0;
+
+	// Every cell of a part must share the label of the part's first cell
+	for (int i = 0; i < cells; ++i) {
+		labels[i] = 0;
+	}
+	for (int i = 0; i < cells; ++i) {
+		const int label = RLRegions_GetRegion(regions, i % w, i / w);
+
+		if (!parts[i] || !label) {
+			if (parts[i] || label) {
+				return false;
+			}
+			continue;
+		}
+		if (!labels[parts[i] - 1]) {
+			labels[parts[i] - 1] = label;
+			num_parts = MAX(num_parts, parts[i]);
+		}
+		else if (labels[parts[i] - 1] != label) {
+			return false;
+		}
+	}
+
+	// and no two parts may share a label
+	qsort(labels, (size_t)num_parts, sizeof(int), Test_Compare);
+	for (int i = 1; i < num_parts; ++i) {
+		if (labels[i] == labels[i - 1]) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Main
+///////////////////////////////////////////////////////////////////////////////
+
+int main(void)
+{
+	for (int i = 0; i < REGIONS_MAPS; ++i) {
+		const int w = 5 + TestMaps_Range(&seed, 120);
+		const int h = 5 + TestMaps_Range(&seed, 80);
+		RLMapGrid *map = RLMapGrid_Create(w, h);
+		RLRegions *regions = NULL;
+		int *parts = g_new(int, (gsize)w * (gsize)h);
+		int *queue = g_new(int, (gsize)w * (gsize)h);
+		int *labels = g_new(int, (gsize)w * (gsize)h);
+
+		if (i % 2) {
+			TestMaps_Cave(map, 35 + TestMaps_Range(&seed, 20), &seed);
+		}
+		else {
+			TestMaps_Noise(map, 30 + TestMaps_Range(&seed, 30), &seed);
+		}
+		regions = RLRegions_Create(map);
+		Test_Flood(map, parts, queue);
+		Test_Expect(Test_SamePartition(regions, map, parts, labels),
+			"Labels differ from a flood fill", i, 0);
+
+		for (int edit = 1; edit <= REGIONS_EDITS; ++edit) {
+			const int x = TestMaps_Range(&seed, w);
+			const int y = TestMaps_Range(&seed, h);
+
+			RLMapGrid_SetBit(map, RLMAP_WALKABLE, x, y,
+				!RLMapGrid_GetBit(map, RLMAP_WALKABLE, x, y));
+
+			// Now and then another cell changes without being reported
+			if (TestMaps_Range(&seed, 50) == 0) {
+				const int ux = TestMaps_Range(&seed, w);
+				const int uy = TestMaps_Range(&seed, h);
+
+				RLMapGrid_SetBit(map, RLMAP_WALKABLE, ux, uy,
+					!RLMapGrid_GetBit(map, RLMAP_WALKABLE, ux, uy));
+			}
+			RLRegions_Update(regions, x, y);
+
+			if (edit < 20 || edit % 7 == 0) {
+				Test_Flood(map, parts, queue);
+				Test_Expect(
+					Test_SamePartition(regions, map, parts, labels),
+					"Labels differ from a flood fill",
+					i,
+					edit
+					);
+			}
+		}
+
+		g_free(labels);
+		g_free(queue);
+		g_free(parts);
+		RLRegions_Destroy(regions);
+		RLMapGrid_Destroy(map);
+	}
+
+	printf("test_regions: %s\n", failures ? "FAILED" : "ok");
+	return failures != 0;
+}
@@ -0,0 +1,209 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	test_tile.c
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Checks the bulk tile operations against a plain per-byte
+///			reference
+///
+/// Every count from 0 to TILE_MAX_COUNT is run, so the vector loop and its
+/// scalar tail both see odd counts, with the FG, BG and both planes and
+/// weights of 0, 255 and random. Guard tiles after the array must be left
+/// alone. RLTile_BlendRect is run on rectangles clipped on every side.
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <string.h>
+
+#include "tile.h"
+#include "testmaps.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+#define TILE_MAX_COUNT 67
+#define TILE_GUARD 5
+#define TILE_ROUNDS 20
+
+#define TILE_GRID_W 13
+#define TILE_GRID_H 9
+#define TILE_RECTS 2000
+
+// Room for the longest array with its guard, and for the grid
+#define TILE_SLOTS (TILE_GRID_W * TILE_GRID_H)
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static variables
+///////////////////////////////////////////////////////////////////////////////
+
+static const int planes_all[3] = {RLTILE_FG, RLTILE_BG, RLTILE_FG | RLTILE_BG};
+
+static RLTile tiles[TILE_SLOTS];
+static RLTile model[TILE_SLOTS];
+static int failures = 0;
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+static void Test_Expect(bool ok, const char *what, size_t count, int planes,
+	int weight)
+{
+	if (!ok && failures++ < 10) {
+		printf("  %s with %zu tiles, planes %d and weight %d\n", what, count,
+			planes, weight);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	round((c * (255 - w) + t * w) / 255), one byte at a time
+///////////////////////////////////////////////////////////////////////////////
+static RLColor Test_Mix(RLColor c, RLColor t, RLColor w)
+{
+	RLColor mixed = 0;
+
+	for (int shift = 0; shift < 32; shift += 8) {
+		const unsigned cb = (c >> shift) & 0xFF, tb = (t >> shift) & 0xFF;
+		const unsigned wb = (w >> shift) & 0xFF;
+		const unsigned n = cb * (255 - wb) + tb * wb;
+
+		mixed |= ((2 * n + 255) / 510) << shift;
+	}
+
+	return mixed;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Test_MixTile(RLTile *tile, int planes, RLColor t, RLColor w)
+{
+	if (planes & RLTILE_FG) {
+		tile->fg = Test_Mix(tile->fg, t, w);
+	}
+	if (planes & RLTILE_BG) {
+		tile->bg = Test_Mix(tile->bg, t, w);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static RLTile Test_RandomTile(uint32_t *seed)
+{
+	RLTile tile = RLTile_Make(
+		(int)(TestMaps_Random(seed) & 0x1FFFFF),
+		(RLTileType)TestMaps_Range(seed, 4),
+		TestMaps_Random(seed),
+		TestMaps_Random(seed)
+		);
+
+	tile.flags = TestMaps_Random(seed) & 0xFF;
+	return tile;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Test_Randomize(RLTile *array, size_t count, uint32_t *seed)
+{
+	for (size_t i = 0; i < count; ++i) {
+		array[i] = Test_RandomTile(seed);
+	}
+	memcpy(model, array, count * sizeof(RLTile));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static bool Test_Same(const RLTile *array, size_t count)
+{
+	return !memcmp(array, model, count * sizeof(RLTile));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Test_Arrays(uint32_t *seed)
+{
+	const size_t size = TILE_MAX_COUNT + TILE_GUARD;
+
+	for (size_t count = 0; count <= TILE_MAX_COUNT; ++count) {
+		for (int round = 0; round < TILE_ROUNDS; ++round) {
+			const int planes = planes_all[round % 3];
+			const int amount = round < 3 ? 0 : round < 6 ? 255 :
+				TestMaps_Range(seed, 256);
+			const RLColor tint = round < 3 ? 0xFFFFFFFF : round < 6 ? 0 :
+				TestMaps_Random(seed);
+			const RLColor target = TestMaps_Random(seed);
+			const RLTile fill = Test_RandomTile(seed);
+
+			Test_Randomize(tiles, size, seed);
+			RLTile_Fill(tiles, count, fill);
+			for (size_t i = 0; i < count; ++i) {
+				model[i] = fill;
+			}
+			Test_Expect(Test_Same(tiles, size), "RLTile_Fill differs",
+				count, 0, 0);
+
+			Test_Randomize(tiles, size, seed);
+			RLTile_Tint(tiles, count, planes, tint);
+			for (size_t i = 0; i < count; ++i) {
+				Test_MixTile(&model[i], planes, 0, ~tint);
+			}
+			Test_Expect(Test_Same(tiles, size), "RLTile_Tint differs",
+				count, planes, (int)(tint & 0xFF));
+
+			Test_Randomize(tiles, size, seed);
+			RLTile_Fade(tiles, count, planes, target, (uint8_t)amount);
+			for (size_t i = 0; i < count; ++i) {
+				Test_MixTile(&model[i], planes, target,
+					RLCOLOR(amount, amount, amount, amount));
+			}
+			Test_Expect(Test_Same(tiles, size), "RLTile_Fade differs",
+				count, planes, amount);
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void Test_Rects(uint32_t *seed)
+{
+	const size_t size = TILE_GRID_W * TILE_GRID_H;
+
+	for (int round = 0; round < TILE_RECTS; ++round) {
+		const int planes = planes_all[round % 3];
+		const int x = TestMaps_Range(seed, TILE_GRID_W + 8) - 6;
+		const int y = TestMaps_Range(seed, TILE_GRID_H + 8) - 6;
+		const int w = TestMaps_Range(seed, TILE_GRID_W + 6);
+		const int h = TestMaps_Range(seed, TILE_GRID_H + 6);
+		const int alpha = round < 300 ? 0 : round < 600 ? 255 :
+			TestMaps_Range(seed, 256);
+		const RLColor color = (TestMaps_Random(seed) & 0xFFFFFF) |
+			RLCOLOR(0, 0, 0, alpha);
+
+		Test_Randomize(tiles, size, seed);
+		RLTile_BlendRect(tiles, TILE_GRID_W, TILE_GRID_H, x, y, w, h, planes,
+			color);
+		for (int row = 0; row < TILE_GRID_H; ++row) {
+			for (int col = 0; col < TILE_GRID_W; ++col) {
+				if (col >= x && col < x + w && row >= y && row < y + h) {
+					Test_MixTile(&model[row * TILE_GRID_W + col], planes,
+						color | RLCOLOR(0, 0, 0, 255),
+						RLCOLOR(alpha, alpha, alpha, alpha));
+				}
+			}
+		}
+		Test_Expect(Test_Same(tiles, size), "RLTile_BlendRect differs",
+			(size_t)(w * h), planes, alpha);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Main
+///////////////////////////////////////////////////////////////////////////////
+
+int main(void)
+{
+	uint32_t seed = 5;
+
+	Test_Arrays(&seed);
+	Test_Rects(&seed);
+
+	printf("test_tile: %s\n", failures ? "FAILED" : "ok");
+	return failures != 0;
+}
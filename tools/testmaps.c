@@ -0,0 +1,279 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	testmaps.c
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Seeded dungeon generators and a clock shared by the tests and
+///			benchmarks
+///////////////////////////////////////////////////////////////////////////////
+
+#include "testmaps.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <glib.h>
+
+#include "path.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Defines
+///////////////////////////////////////////////////////////////////////////////
+
+#define TESTMAPS_SMOOTHING 4
+
+// Walls among a cell and its 8 neighbours that make it a wall
+#define TESTMAPS_CROWD 5
+
+// Map cells per room
+#define TESTMAPS_ROOM_AREA 400
+
+// Random cells tried before TestMaps_Open scans for one
+#define TESTMAPS_PICKS 1000
+
+///////////////////////////////////////////////////////////////////////////////
+/// Structs
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// Binary min-heap of TestMaps_Distances entries
+///////////////////////////////////////////////////////////////////////////////
+typedef struct {
+	int64_t *items;
+	int len;
+	int max;
+} TestMapsHeap;
+
+///////////////////////////////////////////////////////////////////////////////
+/// Static functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+static void TestMaps_Set(RLMapGrid *map, int x, int y, bool open)
+{
+	RLMapGrid_SetBit(map, RLMAP_WALKABLE, x, y, open);
+	RLMapGrid_SetBit(map, RLMAP_TRANSPARENT, x, y, open);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void TestMaps_Fill(RLMapGrid *map, int x, int y, int w, int h,
+	bool open)
+{
+	RLMapGrid_FillBits(map, RLMAP_WALKABLE, x, y, w, h, open);
+	RLMapGrid_FillBits(map, RLMAP_TRANSPARENT, x, y, w, h, open);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void TestMaps_Push(TestMapsHeap *heap, int64_t entry)
+{
+	int i = heap->len++;
+
+	if (heap->len > heap->max) {
+		heap->max = MAX(2 * heap->max, 64);
+		heap->items = g_renew(int64_t, heap->items, (gsize)heap->max);
+	}
+	while (i && heap->items[(i - 1) / 2] > entry) {
+		heap->items[i] = heap->items[(i - 1) / 2];
+		i = (i - 1) / 2;
+	}
+	heap->items[i] = entry;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static int64_t TestMaps_Pop(TestMapsHeap *heap)
+{
+	const int64_t top = heap->items[0], last = heap->items[--heap->len];
+	int i = 0;
+
+	for (int child = 1; child < heap->len; child = 2 * i + 1) {
+		if (child + 1 < heap->len &&
+			heap->items[child + 1] < heap->items[child]) {
+			++child;
+		}
+		if (heap->items[child] >= last) {
+			break;
+		}
+		heap->items[i] = heap->items[child];
+		i = child;
+	}
+	heap->items[i] = last;
+
+	return top;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Public functions
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+uint32_t TestMaps_Random(uint32_t *seed)
+{
+	*seed ^= *seed << 13;
+	*seed ^= *seed >> 17;
+	*seed ^= *seed << 5;
+
+	return *seed;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int TestMaps_Range(uint32_t *seed, int n)
+{
+	return (int)(TestMaps_Random(seed) % (uint32_t)n);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void TestMaps_Noise(RLMapGrid *map, int percent, uint32_t *seed)
+{
+	for (int y = 0; y < map->size.height; ++y) {
+		for (int x = 0; x < map->size.width; ++x) {
+			TestMaps_Set(map, x, y, TestMaps_Range(seed, 100) >= percent);
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void TestMaps_Cave(RLMapGrid *map, int percent, uint32_t *seed)
+{
+	const int w = map->size.width, h = map->size.height;
+	bool *walls = g_new(bool, (gsize)w * (gsize)h);
+	bool *next = g_new(bool, (gsize)w * (gsize)h);
+
+	for (int i = 0; i < w * h; ++i) {
+		walls[i] = TestMaps_Range(seed, 100) < percent;
+	}
+
+	// Cells off the map count as walls, closing the caves at the edges
+	for (int pass = 0; pass < TESTMAPS_SMOOTHING; ++pass) {
+		bool *swap = walls;
+
+		for (int y = 0; y < h; ++y) {
+			for (int x = 0; x < w; ++x) {
+				int count = 0;
+
+				for (int dy = -1; dy <= 1; ++dy) {
+					for (int dx = -1; dx <= 1; ++dx) {
+						const int nx = x + dx, ny = y + dy;
+						count += nx < 0 || ny < 0 || nx >= w || ny >= h ||
+							walls[ny * w + nx];
+					}
+				}
+				next[y * w + x] = count >= TESTMAPS_CROWD;
+			}
+		}
+		walls = next;
+		next = swap;
+	}
+
+	for (int y = 0; y < h; ++y) {
+		for (int x = 0; x < w; ++x) {
+			TestMaps_Set(map, x, y, !walls[y * w + x]);
+		}
+	}
+
+	g_free(walls);
+	g_free(next);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void TestMaps_Rooms(RLMapGrid *map, uint32_t *seed)
+{
+	const int w = map->size.width, h = map->size.height;
+	const int rooms = MAX(2, w * h / TESTMAPS_ROOM_AREA);
+	int px = w / 2, py = h / 2;
+
+	TestMaps_Fill(map, 0, 0, w, h, false);
+	for (int i = 0; i < rooms; ++i) {
+		const int rw = 4 + TestMaps_Range(seed, 12);
+		const int rh = 4 + TestMaps_Range(seed, 10);
+		const int rx = 1 + TestMaps_Range(seed, w - rw - 1);
+		const int ry = 1 + TestMaps_Range(seed, h - rh - 1);
+		const int cx = rx + rw / 2, cy = ry + rh / 2;
+
+		// Each room is joined to the last by a corridor bent once
+		TestMaps_Fill(map, rx, ry, rw, rh, true);
+		TestMaps_Fill(map, MIN(px, cx), py, abs(px - cx) + 1, 1, true);
+		TestMaps_Fill(map, cx, MIN(py, cy), 1, abs(py - cy) + 1, true);
+		px = cx;
+		py = cy;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool TestMaps_Open(const RLMapGrid *map, uint32_t *seed, int *x, int *y)
+{
+	const int w = map->size.width, h = map->size.height;
+
+	for (int i = 0; i < TESTMAPS_PICKS; ++i) {
+		*x = TestMaps_Range(seed, w);
+		*y = TestMaps_Range(seed, h);
+		if (RLMapGrid_GetBit(map, RLMAP_WALKABLE, *x, *y)) {
+			return true;
+		}
+	}
+
+	// Nearly closed maps fall back to the first open cell
+	for (int cell = 0; cell < w * h; ++cell) {
+		if (RLMapGrid_GetBit(map, RLMAP_WALKABLE, cell % w, cell / w)) {
+			*x = cell % w;
+			*y = cell / w;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void TestMaps_Distances(const RLMapGrid *map, int x, int y, int *costs)
+{
+	const int w = map->size.width, h = map->size.height;
+	TestMapsHeap heap = {NULL, 0, 0};
+
+	for (int i = 0; i < w * h; ++i) {
+		costs[i] = -1;
+	}
+	if (!RLMapGrid_InBounds(map, x, y)) {
+		return;
+	}
+
+	// Entries are the cost in the high half and the cell in the low half,
+	// stale ones are skipped when popped
+	costs[y * w + x] = 0;
+	TestMaps_Push(&heap, y * w + x);
+	while (heap.len) {
+		const int64_t entry = TestMaps_Pop(&heap);
+		const int cell = (int)(entry & 0xffffffff), cost = (int)(entry >> 32);
+		const int cx = cell % w, cy = cell / w;
+
+		if (cost > costs[cell]) {
+			continue;
+		}
+		for (int dy = -1; dy <= 1; ++dy) {
+			for (int dx = -1; dx <= 1; ++dx) {
+				const int nx = cx + dx, ny = cy + dy;
+				const int next = cost + (dx && dy ? RLPATH_COST_DIAGONAL :
+					RLPATH_COST_STRAIGHT);
+
+				if ((!dx && !dy) ||
+					!RLMapGrid_GetBit(map, RLMAP_WALKABLE, nx, ny) ||
+					(dx && dy && (
+					!RLMapGrid_GetBit(map, RLMAP_WALKABLE, cx + dx, cy) ||
+					!RLMapGrid_GetBit(map, RLMAP_WALKABLE, cx, cy + dy)))) {
+					continue;
+				}
+				if (costs[ny * w + nx] < 0 || next < costs[ny * w + nx]) {
+					costs[ny * w + nx] = next;
+					TestMaps_Push(&heap, (int64_t)next << 32 | (ny * w + nx));
+				}
+			}
+		}
+	}
+
+	g_free(heap.items);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+double TestMaps_Seconds(void)
+{
+	return (double)g_get_monotonic_time() / 1e6;
+}
@@ -0,0 +1,103 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file	testmaps.h
+/// \author	Jacob Adkins (jpadkins)
+/// \brief	Seeded dungeon generators and a clock shared by the tests and
+///			benchmarks
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TESTMAPS_H
+#define TESTMAPS_H
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "mapgrid.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Advances a xorshift generator
+///
+/// \param	seed	State of the generator, never 0
+///
+/// \return	Next value of the generator
+///////////////////////////////////////////////////////////////////////////////
+uint32_t TestMaps_Random(uint32_t *seed);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns a random integer in [0, n)
+///
+/// \param	seed	State of the generator
+/// \param	n		Number of values, at least 1
+///
+/// \return	Random integer
+///////////////////////////////////////////////////////////////////////////////
+int TestMaps_Range(uint32_t *seed, int n);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Fills a map with scattered walls
+///
+/// Cells are walkable and transparent together, as in every generator here.
+///
+/// \param	map		Map to fill
+/// \param	percent	Chance in percent of a cell being a wall
+/// \param	seed	State of the generator
+///////////////////////////////////////////////////////////////////////////////
+void TestMaps_Noise(RLMapGrid *map, int percent, uint32_t *seed);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Fills a map with caves smoothed from noise by a cellular automaton
+///
+/// \param	map		Map to fill
+/// \param	percent	Chance in percent of a cell starting as a wall, around 45
+///					gives open caves
+/// \param	seed	State of the generator
+///////////////////////////////////////////////////////////////////////////////
+void TestMaps_Cave(RLMapGrid *map, int percent, uint32_t *seed);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Fills a map with rectangular rooms joined in a chain by corridors
+///
+/// \param	map		Map to fill, at least 20 cells a side
+/// \param	seed	State of the generator
+///////////////////////////////////////////////////////////////////////////////
+void TestMaps_Rooms(RLMapGrid *map, uint32_t *seed);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Picks a random walkable cell
+///
+/// \param	map		Map to pick from
+/// \param	seed	State of the generator
+/// \param	x		Destination of the column
+/// \param	y		Destination of the row
+///
+/// \return	false if the map has no walkable cell
+///////////////////////////////////////////////////////////////////////////////
+bool TestMaps_Open(const RLMapGrid *map, uint32_t *seed, int *x, int *y);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Computes the cost of a shortest path to every cell from a start
+///
+/// A plain Dijkstra over the moves RLPathFinder allows, to check the path
+/// and flow field code against. Diagonal moves need both cells they pass
+/// between to be walkable, the start cell need not be.
+///
+/// \param	map		Map whose RLMAP_WALKABLE plane gives the passable cells
+/// \param	x		Column of the start
+/// \param	y		Row of the start
+/// \param	costs	Destination for a cost per cell in row-major order, in
+///					RLPATH_COST_STRAIGHT and RLPATH_COST_DIAGONAL units, -1
+///					where unreachable
+///////////////////////////////////////////////////////////////////////////////
+void TestMaps_Distances(const RLMapGrid *map, int x, int y, int *costs);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief	Returns a monotonic time in seconds
+///
+/// \return	Seconds since an arbitrary point
+///////////////////////////////////////////////////////////////////////////////
+double TestMaps_Seconds(void);
+
+#endif